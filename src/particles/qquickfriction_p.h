@@ -65,6 +65,7 @@ public:
 
 protected:
     virtual bool affectParticle(QQuickParticleData *d, qreal dt);
+    virtual void affectParticles(QQuickParticleAffectorBatch *batch, qreal now);
 
 Q_SIGNALS:
 
@@ -64,6 +64,7 @@ public:
     }
 protected:
     virtual bool affectParticle(QQuickParticleData *d, qreal dt);
+    virtual void affectParticles(QQuickParticleAffectorBatch *batch, qreal now);
 Q_SIGNALS:
 
     void magnitudeChanged(qreal arg);
@@ -132,8 +132,9 @@ QT_BEGIN_NAMESPACE
     The corresponding handler is \c onAffected.
 */
 QQuickParticleAffector::QQuickParticleAffector(QQuickItem *parent) :
-    QQuickItem(parent), m_needsReset(false), m_ignoresTime(false), m_onceOff(false), m_enabled(true)
+    QQuickItem(parent), m_needsReset(false), m_ignoresTime(false), m_batched(false), m_onceOff(false), m_enabled(true)
     , m_system(0), m_updateIntSet(false), m_shape(new QQuickParticleExtruder(this))
+    , m_batchDt(0), m_batchTime(0)
 {
 }
 
@@ -150,14 +151,26 @@ void QQuickParticleAffector::componentComplete()
     QQuickItem::componentComplete();
 }
 
-bool QQuickParticleAffector::activeGroup(int g) {
+const QSet<int> &QQuickParticleAffector::groupIds()
+{
     if (m_updateIntSet){ //This can occur before group ids are properly assigned, but that resets the flag
         m_groupIds.clear();
         foreach (const QString &p, m_groups)
             m_groupIds << m_system->groupIds[p];
         m_updateIntSet = false;
     }
-    return m_groupIds.isEmpty() || m_groupIds.contains(g);
+    return m_groupIds;
+}
+
+bool QQuickParticleAffector::activeGroup(int g) {
+    const QSet<int> &ids = groupIds();
+    return ids.isEmpty() || ids.contains(g);
+}
+
+bool QQuickParticleAffector::canAffectConcurrently() const
+{
+    //Colliding reads particles of other groups, which may be written concurrently
+    return m_enabled && m_batched && m_whenCollidingWith.isEmpty();
 }
 
 bool QQuickParticleAffector::shouldAffect(QQuickParticleData* d)
@@ -191,11 +204,19 @@ void QQuickParticleAffector::postAffect(QQuickParticleData* d)
 
 const qreal QQuickParticleAffector::simulationDelta = 0.020;
 const qreal QQuickParticleAffector::simulationCutoff = 1.000;//If this goes above 1.0, then m_once behaviour needs special codepath
+static const qreal epsilon = 0.001;//Same as QQuickParticleData::alive()
 
 void QQuickParticleAffector::affectSystem(qreal dt)
 {
     if (!m_enabled)
         return;
+    if (m_batched) {
+        if (prepareBatch(dt)) {
+            simulateBatch();
+            finishBatch();
+        }
+        return;
+    }
     //If not reimplemented, calls affectParticle per particle
     //But only on particles in targeted system/area
     updateOffsets();//### Needed if an ancestor is transformed.
@@ -228,11 +249,118 @@ void QQuickParticleAffector::affectSystem(qreal dt)
     }
 }
 
+bool QQuickParticleAffector::prepareBatch(qreal dt)
+{
+    //Gathers the particles to affect. Runs on the GUI thread, as shapes and groups are not thread safe
+    m_batch.clear();
+    if (!m_enabled)
+        return false;
+    updateOffsets();//### Needed if an ancestor is transformed.
+    if (m_onceOff)
+        dt = 1.0;
+    m_batchDt = dt;
+    m_batchTime = m_system->timeInt;
+    foreach (QQuickParticleGroupData* gd, m_system->groupData)
+        if (activeGroup(m_system->groupData.key(gd)))
+            foreach (QQuickParticleData* d, gd->data)
+                if (shouldAffect(d))
+                    m_batch.append(d);
+    return m_batch.count() > 0;
+}
+
+void QQuickParticleAffector::simulateBatch()
+{
+    //Same stepping as the per particle path in affectSystem, but each step runs over all particles at once.
+    //Only touches the batch and the particles in it, so it may run on a worker thread.
+    const int count = m_batch.count();
+    float *step = m_batch.step.data();
+    const float *t = m_batch.t.constData();
+    const float *lifeSpan = m_batch.lifeSpan.constData();
+
+    qreal myDt = m_batchDt;
+    if (!m_ignoresTime && myDt < simulationCutoff) {
+        int timeInt = m_batchTime;
+        timeInt -= myDt * 1000.0;
+        while (myDt > simulationDelta) {
+            timeInt += simulationDelta * 1000.0;
+            const qreal now = timeInt / 1000.0;
+            for (int i = 0; i < count; i++) //Only affect during the parts it was alive for
+                step[i] = (t[i] + epsilon < now && t[i] + lifeSpan[i] - epsilon > now) ? float(simulationDelta) : 0.0f;
+            affectParticles(&m_batch, now);
+            myDt -= simulationDelta;
+        }
+    }
+    if (myDt > 0.0) {
+        for (int i = 0; i < count; i++)
+            step[i] = myDt;
+        affectParticles(&m_batch, m_batchTime / 1000.0);
+    }
+
+    m_batch.writeBack();
+}
+
+void QQuickParticleAffector::finishBatch()
+{
+    const uchar *affected = m_batch.affected.constData();
+    for (int i = 0; i < m_batch.count(); i++)
+        if (affected[i])
+            postAffect(m_batch.data.at(i));
+}
+
 bool QQuickParticleAffector::affectParticle(QQuickParticleData *, qreal )
 {
     return true;
 }
 
+void QQuickParticleAffector::affectParticles(QQuickParticleAffectorBatch *, qreal)
+{
+    //Subclasses setting m_batched reimplement this instead of affectParticle
+}
+
+void QQuickParticleAffectorBatch::clear()
+{
+    //resize(0) keeps the capacity, so steady state frames do not allocate
+    data.resize(0);
+    x.resize(0);
+    y.resize(0);
+    vx.resize(0);
+    vy.resize(0);
+    ax.resize(0);
+    ay.resize(0);
+    t.resize(0);
+    lifeSpan.resize(0);
+    step.resize(0);
+    affected.resize(0);
+}
+
+void QQuickParticleAffectorBatch::append(QQuickParticleData *d)
+{
+    data << d;
+    x << d->x;
+    y << d->y;
+    vx << d->vx;
+    vy << d->vy;
+    ax << d->ax;
+    ay << d->ay;
+    t << d->t;
+    lifeSpan << d->lifeSpan;
+    step << 0.0f;
+    affected << false;
+}
+
+void QQuickParticleAffectorBatch::writeBack()
+{
+    for (int i = 0; i < data.count(); i++) {
+        QQuickParticleData *d = data.at(i);
+        d->x = x.at(i);
+        d->y = y.at(i);
+        d->vx = vx.at(i);
+        d->vy = vy.at(i);
+        d->ax = ax.at(i);
+        d->ay = ay.at(i);
+    }
+}
+
 void QQuickParticleAffector::reset(QQuickParticleData* pd)
 {//TODO: This, among other ones, should be restructured so they don't all need to remember to call the superclass
     if (m_onceOff)
@@ -48,6 +48,30 @@
 
 QT_BEGIN_NAMESPACE
 
+// Structure of arrays copy of the particles an affector is about to update,
+// so that batch kernels can run over contiguous floats instead of chasing
+// QQuickParticleData pointers.
+class QQuickParticleAffectorBatch
+{
+public:
+    void clear();
+    void append(QQuickParticleData *d);
+    void writeBack();
+    int count() const { return data.count(); }
+
+    QVector<QQuickParticleData*> data;
+    QVector<float> x;
+    QVector<float> y;
+    QVector<float> vx;
+    QVector<float> vy;
+    QVector<float> ax;
+    QVector<float> ay;
+    QVector<float> t;
+    QVector<float> lifeSpan;
+    QVector<float> step; //Time step of the current pass, 0 for particles not alive at that point
+    QVector<uchar> affected;
+};
+
 class QQuickParticleAffector : public QQuickItem
 {
     Q_OBJECT
@@ -164,9 +188,13 @@ public Q_SLOTS:
 
 protected:
     friend class QQuickParticleSystem;
+    friend class QQuickParticleAffectorRunnable;
     virtual bool affectParticle(QQuickParticleData *d, qreal dt);
+    //Only called if m_batched is set. now is the simulation time in seconds
+    virtual void affectParticles(QQuickParticleAffectorBatch *batch, qreal now);
     bool m_needsReset:1;//### What is this really saving?
     bool m_ignoresTime:1;
+    bool m_batched:1;
     bool m_onceOff:1;
     bool m_enabled:1;
 
@@ -191,6 +219,16 @@ private:
     QStringList m_whenCollidingWith;
 
     bool isColliding(QQuickParticleData* d);
+
+    //Batched affecting is split up so QQuickParticleSystem can run simulateBatch on a worker thread
+    const QSet<int> &groupIds();//Empty means all groups
+    bool canAffectConcurrently() const;
+    bool prepareBatch(qreal dt);
+    void simulateBatch();
+    void finishBatch();
+    QQuickParticleAffectorBatch m_batch;
+    qreal m_batchDt;
+    int m_batchTime;
 };
 
 QT_END_NAMESPACE
@@ -52,6 +52,8 @@
 #include "qquicktrailemitter_p.h"//###For auto-follow on states, perhaps should be in emitter?
 #include <private/qqmlengine_p.h>
 #include <private/qqmlglobal_p.h>
+#include <QtCore/QThreadPool>
+#include <QtCore/QSemaphore>
 #include <cmath>
 #include <QDebug>
 
@@ -59,6 +61,9 @@ QT_BEGIN_NAMESPACE
 //###Switch to define later, for now user-friendly (no compilation) debugging is worth it
 DEFINE_BOOL_CONFIG_OPTION(qmlParticlesDebug, QML_PARTICLES_DEBUG)
 
+// Below this many particles in total, handing affectors to other threads costs more than it saves.
+static const int qquick_particle_concurrent_threshold = 2000;
+
 
 /* \internal ParticleSystem internals documentation
 
@@ -223,113 +228,155 @@ int roundedTime(qreal a)
     return (int)qRound(a*1000.0);
 }
 
-QQuickParticleDataHeap::QQuickParticleDataHeap()
-    : m_data(0)
+QQuickParticleDataWheel::QQuickParticleDataWheel()
+    : m_slots(slotCount, 0), m_currentTick(0)
 {
-    m_data.reserve(1000);
-    clear();
 }
 
-void QQuickParticleDataHeap::grow() //###Consider automatic growth vs resize() calls from GroupData
+void QQuickParticleDataWheel::insert(QQuickParticleData* data)
 {
-    m_data.resize(1 << ++m_size);
+    insertTimed(data, roundedTime(data->t + data->lifeSpan));
 }
 
-void QQuickParticleDataHeap::insert(QQuickParticleData* data)
+void QQuickParticleDataWheel::insertTimed(QQuickParticleData* data, int time)
 {
-    insertTimed(data, roundedTime(data->t + data->lifeSpan));
+    //A particle is only ever in one slot, so a second insert just moves it
+    remove(data);
+
+    //Anything already due goes in the current slot, which is the next one to be looked at
+    int tick = qMax(time / slotDuration, m_currentTick);
+    int slot = tick % slotCount;
+    data->recyclerTime = time;
+    data->recyclerSlot = slot;
+    data->recyclerPrev = 0;
+    data->recyclerNext = m_slots.at(slot);
+    if (data->recyclerNext)
+        data->recyclerNext->recyclerPrev = data;
+    m_slots[slot] = data;
 }
 
-void QQuickParticleDataHeap::insertTimed(QQuickParticleData* data, int time)
+void QQuickParticleDataWheel::remove(QQuickParticleData* data)
 {
-    //TODO: Optimize 0 lifespan (or already dead) case
-    if (m_lookups.contains(time)) {
-        m_data[m_lookups[time]].data << data;
+    if (data->recyclerSlot == -1)
         return;
+    if (data->recyclerPrev)
+        data->recyclerPrev->recyclerNext = data->recyclerNext;
+    else
+        m_slots[data->recyclerSlot] = data->recyclerNext;
+    if (data->recyclerNext)
+        data->recyclerNext->recyclerPrev = data->recyclerPrev;
+    data->recyclerNext = 0;
+    data->recyclerPrev = 0;
+    data->recyclerSlot = -1;
+}
+
+QQuickParticleData* QQuickParticleDataWheel::takeExpired(int time)
+{
+    QQuickParticleData* expired = 0;
+    int lastTick = time / slotDuration;
+    int ticks = lastTick - m_currentTick + 1;
+    bool backwards = ticks <= 0;
+    if (backwards || ticks > slotCount) //Time went backwards or jumped a whole turn, look at every slot once
+        ticks = slotCount;
+    for (int i = 0; i < ticks; i++) {
+        QQuickParticleData* d = m_slots.at((lastTick - i + slotCount) % slotCount);
+        while (d) {
+            QQuickParticleData* next = d->recyclerNext;
+            if (d->recyclerTime <= time) {
+                remove(d);
+                d->recyclerNext = expired;
+                expired = d;
+            }
+            d = next;
+        }
     }
-    if (m_end == (1 << m_size))
-        grow();
-    m_data[m_end].time = time;
-    m_data[m_end].data.clear();
-    m_data[m_end].data.insert(data);
-    m_lookups.insert(time, m_end);
-    bubbleUp(m_end++);
+    //The last slot can still hold entries due later within the same tick
+    m_currentTick = lastTick;
+
+    //Entries parked in the old current slot may now be most of a turn away, so put everything back in place
+    if (backwards) {
+        QQuickParticleData* pending = 0;
+        for (int i = 0; i < slotCount; i++) {
+            while (QQuickParticleData* d = m_slots.at(i)) {
+                remove(d);
+                d->recyclerNext = pending;
+                pending = d;
+            }
+        }
+        while (pending) {
+            QQuickParticleData* next = pending->recyclerNext;
+            insertTimed(pending, pending->recyclerTime);
+            pending = next;
+        }
+    }
+    return expired;
 }
 
-int QQuickParticleDataHeap::top()
+void QQuickParticleDataWheel::clear()
 {
-    if (m_end == 0)
-        return 1 << 30;
-    return m_data[0].time;
+    for (int i = 0; i < slotCount; i++) {
+        while (m_slots.at(i))
+            remove(m_slots.at(i));
+    }
+    m_currentTick = 0;
 }
 
-QSet<QQuickParticleData*> QQuickParticleDataHeap::pop()
+bool QQuickParticleDataWheel::contains(QQuickParticleData* d)
 {
-    if (!m_end)
-        return QSet<QQuickParticleData*> ();
-    QSet<QQuickParticleData*> ret = m_data[0].data;
-    m_lookups.remove(m_data[0].time);
-    if (m_end == 1) {
-        --m_end;
-    } else {
-        m_data[0] = m_data[--m_end];
-        bubbleDown(0);
-    }
-    return ret;
+    for (int i = 0; i < slotCount; i++)
+        for (QQuickParticleData* it = m_slots.at(i); it; it = it->recyclerNext)
+            if (it == d)
+                return true;
+    return false;
 }
 
-void QQuickParticleDataHeap::clear()
+void QQuickParticleIndexSet::resize(int size)
 {
-    m_size = 0;
-    m_end = 0;
-    //m_size is in powers of two. So to start at 0 we have one allocated
-    m_data.resize(1);
-    m_lookups.clear();
+    m_bits.resize((size + 31) >> 5);
 }
 
-bool QQuickParticleDataHeap::contains(QQuickParticleData* d)
+void QQuickParticleIndexSet::insert(int idx)
 {
-    for (int i=0; i<m_end; i++)
-        if (m_data[i].data.contains(d))
-            return true;
-    return false;
+    if (idx >= m_bits.size() * 32)
+        resize(idx + 1);
+    quint32 &word = m_bits[idx >> 5];
+    quint32 bit = 1u << (idx & 31);
+    if (word & bit)
+        return;
+    word |= bit;
+    m_count++;
+    m_firstWord = qMin(m_firstWord, idx >> 5);
 }
 
-void QQuickParticleDataHeap::swap(int a, int b)
+void QQuickParticleIndexSet::remove(int idx)
 {
-    m_tmp = m_data[a];
-    m_data[a] = m_data[b];
-    m_data[b] = m_tmp;
-    m_lookups[m_data[a].time] = a;
-    m_lookups[m_data[b].time] = b;
+    if (!contains(idx))
+        return;
+    m_bits[idx >> 5] &= ~(1u << (idx & 31));
+    m_count--;
 }
 
-void QQuickParticleDataHeap::bubbleUp(int idx)//tends to be called once
+int QQuickParticleIndexSet::takeFirst()
 {
-    if (!idx)
-        return;
-    int parent = (idx-1)/2;
-    if (m_data[idx].time < m_data[parent].time) {
-        swap(idx, parent);
-        bubbleUp(parent);
-    }
+    if (!m_count)
+        return -1;
+    while (!m_bits.at(m_firstWord))
+        m_firstWord++;
+    quint32 word = m_bits.at(m_firstWord);
+    int bit = 0;
+    while (!(word & (1u << bit)))
+        bit++;
+    int idx = (m_firstWord << 5) + bit;
+    m_bits[m_firstWord] = word & ~(1u << bit);
+    m_count--;
+    return idx;
 }
 
-void QQuickParticleDataHeap::bubbleDown(int idx)//tends to be called log n times
+void QQuickParticleIndexSet::clear()
 {
-    int left = idx*2 + 1;
-    if (left >= m_end)
-        return;
-    int lesser = left;
-    int right = idx*2 + 2;
-    if (right < m_end) {
-        if (m_data[left].time > m_data[right].time)
-            lesser = right;
-    }
-    if (m_data[idx].time > m_data[lesser].time) {
-        swap(idx, lesser);
-        bubbleDown(lesser);
-    }
+    m_bits.fill(0);
+    m_count = 0;
+    m_firstWord = 0;
 }
 
 QQuickParticleGroupData::QQuickParticleGroupData(int id, QQuickParticleSystem* sys):index(id),m_size(0),m_system(sys)
@@ -363,7 +410,7 @@ void QQuickParticleGroupData::setSize(int newSize)
         data[i] = new QQuickParticleData(m_system);
         data[i]->group = index;
         data[i]->index = i;
-        reusableIndexes << i;
+        reusableIndexes.insert(i);
     }
     int delta = newSize - m_size;
     m_size = newSize;
@@ -373,7 +420,7 @@ void QQuickParticleGroupData::setSize(int newSize)
 
 void QQuickParticleGroupData::initList()
 {
-    dataHeap.clear();
+    dataWheel.clear();
 }
 
 void QQuickParticleGroupData::kill(QQuickParticleData* d)
@@ -382,16 +429,15 @@ void QQuickParticleGroupData::kill(QQuickParticleData* d)
     d->lifeSpan = 0;//Kill off
     foreach (QQuickParticlePainter* p, painters)
         p->reload(d);
-    reusableIndexes << d->index;
+    reusableIndexes.insert(d->index);
 }
 
 QQuickParticleData* QQuickParticleGroupData::newDatum(bool respectsLimits)
 {
     //recycle();//Extra recycler round to be sure?
 
-    while (!reusableIndexes.empty()) {
-        int idx = *(reusableIndexes.begin());
-        reusableIndexes.remove(idx);
+    while (!reusableIndexes.isEmpty()) {
+        int idx = reusableIndexes.takeFirst();
         if (data[idx]->stillAlive()) {// ### This means resurrection of 'dead' particles. Is that allowed?
             prepareRecycler(data[idx]);
             continue;
@@ -409,14 +455,15 @@ QQuickParticleData* QQuickParticleGroupData::newDatum(bool respectsLimits)
 
 bool QQuickParticleGroupData::recycle()
 {
-    while (dataHeap.top() <= m_system->timeInt) {
-        foreach (QQuickParticleData* datum, dataHeap.pop()) {
-            if (!datum->stillAlive()) {
-                reusableIndexes << datum->index;
-            } else {
-                prepareRecycler(datum); //ttl has been altered mid-way, put it back
-            }
+    QQuickParticleData* datum = dataWheel.takeExpired(m_system->timeInt);
+    while (datum) {
+        QQuickParticleData* next = datum->recyclerNext;
+        if (!datum->stillAlive()) {
+            reusableIndexes.insert(datum->index);
+        } else {
+            prepareRecycler(datum); //ttl has been altered mid-way, put it back
         }
+        datum = next;
     }
 
     //TODO: If the data is clear, gc (consider shrinking stack size)?
@@ -426,11 +473,11 @@ bool QQuickParticleGroupData::recycle()
 void QQuickParticleGroupData::prepareRecycler(QQuickParticleData* d)
 {
     if (d->lifeSpan*1000 < m_system->maxLife) {
-        dataHeap.insert(d);
+        dataWheel.insert(d);
     } else {
         while ((roundedTime(d->t) + 2*m_system->maxLife/3) <= m_system->timeInt)
             d->extendLife(m_system->maxLife/3000.0);
-        dataHeap.insertTimed(d, roundedTime(d->t) + 2*m_system->maxLife/3);
+        dataWheel.insertTimed(d, roundedTime(d->t) + 2*m_system->maxLife/3);
     }
 }
 
@@ -479,6 +526,10 @@ QQuickParticleData::QQuickParticleData(QQuickParticleSystem* sys)
     r = 0;
     delegate = 0;
     modelIndex = -1;
+    recyclerNext = 0;
+    recyclerPrev = 0;
+    recyclerTime = 0;
+    recyclerSlot = -1;
 }
 
 QQuickParticleData::~QQuickParticleData()
@@ -689,6 +740,7 @@ QQuickParticleSystem::QQuickParticleSystem(QQuickItem *parent) :
     m_running(true),
     initialized(0),
     particleCount(0),
+    concurrentAffectorThreshold(qquick_particle_concurrent_threshold),
     m_nextIndex(0),
     m_componentComplete(false),
     m_paused(false),
@@ -1048,11 +1100,8 @@ void QQuickParticleSystem::moveGroups(QQuickParticleData *d, int newGIdx)
 
 int QQuickParticleSystem::nextSystemIndex()
 {
-    if (!m_reusableIndexes.isEmpty()) {
-        int ret = *(m_reusableIndexes.begin());
-        m_reusableIndexes.remove(ret);
-        return ret;
-    }
+    if (!m_reusableIndexes.isEmpty())
+        return m_reusableIndexes.takeFirst();
     if (m_nextIndex >= bySysIdx.size()) {
         bySysIdx.resize(bySysIdx.size() < 10 ? 10 : bySysIdx.size()*1.1);//###+1,10%,+10? Choose something non-arbitrarily
         if (stateEngine)
@@ -1077,7 +1126,7 @@ QQuickParticleData* QQuickParticleSystem::newDatum(int groupId, bool respectLimi
         if (ret->systemIndex != -1) {
             if (stateEngine)
                 stateEngine->stop(ret->systemIndex);
-            m_reusableIndexes << ret->systemIndex;
+            m_reusableIndexes.insert(ret->systemIndex);
             bySysIdx[ret->systemIndex] = 0;
         }
         ret->systemIndex = sysIndex;
@@ -1119,6 +1168,90 @@ void QQuickParticleSystem::finishNewDatum(QQuickParticleData *pd)
             p->load(pd);
 }
 
+Q_GLOBAL_STATIC(QThreadPool, qquick_particle_pool)
+
+class QQuickParticleAffectorRunnable : public QRunnable
+{
+public:
+    QQuickParticleAffectorRunnable(const QList<QQuickParticleAffector *> &affectors, QAtomicInt *next, QSemaphore *done)
+        : affectors(affectors), next(next), done(done) {}
+
+    void run()
+    {
+        int i;
+        while ((i = next->fetchAndAddRelaxed(1)) < affectors.size())
+            affectors.at(i)->simulateBatch();
+        if (done)
+            done->release();
+    }
+
+private:
+    const QList<QQuickParticleAffector *> &affectors;
+    QAtomicInt *next;
+    QSemaphore *done;
+};
+
+/*
+    Runs the affectors for one frame. Batched affectors whose groups no other
+    affector touches only write their own particles, so their simulation is
+    spread over a thread pool, with the GUI thread taking part. The remaining
+    affectors then run in order on the GUI thread. Everything is joined before
+    returning, so painters syncing afterwards always see a finished frame.
+    Only the runnables started here are waited for, the pool is shared by
+    every particle system.
+ */
+void QQuickParticleSystem::runAffectors(qreal dt)
+{
+    QList<QQuickParticleAffector *> concurrent;
+    QList<QQuickParticleAffector *> serial;
+    foreach (QQuickParticleAffector* a, m_affectors) {
+        bool independent = a->canAffectConcurrently();
+        if (independent) {
+            const QSet<int> &ids = a->groupIds();
+            foreach (QQuickParticleAffector* other, m_affectors) {
+                if (other == a || !other->enabled())
+                    continue;
+                const QSet<int> &otherIds = other->groupIds();
+                if (ids.isEmpty() || otherIds.isEmpty() || ids.intersects(otherIds)) {
+                    independent = false;
+                    break;
+                }
+            }
+        }
+        if (independent)
+            concurrent << a;
+        else
+            serial << a;
+    }
+
+    int particles = 0;
+    for (int i = concurrent.size() - 1; i >= 0; --i) {
+        if (concurrent.at(i)->prepareBatch(dt))
+            particles += concurrent.at(i)->m_batch.count();
+        else
+            concurrent.removeAt(i);
+    }
+
+    QThreadPool *pool = qquick_particle_pool();
+    int workers = qMin(pool->maxThreadCount(), concurrent.size() - 1);
+    if (particles < concurrentAffectorThreshold)
+        workers = 0;
+
+    QAtomicInt next(0);
+    QSemaphore done;
+    for (int i = 0; i < workers; ++i)
+        pool->start(new QQuickParticleAffectorRunnable(concurrent, &next, &done));
+    QQuickParticleAffectorRunnable(concurrent, &next, 0).run();
+    done.acquire(workers);
+
+    foreach (QQuickParticleAffector* a, concurrent)
+        a->finishBatch();
+
+    //These may run script or read other groups, so they stay on the GUI thread after the join
+    foreach (QQuickParticleAffector* a, serial)
+        a->affectSystem(dt);
+}
+
 void QQuickParticleSystem::updateCurrentTime( int currentTime )
 {
     if (!initialized)
@@ -1145,8 +1278,7 @@ void QQuickParticleSystem::updateCurrentTime( int currentTime )
 
     foreach (QQuickParticleEmitter* emitter, m_emitters)
         emitter->emitWindow(timeInt);
-    foreach (QQuickParticleAffector* a, m_affectors)
-        a->affectSystem(dt);
+    runAffectors(dt);
     foreach (QQuickParticleData* d, needsReset)
         foreach (QQuickParticlePainter* p, groupData[d->group]->painters)
             p->reload(d);
@@ -67,36 +67,48 @@ class QQuickV4ParticleData;
 class QQuickParticleGroup;
 class QQuickImageParticle;
 
-struct QQuickParticleDataHeapNode{
-    int time;//in ms
-    QSet<QQuickParticleData*> data;//Set ptrs instead?
-};
-
-class QQuickParticleDataHeap {
-    //Idea is to do a binary heap, but which also stores a set of int,Node* so that if the int already exists, you can
-    //add it to the data* list. Pops return the whole list at once.
+class Q_AUTOTEST_EXPORT QQuickParticleDataWheel {
+    //Timing wheel of expiry times. Each slot covers slotDuration ms and holds an intrusive doubly linked list
+    //through QQuickParticleData, so inserting, moving and expiring particles never allocates. Times further
+    //away than one turn of the wheel simply stay in their slot until the wheel comes round to them.
 public:
-    QQuickParticleDataHeap();
+    QQuickParticleDataWheel();
     void insert(QQuickParticleData* data);
     void insertTimed(QQuickParticleData* data, int time);
+    void remove(QQuickParticleData* data);
 
-    int top();
-
-    QSet<QQuickParticleData*> pop();
+    //Unlinks everything due at or before time, and returns it as a list chained through recyclerNext
+    QQuickParticleData* takeExpired(int time);
 
     void clear();
 
     bool contains(QQuickParticleData*);//O(n), for debugging purposes only
+
+    static const int slotDuration = 16;//ms
+    static const int slotCount = 1024;
 private:
-    void grow();
-    void swap(int, int);
-    void bubbleUp(int);
-    void bubbleDown(int);
-    int m_size;
-    int m_end;
-    QQuickParticleDataHeapNode m_tmp;
-    QVector<QQuickParticleDataHeapNode> m_data;
-    QHash<int,int> m_lookups;
+    QVector<QQuickParticleData*> m_slots;
+    int m_currentTick;
+};
+
+class Q_AUTOTEST_EXPORT QQuickParticleIndexSet {
+    //Bitset of free indexes, replacing a QSet<int> so that taking and returning indexes does not allocate
+public:
+    QQuickParticleIndexSet() : m_count(0), m_firstWord(0) {}
+
+    void resize(int size);
+    void insert(int idx);
+    void remove(int idx);
+    bool contains(int idx) const { return idx < m_bits.size() * 32 && (m_bits.at(idx >> 5) & (1u << (idx & 31))); }
+    int takeFirst();//-1 if empty
+    void clear();
+
+    int count() const { return m_count; }
+    bool isEmpty() const { return !m_count; }
+private:
+    QVector<quint32> m_bits;
+    int m_count;
+    int m_firstWord;//No set bits below this word
 };
 
 class Q_AUTOTEST_EXPORT QQuickParticleGroupData {
@@ -114,8 +126,8 @@ public:
 
     //TODO: Refactor particle data list out into a separate class
     QVector<QQuickParticleData*> data;
-    QQuickParticleDataHeap dataHeap;
-    QSet<int> reusableIndexes;
+    QQuickParticleDataWheel dataWheel;
+    QQuickParticleIndexSet reusableIndexes;
     bool recycle(); //Force recycling round, returns true if all indexes are now reusable
 
     void initList();
@@ -220,6 +232,11 @@ public:
     int modelIndex;
     //Used by custom affectors
     float update;
+    //Used by the recycler, see QQuickParticleDataWheel
+    QQuickParticleData* recyclerNext;
+    QQuickParticleData* recyclerPrev;
+    int recyclerTime;
+    int recyclerSlot;//-1 if not in the wheel
 
 
     void debugDump();
@@ -305,6 +322,7 @@ public:
 
     //Also only here for auto-test usage
     void updateCurrentTime( int currentTime );
+    void runAffectors(qreal dt);
     QQuickParticleSystemAnimation* m_animation;
     bool m_running;
     bool m_debugMode;
@@ -312,6 +330,7 @@ public:
     int timeInt;
     bool initialized;
     int particleCount;
+    int concurrentAffectorThreshold;//Particles needed before affectors are handed to the pool
 
     void registerParticlePainter(QQuickParticlePainter* p);
     void registerParticleEmitter(QQuickParticleEmitter* e);
@@ -340,7 +359,7 @@ private:
     QList<QQuickParticleGroup*> m_groups;
     int m_nextGroupId;
     int m_nextIndex;
-    QSet<int> m_reusableIndexes;
+    QQuickParticleIndexSet m_reusableIndexes;
     bool m_componentComplete;
 
     QSignalMapper m_painterMapper;
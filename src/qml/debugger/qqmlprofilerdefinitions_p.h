@@ -108,6 +108,8 @@ struct QQmlProfilerDefinitions {
         PixmapLoadingStarted,
         PixmapLoadingFinished,
         PixmapLoadingError,
+        PixmapReaderQueueChanged,
+        PixmapDecodingFinished,
 
         MaximumPixmapEventType
     };
@@ -0,0 +1,340 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qv4dataview_p.h"
+#include "qv4arraybuffer_p.h"
+
+#include <QtCore/qendian.h>
+
+using namespace QV4;
+
+DEFINE_OBJECT_VTABLE(DataViewCtor);
+DEFINE_OBJECT_VTABLE(DataView);
+
+DataViewCtor::DataViewCtor(ExecutionContext *scope)
+    : FunctionObject(scope, QStringLiteral("DataView"))
+{
+    setVTable(staticVTable());
+}
+
+ReturnedValue DataViewCtor::construct(Managed *m, CallData *callData)
+{
+    Scope scope(m->engine());
+    Scoped<ArrayBuffer> buffer(scope, callData->argument(0));
+    if (!buffer)
+        return scope.engine->currentContext()->throwTypeError();
+
+    double bo = callData->argc > 1 ? callData->args[1].toNumber() : 0;
+    uint byteOffset = (uint)bo;
+    uint bufferLength = buffer->byteLength();
+    double bl = callData->argc < 3 || callData->args[2].isUndefined() ? (bufferLength - bo) : callData->args[2].toNumber();
+    uint byteLength = (uint)bl;
+    if (scope.engine->hasException)
+        return Encode::undefined();
+    if (bo != byteOffset || bl != byteLength || byteOffset + byteLength > bufferLength)
+        return scope.engine->currentContext()->throwRangeError(QStringLiteral("DataView: invalid offset or length"));
+
+    Scoped<DataView> a(scope, new (scope.engine->memoryManager) DataView(scope.engine));
+    a->buffer = buffer.getPointer();
+    a->byteLength = byteLength;
+    a->byteOffset = byteOffset;
+    return a.asReturnedValue();
+
+}
+
+ReturnedValue DataViewCtor::call(Managed *that, CallData *)
+{
+    return that->engine()->currentContext()->throwTypeError();
+}
+
+
+DataView::DataView(ExecutionEngine *e)
+    : Object(e->dataViewClass)
+    , buffer(0)
+    , byteLength(0)
+    , byteOffset(0)
+{
+}
+
+
+void DataView::destroy(Managed *m)
+{
+    static_cast<DataView *>(m)->~DataView();
+}
+
+void DataView::markObjects(Managed *that, ExecutionEngine *e)
+{
+    DataView *v = static_cast<DataView *>(that);
+    if (v->buffer)
+        v->buffer->mark(e);
+    Object::markObjects(that, e);
+}
+
+void DataViewPrototype::init(ExecutionEngine *engine, ObjectRef ctor)
+{
+    Scope scope(engine);
+    ScopedObject o(scope);
+    ctor->defineReadonlyProperty(engine->id_length, Primitive::fromInt32(3));
+    ctor->defineReadonlyProperty(engine->id_prototype, (o = this));
+    defineDefaultProperty(QStringLiteral("constructor"), (o = ctor));
+    defineAccessorProperty(QStringLiteral("buffer"), method_get_buffer, 0);
+    defineAccessorProperty(QStringLiteral("byteLength"), method_get_byteLength, 0);
+    defineAccessorProperty(QStringLiteral("byteOffset"), method_get_byteOffset, 0);
+
+    defineDefaultProperty(QStringLiteral("getInt8"), method_getChar<signed char>, 0);
+    defineDefaultProperty(QStringLiteral("getUint8"), method_getChar<unsigned char>, 0);
+    defineDefaultProperty(QStringLiteral("getInt16"), method_get<short>, 0);
+    defineDefaultProperty(QStringLiteral("getUint16"), method_get<unsigned short>, 0);
+    defineDefaultProperty(QStringLiteral("getInt32"), method_get<int>, 0);
+    defineDefaultProperty(QStringLiteral("getUint32"), method_get<unsigned int>, 0);
+    defineDefaultProperty(QStringLiteral("getFloat32"), method_getFloat<float>, 0);
+    defineDefaultProperty(QStringLiteral("getFloat64"), method_getFloat<double>, 0);
+
+    defineDefaultProperty(QStringLiteral("setInt8"), method_setChar<signed char>, 0);
+    defineDefaultProperty(QStringLiteral("setUint8"), method_setChar<unsigned char>, 0);
+    defineDefaultProperty(QStringLiteral("setInt16"), method_set<short>, 0);
+    defineDefaultProperty(QStringLiteral("setUint16"), method_set<unsigned short>, 0);
+    defineDefaultProperty(QStringLiteral("setInt32"), method_set<int>, 0);
+    defineDefaultProperty(QStringLiteral("setUint32"), method_set<unsigned int>, 0);
+    defineDefaultProperty(QStringLiteral("setFloat32"), method_setFloat<float>, 0);
+    defineDefaultProperty(QStringLiteral("setFloat64"), method_setFloat<double>, 0);
+}
+
+ReturnedValue DataViewPrototype::method_get_buffer(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<DataView> v(scope, ctx->callData->thisObject);
+    if (!v)
+        return ctx->throwTypeError();
+
+    return v->buffer->asReturnedValue();
+}
+
+ReturnedValue DataViewPrototype::method_get_byteLength(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<DataView> v(scope, ctx->callData->thisObject);
+    if (!v)
+        return ctx->throwTypeError();
+
+    return Encode(v->byteLength);
+}
+
+ReturnedValue DataViewPrototype::method_get_byteOffset(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<DataView> v(scope, ctx->callData->thisObject);
+    if (!v)
+        return ctx->throwTypeError();
+
+    return Encode(v->byteOffset);
+}
+
+template <typename T>
+ReturnedValue DataViewPrototype::method_getChar(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<DataView> v(scope, ctx->callData->thisObject);
+    if (!v || ctx->callData->argc < 1)
+        return ctx->throwTypeError();
+    double l = ctx->callData->args[0].toNumber();
+    uint idx = (uint)l;
+    if (l != idx || idx + sizeof(T) > v->byteLength)
+        return ctx->throwTypeError();
+    idx += v->byteOffset;
+
+    T t = T(v->buffer->constData()[idx]);
+
+    return Encode((int)t);
+}
+
+template <typename T>
+ReturnedValue DataViewPrototype::method_get(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<DataView> v(scope, ctx->callData->thisObject);
+    if (!v || ctx->callData->argc < 1)
+        return ctx->throwTypeError();
+    double l = ctx->callData->args[0].toNumber();
+    uint idx = (uint)l;
+    if (l != idx || idx + sizeof(T) > v->byteLength)
+        return ctx->throwTypeError();
+    idx += v->byteOffset;
+
+    bool littleEndian = ctx->callData->argc < 2 ? false : ctx->callData->args[1].toBoolean();
+
+    T t = littleEndian
+            ? qFromLittleEndian<T>((const uchar *)v->buffer->constData() + idx)
+            : qFromBigEndian<T>((const uchar *)v->buffer->constData() + idx);
+
+    return Encode(t);
+}
+
+template <typename T>
+ReturnedValue DataViewPrototype::method_getFloat(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<DataView> v(scope, ctx->callData->thisObject);
+    if (!v || ctx->callData->argc < 1)
+        return ctx->throwTypeError();
+    double l = ctx->callData->args[0].toNumber();
+    uint idx = (uint)l;
+    if (l != idx || idx + sizeof(T) > v->byteLength)
+        return ctx->throwTypeError();
+    idx += v->byteOffset;
+
+    bool littleEndian = ctx->callData->argc < 2 ? false : ctx->callData->args[1].toBoolean();
+
+    if (sizeof(T) == 4) {
+        // float
+        union {
+            uint i;
+            float f;
+        } u;
+        u.i = littleEndian
+                ? qFromLittleEndian<uint>((const uchar *)v->buffer->constData() + idx)
+                : qFromBigEndian<uint>((const uchar *)v->buffer->constData() + idx);
+        return Encode(u.f);
+    } else {
+        Q_ASSERT(sizeof(T) == 8);
+        union {
+            quint64 i;
+            double d;
+        } u;
+        u.i = littleEndian
+                ? qFromLittleEndian<quint64>((const uchar *)v->buffer->constData() + idx)
+                : qFromBigEndian<quint64>((const uchar *)v->buffer->constData() + idx);
+        return Encode(u.d);
+    }
+}
+
+template <typename T>
+ReturnedValue DataViewPrototype::method_setChar(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<DataView> v(scope, ctx->callData->thisObject);
+    if (!v || ctx->callData->argc < 1)
+        return ctx->throwTypeError();
+    double l = ctx->callData->args[0].toNumber();
+    uint idx = (uint)l;
+    if (l != idx || idx + sizeof(T) > v->byteLength)
+        return ctx->throwTypeError();
+    idx += v->byteOffset;
+
+    int val = ctx->callData->argc >= 2 ? ctx->callData->args[1].toInt32() : 0;
+    if (scope.engine->hasException)
+        return Encode::undefined();
+    v->buffer->data()[idx] = (char)val;
+
+    return Encode::undefined();
+}
+
+template <typename T>
+ReturnedValue DataViewPrototype::method_set(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<DataView> v(scope, ctx->callData->thisObject);
+    if (!v || ctx->callData->argc < 1)
+        return ctx->throwTypeError();
+    double l = ctx->callData->args[0].toNumber();
+    uint idx = (uint)l;
+    if (l != idx || idx + sizeof(T) > v->byteLength)
+        return ctx->throwTypeError();
+    idx += v->byteOffset;
+
+    int val = ctx->callData->argc >= 2 ? ctx->callData->args[1].toInt32() : 0;
+    if (scope.engine->hasException)
+        return Encode::undefined();
+
+    bool littleEndian = ctx->callData->argc < 3 ? false : ctx->callData->args[2].toBoolean();
+
+    if (littleEndian)
+        qToLittleEndian<T>(val, (uchar *)v->buffer->data() + idx);
+    else
+        qToBigEndian<T>(val, (uchar *)v->buffer->data() + idx);
+
+    return Encode::undefined();
+}
+
+template <typename T>
+ReturnedValue DataViewPrototype::method_setFloat(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<DataView> v(scope, ctx->callData->thisObject);
+    if (!v || ctx->callData->argc < 1)
+        return ctx->throwTypeError();
+    double l = ctx->callData->args[0].toNumber();
+    uint idx = (uint)l;
+    if (l != idx || idx + sizeof(T) > v->byteLength)
+        return ctx->throwTypeError();
+    idx += v->byteOffset;
+
+    double val = ctx->callData->argc >= 2 ? ctx->callData->args[1].toNumber() : qSNaN();
+    if (scope.engine->hasException)
+        return Encode::undefined();
+
+    bool littleEndian = ctx->callData->argc < 3 ? false : ctx->callData->args[2].toBoolean();
+
+    if (sizeof(T) == 4) {
+        // float
+        union {
+            uint i;
+            float f;
+        } u;
+        u.f = val;
+        if (littleEndian)
+            qToLittleEndian(u.i, (uchar *)v->buffer->data() + idx);
+        else
+            qToBigEndian(u.i, (uchar *)v->buffer->data() + idx);
+    } else {
+        Q_ASSERT(sizeof(T) == 8);
+        union {
+            quint64 i;
+            double d;
+        } u;
+        u.d = val;
+        if (littleEndian)
+            qToLittleEndian(u.i, (uchar *)v->buffer->data() + idx);
+        else
+            qToBigEndian(u.i, (uchar *)v->buffer->data() + idx);
+    }
+    return Encode::undefined();
+}
@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QV4DATAVIEW_H
+#define QV4DATAVIEW_H
+
+#include "qv4object_p.h"
+#include "qv4functionobject_p.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+
+struct DataViewCtor: FunctionObject
+{
+    V4_OBJECT
+    DataViewCtor(ExecutionContext *scope);
+
+    static ReturnedValue construct(Managed *m, CallData *callData);
+    static ReturnedValue call(Managed *that, CallData *callData);
+};
+
+struct DataView : Object
+{
+    V4_OBJECT
+    Q_MANAGED_TYPE(DataView)
+    DataView(ExecutionEngine *e);
+
+    ArrayBuffer *buffer;
+    uint byteLength;
+    uint byteOffset;
+
+    static void destroy(Managed *m);
+    static void markObjects(Managed *that, ExecutionEngine *e);
+};
+
+struct DataViewPrototype: Object
+{
+    DataViewPrototype(InternalClass *ic): Object(ic) {}
+    void init(ExecutionEngine *engine, ObjectRef ctor);
+
+    static ReturnedValue method_get_buffer(CallContext *ctx);
+    static ReturnedValue method_get_byteLength(CallContext *ctx);
+    static ReturnedValue method_get_byteOffset(CallContext *ctx);
+    template <typename T>
+    static ReturnedValue method_getChar(CallContext *ctx);
+    template <typename T>
+    static ReturnedValue method_get(CallContext *ctx);
+    template <typename T>
+    static ReturnedValue method_getFloat(CallContext *ctx);
+    template <typename T>
+    static ReturnedValue method_setChar(CallContext *ctx);
+    template <typename T>
+    static ReturnedValue method_set(CallContext *ctx);
+    template <typename T>
+    static ReturnedValue method_setFloat(CallContext *ctx);
+};
+
+}
+
+QT_END_NAMESPACE
+
+#endif
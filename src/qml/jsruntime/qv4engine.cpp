@@ -69,6 +69,9 @@
 #include "qv4qobjectwrapper_p.h"
 #include "qv4qmlextensions_p.h"
 #include "qv4memberdata_p.h"
+#include "qv4arraybuffer_p.h"
+#include "qv4typedarray_p.h"
+#include "qv4dataview_p.h"
 
 #include <QtCore/QTextStream>
 
@@ -331,6 +334,18 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
 
     sequencePrototype = new (memoryManager) SequencePrototype(arrayClass);
 
+    ArrayBufferPrototype *arrayBufferPrototype = new (memoryManager) ArrayBufferPrototype(InternalClass::create(this, Object::staticVTable(), objectPrototype));
+    arrayBufferClass = InternalClass::create(this, ArrayBuffer::staticVTable(), arrayBufferPrototype);
+
+    DataViewPrototype *dataViewPrototype = new (memoryManager) DataViewPrototype(InternalClass::create(this, Object::staticVTable(), objectPrototype));
+    dataViewClass = InternalClass::create(this, DataView::staticVTable(), dataViewPrototype);
+
+    TypedArrayPrototype *typedArrayPrototypes[NTypedArrayTypes];
+    for (int i = 0; i < NTypedArrayTypes; ++i) {
+        typedArrayPrototypes[i] = new (memoryManager) TypedArrayPrototype(InternalClass::create(this, Object::staticVTable(), objectPrototype), (TypedArrayType)i);
+        typedArrayClasses[i] = InternalClass::create(this, TypedArray::staticVTable(), typedArrayPrototypes[i]);
+    }
+
     objectCtor = new (memoryManager) ObjectCtor(rootContext);
     stringCtor = new (memoryManager) StringCtor(rootContext);
     numberCtor = new (memoryManager) NumberCtor(rootContext);
@@ -346,6 +361,10 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
     syntaxErrorCtor = new (memoryManager) SyntaxErrorCtor(rootContext);
     typeErrorCtor = new (memoryManager) TypeErrorCtor(rootContext);
     uRIErrorCtor = new (memoryManager) URIErrorCtor(rootContext);
+    arrayBufferCtor = new (memoryManager) ArrayBufferCtor(rootContext);
+    dataViewCtor = new (memoryManager) DataViewCtor(rootContext);
+    for (int i = 0; i < NTypedArrayTypes; ++i)
+        typedArrayCtors[i] = new (memoryManager) TypedArrayCtor(rootContext, (TypedArrayType)i);
 
     objectPrototype->init(this, objectCtor);
     stringPrototype->init(this, stringCtor);
@@ -362,6 +381,10 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
     syntaxErrorPrototype->init(this, syntaxErrorCtor);
     typeErrorPrototype->init(this, typeErrorCtor);
     uRIErrorPrototype->init(this, uRIErrorCtor);
+    arrayBufferPrototype->init(this, arrayBufferCtor);
+    dataViewPrototype->init(this, dataViewCtor);
+    for (int i = 0; i < NTypedArrayTypes; ++i)
+        typedArrayPrototypes[i]->init(this, typedArrayCtors[i]);
 
     variantPrototype->init();
     static_cast<SequencePrototype *>(sequencePrototype.managed())->init();
@@ -389,6 +412,10 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
     globalObject->defineDefaultProperty(QStringLiteral("SyntaxError"), syntaxErrorCtor);
     globalObject->defineDefaultProperty(QStringLiteral("TypeError"), typeErrorCtor);
     globalObject->defineDefaultProperty(QStringLiteral("URIError"), uRIErrorCtor);
+    globalObject->defineDefaultProperty(QStringLiteral("ArrayBuffer"), arrayBufferCtor);
+    globalObject->defineDefaultProperty(QStringLiteral("DataView"), dataViewCtor);
+    for (int i = 0; i < NTypedArrayTypes; ++i)
+        globalObject->defineDefaultProperty(QLatin1String(operations[i].name), typedArrayCtors[i]);
     ScopedObject o(scope);
     globalObject->defineDefaultProperty(QStringLiteral("Math"), (o = new (memoryManager) MathObject(QV4::InternalClass::create(this, MathObject::staticVTable(), objectPrototype))));
     globalObject->defineDefaultProperty(QStringLiteral("JSON"), (o = new (memoryManager) JsonObject(QV4::InternalClass::create(this, JsonObject::staticVTable(), objectPrototype))));
@@ -566,6 +593,18 @@ Returned<ArrayObject> *ExecutionEngine::newArrayObject(InternalClass *ic)
     return object->asReturned<ArrayObject>();
 }
 
+Returned<ArrayBuffer> *ExecutionEngine::newArrayBuffer(const QByteArray &array)
+{
+    ArrayBuffer *object = new (memoryManager) ArrayBuffer(this, array);
+    return object->asReturned<ArrayBuffer>();
+}
+
+Returned<ArrayBuffer> *ExecutionEngine::newArrayBuffer(uint length)
+{
+    ArrayBuffer *object = new (memoryManager) ArrayBuffer(this, length);
+    return object->asReturned<ArrayBuffer>();
+}
+
 
 Returned<DateObject> *ExecutionEngine::newDateObject(const ValueRef value)
 {
@@ -897,6 +936,10 @@ void ExecutionEngine::markObjects()
     syntaxErrorCtor.mark(this);
     typeErrorCtor.mark(this);
     uRIErrorCtor.mark(this);
+    arrayBufferCtor.mark(this);
+    dataViewCtor.mark(this);
+    for (int i = 0; i < NTypedArrayTypes; ++i)
+        typedArrayCtors[i].mark(this);
     sequencePrototype.mark(this);
 
     exceptionValue.mark(this);
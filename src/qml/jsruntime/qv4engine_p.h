@@ -199,6 +199,9 @@ public:
     Value syntaxErrorCtor;
     Value typeErrorCtor;
     Value uRIErrorCtor;
+    Value arrayBufferCtor;
+    Value dataViewCtor;
+    Value typedArrayCtors[NTypedArrayTypes];
     Value sequencePrototype;
 
     InternalClassPool *classPool;
@@ -232,6 +235,10 @@ public:
     InternalClass *argumentsObjectClass;
     InternalClass *strictArgumentsObjectClass;
 
+    InternalClass *arrayBufferClass;
+    InternalClass *dataViewClass;
+    InternalClass *typedArrayClasses[NTypedArrayTypes];
+
     InternalClass *variantClass;
     InternalClass *memberDataClass;
 
@@ -333,6 +340,9 @@ public:
     Returned<DateObject> *newDateObject(const QDateTime &dt);
 
     Returned<RegExpObject> *newRegExpObject(const QString &pattern, int flags);
+
+    Returned<ArrayBuffer> *newArrayBuffer(const QByteArray &array);
+    Returned<ArrayBuffer> *newArrayBuffer(uint length);
     Returned<RegExpObject> *newRegExpObject(RegExpRef re, bool global);
     Returned<RegExpObject> *newRegExpObject(const QRegExp &re);
 
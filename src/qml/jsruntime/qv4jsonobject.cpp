@@ -46,8 +46,10 @@
 #include <qv4objectiterator_p.h>
 #include <qv4scopedvalue_p.h>
 #include <qjsondocument.h>
+#include <qhash.h>
 #include <qstack.h>
 #include <qstringlist.h>
+#include <private/qsimd_p.h>
 
 #include <wtf/MathExtras.h>
 
@@ -79,9 +81,10 @@ private:
     inline bool eatSpace();
     inline QChar nextToken();
 
-    ReturnedValue parseObject();
+    ReturnedValue parseObject(InternalClass *shape = 0);
     ReturnedValue parseArray();
-    bool parseMember(ObjectRef o);
+    bool parseMember(ObjectRef o, String *expectedKey);
+    bool matchKey(String *key);
     bool parseString(QString *string);
     bool parseValue(ValueRef val);
     bool parseNumber(ValueRef val);
@@ -227,7 +230,13 @@ ReturnedValue JsonParser::parse(QJsonParseError *error)
     end-object
 */
 
-ReturnedValue JsonParser::parseObject()
+/*
+    \a shape is the internal class of the previous object in the same array.
+    Arrays of records mostly repeat the same keys in the same order, so these
+    are compared against the input directly, instead of building a string for
+    each key and looking it up in the identifier table.
+*/
+ReturnedValue JsonParser::parseObject(InternalClass *shape)
 {
     if (++nestingLevel > nestingLimit) {
         lastError = QJsonParseError::DeepNesting;
@@ -238,10 +247,17 @@ ReturnedValue JsonParser::parseObject()
     Scope scope(context);
 
     ScopedObject o(scope, context->engine->newObject());
+    uint memberIndex = 0;
+    if (shape && shape->size)
+        o->ensureMemberIndex(shape->size - 1);
 
     QChar token = nextToken();
     while (token == Quote) {
-        if (!parseMember(o))
+        String *expectedKey = 0;
+        if (shape && memberIndex < shape->size)
+            expectedKey = shape->nameMap.constData()[memberIndex];
+        ++memberIndex;
+        if (!parseMember(o, expectedKey))
             return Encode::undefined();
         token = nextToken();
         if (token != ValueSeparator)
@@ -268,14 +284,20 @@ ReturnedValue JsonParser::parseObject()
 /*
     member = string name-separator value
 */
-bool JsonParser::parseMember(ObjectRef o)
+bool JsonParser::parseMember(ObjectRef o, String *expectedKey)
 {
     BEGIN << "parseMember";
     Scope scope(context);
 
-    QString key;
-    if (!parseString(&key))
-        return false;
+    ScopedString s(scope);
+    if (expectedKey && matchKey(expectedKey)) {
+        s = expectedKey;
+    } else {
+        QString key;
+        if (!parseString(&key))
+            return false;
+        s = context->engine->newIdentifier(key);
+    }
     QChar token = nextToken();
     if (token != NameSeparator) {
         lastError = QJsonParseError::MissingNameSeparator;
@@ -285,7 +307,6 @@ bool JsonParser::parseMember(ObjectRef o)
     if (!parseValue(val))
         return false;
 
-    ScopedString s(scope, context->engine->newIdentifier(key));
     uint idx = s->asArrayIndex();
     if (idx < UINT_MAX) {
         o->putIndexed(idx, val);
@@ -297,6 +318,27 @@ bool JsonParser::parseMember(ObjectRef o)
     return true;
 }
 
+/*
+    Consumes \a key and its closing quote if the input continues with exactly
+    these characters. Keys which would need escaping in JSON never match.
+*/
+bool JsonParser::matchKey(String *key)
+{
+    const QString name = key->toQString();
+    const int length = name.length();
+    if (end - json <= length || json[length] != Quote)
+        return false;
+
+    const QChar *k = name.constData();
+    for (int i = 0; i < length; ++i) {
+        const ushort c = k[i].unicode();
+        if (json[i].unicode() != c || c == Quote || c == '\\' || c < Space)
+            return false;
+    }
+    json += length + 1;
+    return true;
+}
+
 /*
     array = begin-array [ value *( value-separator value ) ] end-array
 */
@@ -319,10 +361,18 @@ ReturnedValue JsonParser::parseArray()
         nextToken();
     } else {
         uint index = 0;
+        InternalClass *shape = 0;
+        ScopedValue val(scope);
         while (1) {
-            ScopedValue val(scope);
-            if (!parseValue(val))
+            if (*json == BeginObject) {
+                ++json;
+                val = parseObject(shape);
+                if (val->isUndefined())
+                    return Encode::undefined();
+                shape = val->objectValue()->internalClass;
+            } else if (!parseValue(val)) {
                 return Encode::undefined();
+            }
             array->arraySet(index, val);
             QChar token = nextToken();
             if (token == EndArray)
@@ -495,6 +545,26 @@ bool JsonParser::parseNumber(ValueRef val)
             ++json;
     }
 
+    // Short integers are by far the most common numbers, convert these
+    // without going through QString. "-0" has to stay a negative zero.
+    if (isInt) {
+        const QChar *digit = start;
+        bool negative = (digit < json && *digit == '-');
+        if (negative)
+            ++digit;
+        if (digit < json && json - digit <= 7) {
+            int n = 0;
+            for (; digit < json; ++digit)
+                n = n * 10 + (digit->unicode() - '0');
+            if (negative && n == 0)
+                *val = Primitive::fromDouble(-0.0);
+            else
+                *val = Primitive::fromInt32(negative ? -n : n);
+            END;
+            return true;
+        }
+    }
+
     QString number(start, json - start);
     DEBUG << "numberstring" << number;
 
@@ -603,10 +673,52 @@ static inline bool scanEscapeSequence(const QChar *&json, const QChar *end, uint
 }
 
 
+/*
+    Returns the first character from \a json on which is a quote, a backslash
+    or a control character, or \a end.
+*/
+static inline const QChar *scanPlainCharacters(const QChar *json, const QChar *end)
+{
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi16(Quote);
+    const __m128i backslash = _mm_set1_epi16('\\');
+    const __m128i space = _mm_set1_epi16(Space);
+    const __m128i zero = _mm_setzero_si128();
+    while (end - json >= 8) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i special = _mm_or_si128(_mm_cmpeq_epi16(chunk, quote),
+                                             _mm_cmpeq_epi16(chunk, backslash));
+        // Space - c saturates to zero for everything but control characters
+        const __m128i printable = _mm_cmpeq_epi16(_mm_subs_epu16(space, chunk), zero);
+        if (_mm_movemask_epi8(special) || _mm_movemask_epi8(printable) != 0xffff)
+            break;
+        json += 8;
+    }
+#endif
+    while (json < end) {
+        const ushort c = json->unicode();
+        if (c == Quote || c == '\\' || c < Space)
+            break;
+        ++json;
+    }
+    return json;
+}
+
 bool JsonParser::parseString(QString *string)
 {
     BEGIN << "parse string stringPos=" << json;
 
+    // Most strings have no escape sequences and can be copied in one go
+    const QChar *start = json;
+    json = scanPlainCharacters(json, end);
+    if (json < end && *json == Quote) {
+        *string = QString(start, json - start);
+        ++json;
+        END;
+        return true;
+    }
+    string->append(start, json - start);
+
     while (json < end) {
         if (*json == '"')
             break;
@@ -627,8 +739,9 @@ bool JsonParser::parseString(QString *string)
                 lastError = QJsonParseError::IllegalEscapeSequence;
                 return false;
             }
-            *string += *json;
-            ++json;
+            const QChar *run = json;
+            json = scanPlainCharacters(json, end);
+            string->append(run, json - run);
         }
     }
     ++json;
@@ -651,23 +764,50 @@ struct Stringify
     QString gap;
     QString indent;
 
+    // The whole output is appended to this single buffer
+    QString result;
+
     QStack<Object *> stack;
 
-    Stringify(ExecutionContext *ctx) : ctx(ctx), replacerFunction(0) {}
+    // Quoted member names, followed by the name separator, for each internal
+    // class of plain data objects. Empty names are members to skip.
+    QHash<InternalClass *, QVector<QString> > plainShapes;
+    String *toJSONName;
+    bool objectPrototypeHasToJSON;
+
+    Stringify(ExecutionContext *ctx);
 
-    QString Str(const QString &key, ValueRef v);
-    QString JA(ArrayObjectRef a);
-    QString JO(ObjectRef o);
+    bool Str(const QString &key, ValueRef v, uint index = UINT_MAX);
+    void JA(ArrayObjectRef a);
+    void JO(ObjectRef o, const QVector<QString> *plainMembers = 0);
 
-    QString makeMember(const QString &key, ValueRef v);
+    bool plainShape(Object *o, QVector<QString> *members);
+    void appendMember(const QString &quotedName, const QString &key, ValueRef v, bool *empty);
 };
 
-static QString quote(const QString &str)
+Stringify::Stringify(ExecutionContext *ctx)
+    : ctx(ctx), replacerFunction(0)
 {
-    QString product = QStringLiteral("\"");
-    for (int i = 0; i < str.length(); ++i) {
-        QChar c = str.at(i);
-        switch (c.unicode()) {
+    Scope scope(ctx);
+    toJSONName = ctx->engine->newIdentifier(QStringLiteral("toJSON"));
+    ScopedString s(scope, toJSONName);
+    ScopedObject objectPrototype(scope, ctx->engine->objectClass->prototype);
+    objectPrototypeHasToJSON = !ScopedValue(scope, objectPrototype->get(s))->isUndefined();
+}
+
+static void quote(QString &product, const QString &str)
+{
+    product += QLatin1Char('"');
+    const QChar *c = str.constData();
+    const QChar *end = c + str.length();
+    while (c < end) {
+        const QChar *run = c;
+        c = scanPlainCharacters(c, end);
+        product.append(run, c - run);
+        if (c == end)
+            break;
+
+        switch (c->unicode()) {
         case '"':
             product += QStringLiteral("\\\"");
             break;
@@ -690,32 +830,76 @@ static QString quote(const QString &str)
             product += QStringLiteral("\\t");
             break;
         default:
-            if (c.unicode() <= 0x1f) {
-                product += QStringLiteral("\\u00");
-                product += c.unicode() > 0xf ? QLatin1Char('1') : QLatin1Char('0');
-                product += QLatin1Char("0123456789abcdef"[c.unicode() & 0xf]);
-            } else {
-                product += c;
-            }
+            product += QStringLiteral("\\u00");
+            product += c->unicode() > 0xf ? QLatin1Char('1') : QLatin1Char('0');
+            product += QLatin1Char("0123456789abcdef"[c->unicode() & 0xf]);
         }
+        ++c;
     }
     product += QLatin1Char('"');
-    return product;
 }
 
-QString Stringify::Str(const QString &key, ValueRef v)
+/*
+    Returns true if \a o is a plain data object, which can be written straight
+    from its members: no toJSON, no accessors, no indexed properties and no
+    replacer or property list given. The member names are quoted once for each
+    internal class and returned in \a members.
+*/
+bool Stringify::plainShape(Object *o, QVector<QString> *members)
+{
+    if (replacerFunction || !propertyList.isEmpty() || objectPrototypeHasToJSON)
+        return false;
+
+    InternalClass *ic = o->internalClass;
+    if (ic->vtable->type != Managed::Type_Object || ic->prototype != ctx->engine->objectClass->prototype
+            || o->hasAccessorProperty || (o->arrayData && o->arrayData->length()))
+        return false;
+
+    QHash<InternalClass *, QVector<QString> >::const_iterator it = plainShapes.constFind(ic);
+    if (it == plainShapes.constEnd()) {
+        QVector<QString> names;
+        names.reserve(ic->size);
+        for (uint i = 0; i < ic->size; ++i) {
+            String *name = ic->nameMap.at(i);
+            PropertyAttributes attrs = ic->propertyData.at(i);
+            if (!name || attrs.isAccessor() || name->isEqualTo(toJSONName)) {
+                names.clear();
+                break;
+            }
+            QString quoted;
+            if (attrs.isEnumerable()) {
+                quote(quoted, name->toQString());
+                quoted += QLatin1Char(':');
+                if (!gap.isEmpty())
+                    quoted += QLatin1Char(' ');
+            }
+            names.append(quoted);
+        }
+        // Classes which are not plain are remembered with an empty list
+        it = plainShapes.insert(ic, names);
+    }
+
+    if (it->isEmpty() && ic->size)
+        return false;
+    *members = *it;
+    return true;
+}
+
+bool Stringify::Str(const QString &key, ValueRef v, uint index)
 {
     Scope scope(ctx);
 
     ScopedValue value(scope, *v);
     ScopedObject o(scope, value);
-    if (o) {
-        ScopedString s(scope, ctx->engine->newString(QStringLiteral("toJSON")));
+    QVector<QString> plainMembers;
+    const bool plain = o && plainShape(o.getPointer(), &plainMembers);
+    if (o && !plain) {
+        ScopedString s(scope, toJSONName);
         Scoped<FunctionObject> toJSON(scope, o->get(s));
         if (!!toJSON) {
             ScopedCallData callData(scope, 1);
             callData->thisObject = value;
-            callData->args[0] = ctx->engine->newString(key);
+            callData->args[0] = ctx->engine->newString(index == UINT_MAX ? key : QString::number(index));
             value = toJSON->call(callData);
         }
     }
@@ -724,12 +908,17 @@ QString Stringify::Str(const QString &key, ValueRef v)
         ScopedObject holder(scope, ctx->engine->newObject());
         holder->put(ctx, QString(), value);
         ScopedCallData callData(scope, 2);
-        callData->args[0] = ctx->engine->newString(key);
+        callData->args[0] = ctx->engine->newString(index == UINT_MAX ? key : QString::number(index));
         callData->args[1] = value;
         callData->thisObject = holder;
         value = replacerFunction->call(callData);
     }
 
+    if (plain) {
+        JO(o, &plainMembers);
+        return true;
+    }
+
     o = value.asReturnedValue();
     if (o) {
         if (NumberObject *n = o->asNumberObject())
@@ -740,16 +929,27 @@ QString Stringify::Str(const QString &key, ValueRef v)
             value = b->value;
     }
 
-    if (value->isNull())
-        return QStringLiteral("null");
-    if (value->isBoolean())
-        return value->booleanValue() ? QStringLiteral("true") : QStringLiteral("false");
-    if (value->isString())
-        return quote(value->stringValue()->toQString());
+    if (value->isNull()) {
+        result += QStringLiteral("null");
+        return true;
+    }
+    if (value->isBoolean()) {
+        result += value->booleanValue() ? QStringLiteral("true") : QStringLiteral("false");
+        return true;
+    }
+    if (value->isString()) {
+        quote(result, value->stringValue()->toQString());
+        return true;
+    }
 
     if (value->isNumber()) {
-        double d = value->toNumber();
-        return std::isfinite(d) ? value->toString(ctx)->toQString() : QStringLiteral("null");
+        if (value->isInteger()) {
+            result += QString::number(value->integerValue());
+        } else {
+            double d = value->toNumber();
+            result += std::isfinite(d) ? value->toString(ctx)->toQString() : QStringLiteral("null");
+        }
+        return true;
     }
 
     o = value.asReturnedValue();
@@ -757,129 +957,157 @@ QString Stringify::Str(const QString &key, ValueRef v)
         if (!o->asFunctionObject()) {
             if (o->asArrayObject()) {
                 ScopedArrayObject a(scope, o);
-                return JA(a);
+                JA(a);
             } else {
-                return JO(o);
+                JO(o);
             }
+            return true;
         }
     }
 
-    return QString();
+    return false;
 }
 
-QString Stringify::makeMember(const QString &key, ValueRef v)
+// Writes the separator, the quoted name and the value, or nothing if the
+// value is not serializable.
+void Stringify::appendMember(const QString &quotedName, const QString &key, ValueRef v, bool *empty)
 {
-    QString strP = Str(key, v);
-    if (!strP.isEmpty()) {
-        QString member = quote(key) + QLatin1Char(':');
-        if (!gap.isEmpty())
-            member += QLatin1Char(' ');
-        member += strP;
-        return member;
+    const int rollback = result.size();
+    if (!gap.isEmpty()) {
+        result += *empty ? QStringLiteral("\n") : QStringLiteral(",\n");
+        result += indent;
+    } else if (!*empty) {
+        result += QLatin1Char(',');
     }
-    return QString();
+    result += quotedName;
+
+    if (Str(key, v))
+        *empty = false;
+    else
+        result.truncate(rollback);
 }
 
-QString Stringify::JO(ObjectRef o)
+void Stringify::JO(ObjectRef o, const QVector<QString> *plainMembers)
 {
     if (stack.contains(o.getPointer())) {
         ctx->throwTypeError();
-        return QString();
+        return;
     }
 
     Scope scope(ctx);
 
-    QString result;
     stack.push(o.getPointer());
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
-    if (propertyList.isEmpty()) {
+    result += QLatin1Char('{');
+    bool empty = true;
+
+    if (plainMembers) {
+        // A toJSON function or getter of a member value can add or remove
+        // members of this object. The member list stays the one of the
+        // original internal class, but once the class changed, the values
+        // have to be looked up by name.
+        InternalClass *ic = o->internalClass;
+        ScopedValue val(scope);
+        ScopedString name(scope);
+        for (int i = 0; i < plainMembers->size(); ++i) {
+            const QString &quotedName = plainMembers->at(i);
+            if (quotedName.isEmpty())
+                continue;
+            name = ic->nameMap.at(i);
+            if (o->internalClass == ic) {
+                val = o->memberData[i];
+            } else {
+                bool exists;
+                val = o->get(name, &exists);
+                if (!exists)
+                    continue;
+            }
+            appendMember(quotedName, name->toQString(), val, &empty);
+        }
+    } else if (propertyList.isEmpty()) {
         ObjectIterator it(scope, o, ObjectIterator::EnumerableOnly);
         ScopedValue name(scope);
 
         ScopedValue val(scope);
+        QString quotedName;
         while (1) {
             name = it.nextPropertyNameAsString(val);
             if (name->isNull())
                 break;
             QString key = name->toQString();
-            QString member = makeMember(key, val);
-            if (!member.isEmpty())
-                partial += member;
+            quotedName.clear();
+            quote(quotedName, key);
+            quotedName += gap.isEmpty() ? QStringLiteral(":") : QStringLiteral(": ");
+            appendMember(quotedName, key, val, &empty);
         }
     } else {
         ScopedString s(scope);
+        QString quotedName;
         for (int i = 0; i < propertyList.size(); ++i) {
             bool exists;
             s = propertyList.at(i);
             ScopedValue v(scope, o->get(s, &exists));
             if (!exists)
                 continue;
-            QString member = makeMember(s->toQString(), v);
-            if (!member.isEmpty())
-                partial += member;
+            QString key = s->toQString();
+            quotedName.clear();
+            quote(quotedName, key);
+            quotedName += gap.isEmpty() ? QStringLiteral(":") : QStringLiteral(": ");
+            appendMember(quotedName, key, v, &empty);
         }
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("{}");
-    } else if (gap.isEmpty()) {
-        result = QStringLiteral("{") + partial.join(QLatin1Char(',')) + QStringLiteral("}");
-    } else {
-        QString separator = QStringLiteral(",\n") + indent;
-        result = QStringLiteral("{\n") + indent + partial.join(separator) + QStringLiteral("\n") + stepback + QStringLiteral("}");
+    if (!empty && !gap.isEmpty()) {
+        result += QLatin1Char('\n');
+        result += stepback;
     }
+    result += QLatin1Char('}');
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
-QString Stringify::JA(ArrayObjectRef a)
+void Stringify::JA(ArrayObjectRef a)
 {
     if (stack.contains(a.getPointer())) {
         ctx->throwTypeError();
-        return QString();
+        return;
     }
 
     Scope scope(a->engine());
 
-    QString result;
     stack.push(a.getPointer());
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
+    result += QLatin1Char('[');
+
     uint len = a->getLength();
     ScopedValue v(scope);
     for (uint i = 0; i < len; ++i) {
+        if (!gap.isEmpty()) {
+            result += i ? QStringLiteral(",\n") : QStringLiteral("\n");
+            result += indent;
+        } else if (i) {
+            result += QLatin1Char(',');
+        }
+
         bool exists;
         v = a->getIndexed(i, &exists);
-        if (!exists) {
-            partial += QStringLiteral("null");
-            continue;
-        }
-        QString strP = Str(QString::number(i), v);
-        if (!strP.isEmpty())
-            partial += strP;
-        else
-            partial += QStringLiteral("null");
+        if (!exists || !Str(QString(), v, i))
+            result += QStringLiteral("null");
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("[]");
-    } else if (gap.isEmpty()) {
-        result = QStringLiteral("[") + partial.join(QLatin1Char(',')) + QStringLiteral("]");
-    } else {
-        QString separator = QStringLiteral(",\n") + indent;
-        result = QStringLiteral("[\n") + indent + partial.join(separator) + QStringLiteral("\n") + stepback + QStringLiteral("]");
+    if (len && !gap.isEmpty()) {
+        result += QLatin1Char('\n');
+        result += stepback;
     }
+    result += QLatin1Char(']');
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
 
@@ -951,10 +1179,9 @@ ReturnedValue JsonObject::method_stringify(CallContext *ctx)
 
 
     ScopedValue arg0(scope, ctx->argument(0));
-    QString result = stringify.Str(QString(), arg0);
-    if (result.isEmpty() || scope.engine->hasException)
+    if (!stringify.Str(QString(), arg0) || scope.engine->hasException)
         return Encode::undefined();
-    return ctx->engine->newString(result)->asReturnedValue();
+    return ctx->engine->newString(stringify.result)->asReturnedValue();
 }
 
 
@@ -157,6 +157,15 @@ QString Managed::className() const
     case Type_MathObject:
         s = "Math";
         break;
+    case Type_ArrayBuffer:
+        s = "ArrayBuffer";
+        break;
+    case Type_TypedArray:
+        s = "TypedArray";
+        break;
+    case Type_DataView:
+        s = "DataView";
+        break;
 
     case Type_ExecutionContext:
         s = "__ExecutionContext";
@@ -54,6 +54,7 @@
 #include "qv4scopedvalue_p.h"
 #include <private/qqmlcontextwrapper_p.h>
 #include "qv4qobjectwrapper_p.h"
+#include "qv4typedarray_p.h"
 #include <private/qv8engine_p.h>
 #endif
 
@@ -588,6 +589,11 @@ ReturnedValue Runtime::getElement(ExecutionContext *ctx, const ValueRef object,
     }
 
     if (idx < UINT_MAX) {
+        if (TypedArray *a = o->as<TypedArray>()) {
+            if (idx < a->length())
+                return a->readElement(idx);
+            return Encode::undefined();
+        }
         if (!o->arrayData->hasAttributes()) {
             ScopedValue v(scope, o->arrayData->get(idx));
             if (!v->isEmpty())
@@ -618,6 +624,10 @@ void Runtime::setElement(ExecutionContext *ctx, const ValueRef object, const Val
                 s->data[idx] = value;
                 return;
             }
+        } else if (TypedArray *a = o->as<TypedArray>()) {
+            if (idx < a->length())
+                a->writeElement(idx, value);
+            return;
         }
         o->putIndexed(idx, value);
         return;
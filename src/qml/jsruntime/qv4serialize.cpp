@@ -68,6 +68,10 @@ using namespace QV4;
 //    + Date
 //    + RegExp
 // <quint8 type><quint24 size><data>
+//
+// Strings longer than SharedStringLength are not copied into the data, they
+// travel in the message's string table and are shared with the receiving
+// engine. Arrays of numbers are written as one block of int32 or double.
 
 enum Type {
     WorkerUndefined,
@@ -84,9 +88,14 @@ enum Type {
     WorkerDate,
     WorkerRegexp,
     WorkerListModel,
-    WorkerSequence
+    WorkerSequence,
+    WorkerSharedString,
+    WorkerInt32Array,
+    WorkerNumberArray
 };
 
+static const int SharedStringLength = 64;
+
 static inline quint32 valueheader(Type type, quint32 size = 0)
 {
     return quint8(type) << 24 | (size & 0xFFFFFF);
@@ -143,14 +152,54 @@ static inline void *popPtr(const char *&data)
     return rv;
 }
 
+static bool serializeNumberArray(QByteArray &data, QV4::ArrayObject *array, uint32_t length, QV4::Scope &scope)
+{
+    QV4::ArrayData *arrayData = array->arrayData;
+    if (!length || !arrayData || arrayData->type != QV4::ArrayData::Simple || arrayData->length() < length)
+        return false;
+
+    bool integers = true;
+    QV4::ScopedValue val(scope);
+    for (uint32_t ii = 0; ii < length; ++ii) {
+        val = arrayData->get(ii);
+        if (!val->isNumber())
+            return false;
+        integers &= val->isInteger();
+    }
+
+    if (integers) {
+        reserve(data, sizeof(quint32) + length * sizeof(quint32));
+        push(data, valueheader(WorkerInt32Array, length));
+        int offset = data.size();
+        data.resize(offset + length * sizeof(quint32));
+        quint32 *buffer = reinterpret_cast<quint32 *>(data.data() + offset);
+        for (uint32_t ii = 0; ii < length; ++ii) {
+            val = arrayData->get(ii);
+            buffer[ii] = (quint32)val->integerValue();
+        }
+    } else {
+        reserve(data, sizeof(quint32) + length * sizeof(double));
+        push(data, valueheader(WorkerNumberArray, length));
+        int offset = data.size();
+        data.resize(offset + length * sizeof(double));
+        double *buffer = reinterpret_cast<double *>(data.data() + offset);
+        for (uint32_t ii = 0; ii < length; ++ii) {
+            val = arrayData->get(ii);
+            buffer[ii] = val->toNumber();
+        }
+    }
+    return true;
+}
+
 // XXX TODO: Check that worker script is exception safe in the case of
 // serialization/deserialization failures
 
 #define ALIGN(size) (((size) + 3) & ~3)
-void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *engine)
+void Serialize::serialize(Message &message, const QV4::ValueRef v, QV8Engine *engine)
 {
     QV4::ExecutionEngine *v4 = QV8Engine::getV4(engine);
     QV4::Scope scope(v4);
+    QByteArray &data = message.data;
 
     if (v->isEmpty()) {
         Q_ASSERT(!"Serialize: got empty value");
@@ -163,8 +212,13 @@ void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *en
     } else if (v->isString()) {
         const QString &qstr = v->toQString();
         int length = qstr.length();
-        if (length > 0xFFFFFF) {
-            push(data, valueheader(WorkerUndefined));
+        if (length > SharedStringLength) {
+            if (message.strings.size() > 0xFFFFFF) {
+                push(data, valueheader(WorkerUndefined));
+                return;
+            }
+            push(data, valueheader(WorkerSharedString, message.strings.size()));
+            message.strings.append(qstr);
             return;
         }
         int utf16size = ALIGN(length * sizeof(uint16_t));
@@ -188,11 +242,13 @@ void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *en
             push(data, valueheader(WorkerUndefined));
             return;
         }
+        if (serializeNumberArray(data, array.getPointer(), length, scope))
+            return;
         reserve(data, sizeof(quint32) + length * sizeof(quint32));
         push(data, valueheader(WorkerArray, length));
         ScopedValue val(scope);
         for (uint32_t ii = 0; ii < length; ++ii)
-            serialize(data, (val = array->getIndexed(ii)), engine);
+            serialize(message, (val = array->getIndexed(ii)), engine);
     } else if (v->isInteger()) {
         reserve(data, 2 * sizeof(quint32));
         push(data, valueheader(WorkerInt32));
@@ -255,10 +311,10 @@ void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *en
             }
             reserve(data, sizeof(quint32) + length * sizeof(quint32));
             push(data, valueheader(WorkerSequence, length));
-            serialize(data, QV4::Primitive::fromInt32(QV4::SequencePrototype::metaTypeForSequence(o)), engine); // sequence type
+            serialize(message, QV4::Primitive::fromInt32(QV4::SequencePrototype::metaTypeForSequence(o)), engine); // sequence type
             ScopedValue val(scope);
             for (uint32_t ii = 0; ii < seqLength; ++ii)
-                serialize(data, (val = o->getIndexed(ii)), engine); // sequence elements
+                serialize(message, (val = o->getIndexed(ii)), engine); // sequence elements
 
             return;
         }
@@ -277,7 +333,7 @@ void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *en
         QV4::ScopedString str(scope);
         for (quint32 ii = 0; ii < length; ++ii) {
             s = properties->getIndexed(ii);
-            serialize(data, s, engine);
+            serialize(message, s, engine);
 
             QV4::ExecutionContext *ctx = v4->currentContext();
             str = s;
@@ -285,7 +341,7 @@ void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *en
             if (scope.hasException())
                 ctx->catchException();
 
-            serialize(data, val, engine);
+            serialize(message, val, engine);
         }
         return;
     } else {
@@ -293,7 +349,7 @@ void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *en
     }
 }
 
-ReturnedValue Serialize::deserialize(const char *&data, QV8Engine *engine)
+ReturnedValue Serialize::deserialize(const char *&data, const Message &message, QV8Engine *engine)
 {
     quint32 header = popUint32(data);
     Type type = headertype(header);
@@ -317,6 +373,8 @@ ReturnedValue Serialize::deserialize(const char *&data, QV8Engine *engine)
         data += ALIGN(size * sizeof(uint16_t));
         return QV4::Encode(v4->newString(qstr));
     }
+    case WorkerSharedString:
+        return QV4::Encode(v4->newString(message.strings.at(headersize(header))));
     case WorkerFunction:
         Q_ASSERT(!"Unreachable");
         break;
@@ -324,11 +382,39 @@ ReturnedValue Serialize::deserialize(const char *&data, QV8Engine *engine)
     {
         quint32 size = headersize(header);
         Scoped<ArrayObject> a(scope, v4->newArrayObject());
+        a->arrayReserve(size);
+        ScopedValue v(scope);
+        for (quint32 ii = 0; ii < size; ++ii) {
+            v = deserialize(data, message, engine);
+            a->arrayPut(ii, v);
+        }
+        a->setArrayLengthUnchecked(size);
+        return a.asReturnedValue();
+    }
+    case WorkerInt32Array:
+    {
+        quint32 size = headersize(header);
+        Scoped<ArrayObject> a(scope, v4->newArrayObject());
+        a->arrayReserve(size);
         ScopedValue v(scope);
         for (quint32 ii = 0; ii < size; ++ii) {
-            v = deserialize(data, engine);
-            a->putIndexed(ii, v);
+            v = QV4::Primitive::fromInt32((qint32)popUint32(data));
+            a->arrayPut(ii, v);
         }
+        a->setArrayLengthUnchecked(size);
+        return a.asReturnedValue();
+    }
+    case WorkerNumberArray:
+    {
+        quint32 size = headersize(header);
+        Scoped<ArrayObject> a(scope, v4->newArrayObject());
+        a->arrayReserve(size);
+        ScopedValue v(scope);
+        for (quint32 ii = 0; ii < size; ++ii) {
+            v = QV4::Primitive::fromDouble(popDouble(data));
+            a->arrayPut(ii, v);
+        }
+        a->setArrayLengthUnchecked(size);
         return a.asReturnedValue();
     }
     case WorkerObject:
@@ -339,8 +425,8 @@ ReturnedValue Serialize::deserialize(const char *&data, QV8Engine *engine)
         ScopedString n(scope);
         ScopedValue value(scope);
         for (quint32 ii = 0; ii < size; ++ii) {
-            name = deserialize(data, engine);
-            value = deserialize(data, engine);
+            name = deserialize(data, message, engine);
+            value = deserialize(data, message, engine);
             n = name.asReturnedValue();
             o->put(n, value);
         }
@@ -366,6 +452,11 @@ ReturnedValue Serialize::deserialize(const char *&data, QV8Engine *engine)
     {
         void *ptr = popPtr(data);
         QQmlListModelWorkerAgent *agent = (QQmlListModelWorkerAgent *)ptr;
+        if (!agent->setV8Engine(engine)) {
+            qWarning("ListModel: a model can only be shared by WorkerScripts running on the same thread");
+            agent->release();
+            return QV4::Encode::undefined();
+        }
         QV4::ScopedValue rv(scope, QV4::QObjectWrapper::wrap(v4, agent));
         // ### Find a better solution then the ugly property
         QQmlListModelWorkerAgent::VariantRef ref(agent);
@@ -375,7 +466,6 @@ ReturnedValue Serialize::deserialize(const char *&data, QV8Engine *engine)
         rv->asObject()->defineReadonlyProperty(s, v);
 
         agent->release();
-        agent->setV8Engine(engine);
         return rv.asReturnedValue();
     }
     case WorkerSequence:
@@ -384,12 +474,12 @@ ReturnedValue Serialize::deserialize(const char *&data, QV8Engine *engine)
         bool succeeded = false;
         quint32 length = headersize(header);
         quint32 seqLength = length - 1;
-        value = deserialize(data, engine);
+        value = deserialize(data, message, engine);
         int sequenceType = value->integerValue();
         Scoped<ArrayObject> array(scope, v4->newArrayObject());
         array->arrayReserve(seqLength);
         for (quint32 ii = 0; ii < seqLength; ++ii) {
-            value = deserialize(data, engine);
+            value = deserialize(data, message, engine);
             array->arrayPut(ii, value);
         }
         array->setArrayLengthUnchecked(seqLength);
@@ -401,17 +491,17 @@ ReturnedValue Serialize::deserialize(const char *&data, QV8Engine *engine)
     return QV4::Encode::undefined();
 }
 
-QByteArray Serialize::serialize(const QV4::ValueRef value, QV8Engine *engine)
+Serialize::Message Serialize::serialize(const QV4::ValueRef value, QV8Engine *engine)
 {
-    QByteArray rv;
+    Message rv;
     serialize(rv, value, engine);
     return rv;
 }
 
-ReturnedValue Serialize::deserialize(const QByteArray &data, QV8Engine *engine)
+ReturnedValue Serialize::deserialize(const Message &message, QV8Engine *engine)
 {
-    const char *stream = data.constData();
-    return deserialize(stream, engine);
+    const char *stream = message.data.constData();
+    return deserialize(stream, message, engine);
 }
 
 QT_END_NAMESPACE
@@ -54,6 +54,7 @@
 //
 
 #include <QtCore/qbytearray.h>
+#include <QtCore/qvector.h>
 #include <private/qv4value_inl_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -64,13 +65,18 @@ namespace QV4 {
 
 class Serialize {
 public:
+    struct Message {
+        QByteArray data;
+        // Long strings are shared with the receiving engine rather than copied
+        QVector<QString> strings;
+    };
 
-    static QByteArray serialize(const ValueRef, QV8Engine *);
-    static ReturnedValue deserialize(const QByteArray &, QV8Engine *);
+    static Message serialize(const ValueRef, QV8Engine *);
+    static ReturnedValue deserialize(const Message &, QV8Engine *);
 
 private:
-    static void serialize(QByteArray &, const ValueRef, QV8Engine *);
-    static ReturnedValue deserialize(const char *&, QV8Engine *);
+    static void serialize(Message &, const ValueRef, QV8Engine *);
+    static ReturnedValue deserialize(const char *&, const Message &, QV8Engine *);
 };
 
 }
@@ -0,0 +1,645 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qv4typedarray_p.h"
+#include "qv4arraybuffer_p.h"
+#include "qv4objectiterator_p.h"
+#include "qv4scopedvalue_p.h"
+
+#include <QtCore/qnumeric.h>
+
+#include <cmath>
+
+using namespace QV4;
+
+DEFINE_OBJECT_VTABLE(TypedArrayCtor);
+DEFINE_OBJECT_VTABLE(TypedArray);
+
+template <typename T>
+ReturnedValue read(const char *data);
+
+template <>
+ReturnedValue read<qint8>(const char *data)
+{
+    return Encode((int)*(const qint8 *)data);
+}
+
+template <>
+ReturnedValue read<quint8>(const char *data)
+{
+    return Encode((int)*(const quint8 *)data);
+}
+
+template <>
+ReturnedValue read<qint16>(const char *data)
+{
+    return Encode((int)*(const qint16 *)data);
+}
+
+template <>
+ReturnedValue read<quint16>(const char *data)
+{
+    return Encode((int)*(const quint16 *)data);
+}
+
+template <>
+ReturnedValue read<qint32>(const char *data)
+{
+    return Encode(*(const qint32 *)data);
+}
+
+template <>
+ReturnedValue read<quint32>(const char *data)
+{
+    return Encode(*(const quint32 *)data);
+}
+
+template <>
+ReturnedValue read<float>(const char *data)
+{
+    return Encode((double)*(const float *)data);
+}
+
+template <>
+ReturnedValue read<double>(const char *data)
+{
+    return Encode(*(const double *)data);
+}
+
+template <typename T>
+void write(ExecutionEngine *e, char *data, const ValueRef value);
+
+template <>
+void write<qint8>(ExecutionEngine *e, char *data, const ValueRef value)
+{
+    signed char v = (signed char)value->toInt32();
+    if (e->hasException)
+        return;
+    *(signed char *)data = v;
+}
+
+template <>
+void write<quint8>(ExecutionEngine *e, char *data, const ValueRef value)
+{
+    unsigned char v = (unsigned char)value->toUInt32();
+    if (e->hasException)
+        return;
+    *(unsigned char *)data = v;
+}
+
+// Uint8ClampedArray rounds half to even and saturates, as canvas pixel data does.
+static void writeUInt8Clamped(ExecutionEngine *e, char *data, const ValueRef value)
+{
+    if (value->isInteger()) {
+        *(unsigned char *)data = (unsigned char)qBound(0, value->integerValue(), 255);
+        return;
+    }
+    double d = value->toNumber();
+    if (e->hasException)
+        return;
+    if (std::isnan(d) || d < 0) {
+        *(unsigned char *)data = 0;
+        return;
+    }
+    if (d > 255) {
+        *(unsigned char *)data = 255;
+        return;
+    }
+    double f = std::floor(d);
+    if (f + 0.5 < d) {
+        *(unsigned char *)data = (unsigned char)(f + 1);
+        return;
+    }
+    if (d < f + 0.5) {
+        *(unsigned char *)data = (unsigned char)(f);
+        return;
+    }
+    if (int(f) % 2)
+        // odd number
+        *(unsigned char *)data = (unsigned char)(f + 1);
+    else
+        *(unsigned char *)data = (unsigned char)(f);
+}
+
+template <>
+void write<qint16>(ExecutionEngine *e, char *data, const ValueRef value)
+{
+    short v = (short)value->toInt32();
+    if (e->hasException)
+        return;
+    *(short *)data = v;
+}
+
+template <>
+void write<quint16>(ExecutionEngine *e, char *data, const ValueRef value)
+{
+    unsigned short v = (unsigned short)value->toInt32();
+    if (e->hasException)
+        return;
+    *(unsigned short *)data = v;
+}
+
+template <>
+void write<qint32>(ExecutionEngine *e, char *data, const ValueRef value)
+{
+    int v = (int)value->toInt32();
+    if (e->hasException)
+        return;
+    *(int *)data = v;
+}
+
+template <>
+void write<quint32>(ExecutionEngine *e, char *data, const ValueRef value)
+{
+    unsigned int v = (unsigned int)value->toUInt32();
+    if (e->hasException)
+        return;
+    *(unsigned int *)data = v;
+}
+
+template <>
+void write<float>(ExecutionEngine *e, char *data, const ValueRef value)
+{
+    float v = value->toNumber();
+    if (e->hasException)
+        return;
+    *(float *)data = v;
+}
+
+template <>
+void write<double>(ExecutionEngine *e, char *data, const ValueRef value)
+{
+    double v = value->toNumber();
+    if (e->hasException)
+        return;
+    *(double *)data = v;
+}
+
+const TypedArrayOperations QV4::operations[NTypedArrayTypes] = {
+    { 1, "Int8Array", read<qint8>, write<qint8> },
+    { 1, "Uint8Array", read<quint8>, write<quint8> },
+    { 1, "Uint8ClampedArray", read<quint8>, writeUInt8Clamped },
+    { 2, "Int16Array", read<qint16>, write<qint16> },
+    { 2, "Uint16Array", read<quint16>, write<quint16> },
+    { 4, "Int32Array", read<qint32>, write<qint32> },
+    { 4, "Uint32Array", read<quint32>, write<quint32> },
+    { 4, "Float32Array", read<float>, write<float> },
+    { 8, "Float64Array", read<double>, write<double> },
+};
+
+
+TypedArrayCtor::TypedArrayCtor(ExecutionContext *scope, TypedArrayType t)
+    : FunctionObject(scope, QLatin1String(operations[t].name))
+    , type(t)
+{
+    setVTable(staticVTable());
+}
+
+ReturnedValue TypedArrayCtor::construct(Managed *m, CallData *callData)
+{
+    ExecutionEngine *v4 = m->engine();
+    Scope scope(v4);
+    Scoped<TypedArrayCtor> that(scope, static_cast<TypedArrayCtor *>(m));
+
+    if (!callData->argc || !callData->args[0].isObject()) {
+        // ECMA 6 22.2.1.1
+        double l = callData->argc ? callData->args[0].toNumber() : 0;
+        if (scope.engine->hasException)
+            return Encode::undefined();
+        uint len = (uint)l;
+        if (l != len)
+            return scope.engine->currentContext()->throwRangeError(QStringLiteral("Non integer length for typed array."));
+        uint byteLength = len * operations[that->type].bytesPerElement;
+        if (byteLength / operations[that->type].bytesPerElement != len || byteLength > INT_MAX)
+            return scope.engine->currentContext()->throwRangeError(QStringLiteral("Typed array length too large."));
+        Scoped<ArrayBuffer> buffer(scope, scope.engine->newArrayBuffer(byteLength));
+        if (scope.engine->hasException)
+            return Encode::undefined();
+
+        Scoped<TypedArray> array(scope, new (scope.engine->memoryManager) TypedArray(scope.engine, that->type));
+        array->buffer = buffer.getPointer();
+        array->byteLength = byteLength;
+        array->byteOffset = 0;
+
+        return array.asReturnedValue();
+    }
+    Scoped<TypedArray> typedArray(scope, callData->argument(0));
+    if (!!typedArray) {
+        // ECMA 6 22.2.1.2
+        Scoped<ArrayBuffer> buffer(scope, typedArray->buffer);
+        uint srcElementSize = typedArray->type->bytesPerElement;
+        uint destElementSize = operations[that->type].bytesPerElement;
+        uint byteLength = typedArray->byteLength;
+        uint destByteLength = byteLength * destElementSize / srcElementSize;
+
+        Scoped<ArrayBuffer> newBuffer(scope, scope.engine->newArrayBuffer(destByteLength));
+        if (scope.engine->hasException)
+            return Encode::undefined();
+
+        Scoped<TypedArray> array(scope, new (scope.engine->memoryManager) TypedArray(scope.engine, that->type));
+        array->buffer = newBuffer.getPointer();
+        array->byteLength = destByteLength;
+        array->byteOffset = 0;
+
+        const char *src = buffer->constData() + typedArray->byteOffset;
+        char *dest = newBuffer->data();
+
+        // check if src and new type have the same size. In that case we can simply memcpy the data
+        if (srcElementSize == destElementSize) {
+            memcpy(dest, src, byteLength);
+        } else {
+            // not same size, we need to loop
+            uint l = typedArray->length();
+            TypedArrayRead read = typedArray->type->read;
+            TypedArrayWrite write = array->type->write;
+            ScopedValue val(scope);
+            for (uint i = 0; i < l; ++i) {
+                val = read(src + i * srcElementSize);
+                write(scope.engine, dest + i * destElementSize, val);
+            }
+        }
+
+        return array.asReturnedValue();
+    }
+    Scoped<ArrayBuffer> buffer(scope, callData->argument(0));
+    if (!!buffer) {
+        // ECMA 6 22.2.1.4
+
+        double dbyteOffset = callData->argc > 1 ? callData->args[1].toInteger() : 0;
+        uint byteOffset = (uint)dbyteOffset;
+        uint elementSize = operations[that->type].bytesPerElement;
+        if (dbyteOffset < 0 || (byteOffset % elementSize) || dbyteOffset > buffer->byteLength())
+            return scope.engine->currentContext()->throwRangeError(QStringLiteral("new TypedArray: invalid byteOffset"));
+
+        uint byteLength;
+        if (callData->argc < 3 || callData->args[2].isUndefined()) {
+            byteLength = buffer->byteLength() - byteOffset;
+            if (buffer->byteLength() < byteOffset || byteLength % elementSize)
+                return scope.engine->currentContext()->throwRangeError(QStringLiteral("new TypedArray: invalid length"));
+        } else {
+            double l = qBound(0., callData->args[2].toInteger(), (double)UINT_MAX);
+            if (scope.engine->hasException)
+                return Encode::undefined();
+            l *= elementSize;
+            if (buffer->byteLength() - byteOffset < l)
+                return scope.engine->currentContext()->throwRangeError(QStringLiteral("new TypedArray: invalid length"));
+            byteLength = (uint)l;
+        }
+
+        Scoped<TypedArray> array(scope, new (scope.engine->memoryManager) TypedArray(scope.engine, that->type));
+        array->buffer = buffer.getPointer();
+        array->byteLength = byteLength;
+        array->byteOffset = byteOffset;
+        return array.asReturnedValue();
+    }
+
+    // ECMA 6 22.2.1.3
+
+    ScopedObject o(scope, callData->argument(0));
+    uint l = (uint) qBound(0., ScopedValue(scope, o->get(scope.engine->id_length))->toInteger(), (double)UINT_MAX);
+    if (scope.engine->hasException)
+        return scope.engine->currentContext()->throwTypeError();
+
+    uint elementSize = operations[that->type].bytesPerElement;
+    if (l > (uint)INT_MAX / elementSize)
+        return scope.engine->currentContext()->throwRangeError(QStringLiteral("new TypedArray: invalid length"));
+    Scoped<ArrayBuffer> newBuffer(scope, scope.engine->newArrayBuffer(l * elementSize));
+    if (scope.engine->hasException)
+        return Encode::undefined();
+
+    Scoped<TypedArray> array(scope, new (scope.engine->memoryManager) TypedArray(scope.engine, that->type));
+    array->buffer = newBuffer.getPointer();
+    array->byteLength = l * elementSize;
+    array->byteOffset = 0;
+
+    uint idx = 0;
+    char *b = newBuffer->data();
+    ScopedValue val(scope);
+    while (idx < l) {
+        val = o->getIndexed(idx);
+        array->type->write(scope.engine, b, val);
+        if (scope.engine->hasException)
+            return Encode::undefined();
+        ++idx;
+        b += elementSize;
+    }
+
+
+    return array.asReturnedValue();
+}
+
+ReturnedValue TypedArrayCtor::call(Managed *that, CallData *)
+{
+    return that->engine()->currentContext()->throwTypeError();
+}
+
+TypedArray::TypedArray(ExecutionEngine *e, TypedArrayType t)
+    : Object(e->typedArrayClasses[t])
+    , arrayType(t)
+    , type(operations + t)
+    , buffer(0)
+    , byteLength(0)
+    , byteOffset(0)
+{
+    setArrayType(ArrayData::Custom);
+}
+
+const char *TypedArray::constData() const
+{
+    return buffer->constData() + byteOffset;
+}
+
+char *TypedArray::data()
+{
+    return buffer->data() + byteOffset;
+}
+
+void TypedArray::destroy(Managed *m)
+{
+    static_cast<TypedArray *>(m)->~TypedArray();
+}
+
+void TypedArray::markObjects(Managed *that, ExecutionEngine *e)
+{
+    TypedArray *a = static_cast<TypedArray *>(that);
+    if (a->buffer)
+        a->buffer->mark(e);
+    Object::markObjects(that, e);
+}
+
+ReturnedValue TypedArray::getIndexed(Managed *m, uint index, bool *hasProperty)
+{
+    TypedArray *a = static_cast<TypedArray *>(m);
+    if (index >= a->length()) {
+        if (hasProperty)
+            *hasProperty = false;
+        return Encode::undefined();
+    }
+
+    if (hasProperty)
+        *hasProperty = true;
+    return a->readElement(index);
+}
+
+void TypedArray::putIndexed(Managed *m, uint index, const ValueRef value)
+{
+    TypedArray *a = static_cast<TypedArray *>(m);
+    // Writes past the end are dropped, as the length of a typed array is fixed.
+    if (index >= a->length())
+        return;
+
+    a->writeElement(index, value);
+}
+
+PropertyAttributes TypedArray::queryIndexed(const Managed *m, uint index)
+{
+    const TypedArray *a = static_cast<const TypedArray *>(m);
+    return index < a->length() ? Attr_NotConfigurable : Attr_Invalid;
+}
+
+bool TypedArray::deleteIndexedProperty(Managed *m, uint index)
+{
+    return index >= static_cast<TypedArray *>(m)->length();
+}
+
+uint TypedArray::getLength(const Managed *m)
+{
+    return static_cast<const TypedArray *>(m)->length();
+}
+
+void TypedArray::advanceIterator(Managed *m, ObjectIterator *it, StringRef name, uint *index, Property *p, PropertyAttributes *attrs)
+{
+    TypedArray *a = static_cast<TypedArray *>(m);
+    name = (String *)0;
+    *index = UINT_MAX;
+
+    if (it->arrayIndex < a->length()) {
+        *index = it->arrayIndex;
+        ++it->arrayIndex;
+        *attrs = Attr_NotConfigurable;
+        p->value = a->readElement(*index);
+        return;
+    }
+    Object::advanceIterator(m, it, name, index, p, attrs);
+}
+
+void TypedArrayPrototype::init(ExecutionEngine *engine, ObjectRef ctor)
+{
+    Scope scope(engine);
+    ScopedObject o(scope);
+
+    ctor->defineReadonlyProperty(engine->id_length, Primitive::fromInt32(3));
+    ctor->defineReadonlyProperty(engine->id_prototype, (o = this));
+    ctor->defineReadonlyProperty(QStringLiteral("BYTES_PER_ELEMENT"), Primitive::fromInt32(operations[type].bytesPerElement));
+    defineDefaultProperty(engine->id_constructor, (o = ctor));
+    defineAccessorProperty(QStringLiteral("buffer"), method_get_buffer, 0);
+    defineAccessorProperty(QStringLiteral("byteLength"), method_get_byteLength, 0);
+    defineAccessorProperty(QStringLiteral("byteOffset"), method_get_byteOffset, 0);
+    defineAccessorProperty(QStringLiteral("length"), method_get_length, 0);
+    defineReadonlyProperty(QStringLiteral("BYTES_PER_ELEMENT"), Primitive::fromInt32(operations[type].bytesPerElement));
+
+    defineDefaultProperty(QStringLiteral("set"), method_set, 1);
+    defineDefaultProperty(QStringLiteral("subarray"), method_subarray, 2);
+}
+
+ReturnedValue TypedArrayPrototype::method_get_buffer(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<TypedArray> v(scope, ctx->callData->thisObject);
+    if (!v)
+        return ctx->throwTypeError();
+
+    return v->buffer->asReturnedValue();
+}
+
+ReturnedValue TypedArrayPrototype::method_get_byteLength(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<TypedArray> v(scope, ctx->callData->thisObject);
+    if (!v)
+        return ctx->throwTypeError();
+
+    return Encode(v->byteLength);
+}
+
+ReturnedValue TypedArrayPrototype::method_get_byteOffset(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<TypedArray> v(scope, ctx->callData->thisObject);
+    if (!v)
+        return ctx->throwTypeError();
+
+    return Encode(v->byteOffset);
+}
+
+ReturnedValue TypedArrayPrototype::method_get_length(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<TypedArray> v(scope, ctx->callData->thisObject);
+    if (!v)
+        return ctx->throwTypeError();
+
+    return Encode(v->length());
+}
+
+ReturnedValue TypedArrayPrototype::method_set(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<TypedArray> a(scope, ctx->callData->thisObject);
+    if (!a)
+        return ctx->throwTypeError();
+    Scoped<ArrayBuffer> buffer(scope, a->buffer);
+
+    double doffset = ctx->callData->argc >= 2 ? ctx->callData->args[1].toInteger() : 0;
+    if (scope.engine->hasException)
+        return Encode::undefined();
+
+    if (doffset < 0 || doffset >= UINT_MAX)
+        return ctx->throwRangeError(QStringLiteral("TypedArray.set: out of range"));
+    uint offset = (uint)doffset;
+    uint elementSize = a->type->bytesPerElement;
+
+    ScopedValue source(scope, ctx->argument(0));
+    Scoped<TypedArray> srcTypedArray(scope, source);
+    if (!srcTypedArray) {
+        // src is a normal array
+        ScopedObject o(scope, source->toObject(ctx));
+        if (scope.engine->hasException || !o)
+            return ctx->throwTypeError();
+
+        double len = ScopedValue(scope, o->get(scope.engine->id_length))->toNumber();
+        uint l = (uint)len;
+        if (scope.engine->hasException || l != len)
+            return ctx->throwTypeError();
+
+        if (offset + l > a->length())
+            return ctx->throwRangeError(QStringLiteral("TypedArray.set: out of range"));
+
+        uint idx = 0;
+        char *b = a->data() + offset * elementSize;
+        ScopedValue val(scope);
+        while (idx < l) {
+            val = o->getIndexed(idx);
+            a->type->write(scope.engine, b, val);
+            if (scope.engine->hasException)
+                return Encode::undefined();
+            ++idx;
+            b += elementSize;
+        }
+        return Encode::undefined();
+    }
+
+    // src is a typed array
+    Scoped<ArrayBuffer> srcBuffer(scope, srcTypedArray->buffer);
+    uint l = srcTypedArray->length();
+    if (offset + l > a->length())
+        return ctx->throwRangeError(QStringLiteral("TypedArray.set: out of range"));
+
+    char *dest = a->data() + offset * elementSize;
+    const char *src = srcTypedArray->constData();
+    if (srcTypedArray->type == a->type) {
+        // same type of typed arrays, use memmove (as srcbuffer and buffer could be the same)
+        memmove(dest, src, srcTypedArray->byteLength);
+        return Encode::undefined();
+    }
+
+    char *srcCopy = 0;
+    if (srcBuffer.getPointer() == buffer.getPointer()) {
+        // same buffer, need to take a temporary copy, to not run into problems
+        srcCopy = new char[srcTypedArray->byteLength];
+        memcpy(srcCopy, src, srcTypedArray->byteLength);
+        src = srcCopy;
+    }
+
+    // typed arrays of different kind, need to manually loop
+    uint srcElementSize = srcTypedArray->type->bytesPerElement;
+    TypedArrayRead read = srcTypedArray->type->read;
+    TypedArrayWrite write = a->type->write;
+    ScopedValue val(scope);
+    for (uint i = 0; i < l; ++i) {
+        val = read(src + i * srcElementSize);
+        write(scope.engine, dest + i * elementSize, val);
+    }
+
+    delete [] srcCopy;
+
+    return Encode::undefined();
+}
+
+ReturnedValue TypedArrayPrototype::method_subarray(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<TypedArray> a(scope, ctx->callData->thisObject);
+
+    if (!a)
+        return ctx->throwTypeError();
+
+    Scoped<ArrayBuffer> buffer(scope, a->buffer);
+    Q_ASSERT(buffer);
+
+    int len = a->length();
+    double b = ctx->callData->argc > 0 ? ctx->callData->args[0].toInteger() : 0;
+    if (b < 0)
+        b = len + b;
+    uint begin = (uint)qBound(0., b, (double)len);
+
+    double e = ctx->callData->argc < 2 || ctx->callData->args[1].isUndefined() ? len : ctx->callData->args[1].toInteger();
+    if (e < 0)
+        e = len + e;
+    uint end = (uint)qBound(0., e, (double)len);
+    if (end < begin)
+        end = begin;
+
+    if (scope.engine->hasException)
+        return Encode::undefined();
+
+    int newLen = end - begin;
+
+    ScopedFunctionObject constructor(scope, a->get(scope.engine->id_constructor));
+    if (!constructor)
+        return ctx->throwTypeError();
+
+    ScopedCallData callData(scope, 3);
+    callData->args[0] = buffer;
+    callData->args[1] = Primitive::fromUInt32(a->byteOffset + begin * a->type->bytesPerElement);
+    callData->args[2] = Primitive::fromInt32(newLen);
+    return constructor->construct(callData);
+}
@@ -218,6 +218,7 @@ void QQmlEnginePrivate::defineQtQuick2Module()
 
     // register the QtQuick2 types which are implemented in the QtQml module.
     registerQtQuick2Types("QtQuick",2,0);
+    qmlRegisterType<QQuickWorkerScript, 1>("QtQuick", 2, 4, "WorkerScript");
     qmlRegisterUncreatableType<QQmlLocale>("QtQuick", 2, 0, "Locale", QQmlEngine::tr("Locale cannot be instantiated.  Use Qt.locale()"));
 }
 
@@ -559,7 +560,6 @@ QQmlEnginePrivate::QQmlEnginePrivate(QQmlEngine *e)
 : propertyCapture(0), rootContext(0), isDebugging(false),
   profiler(0), outputWarningsToStdErr(true),
   cleanup(0), erroredBindings(0), inProgressCreations(0),
-  workerScriptEngine(0),
   activeObjectCreator(0),
   networkAccessManager(0), networkAccessManagerFactory(0), urlInterceptor(0),
   scarceResourcesRefCount(0), typeLoader(e), importDatabase(e), uniqueId(1),
@@ -832,12 +832,34 @@ void QQmlEnginePrivate::init()
     }
 }
 
+static int qmlWorkerScriptThreadCount()
+{
+    QByteArray env = qgetenv("QML_WORKERSCRIPT_THREADS");
+    if (!env.isEmpty())
+        return qMax(1, env.toInt());
+    return qBound(1, QThread::idealThreadCount(), 4);
+}
+
+/*
+    Worker scripts are spread over up to QML_WORKERSCRIPT_THREADS threads, each
+    with its own JavaScript engine. A new thread is only started when all the
+    existing ones already run a script.
+*/
 QQuickWorkerScriptEngine *QQmlEnginePrivate::getWorkerScriptEngine()
 {
     Q_Q(QQmlEngine);
-    if (!workerScriptEngine)
-        workerScriptEngine = new QQuickWorkerScriptEngine(q);
-    return workerScriptEngine;
+    QQuickWorkerScriptEngine *leastBusy = 0;
+    foreach (QQuickWorkerScriptEngine *engine, workerScriptEngines) {
+        if (!leastBusy || engine->workerScriptCount() < leastBusy->workerScriptCount())
+            leastBusy = engine;
+    }
+
+    if (!leastBusy || (leastBusy->workerScriptCount() > 0
+                       && workerScriptEngines.count() < qmlWorkerScriptThreadCount())) {
+        leastBusy = new QQuickWorkerScriptEngine(q);
+        workerScriptEngines.append(leastBusy);
+    }
+    return leastBusy;
 }
 
 /*!
@@ -163,7 +163,7 @@ public:
     QV4::ExecutionEngine *v4engine() const { return QV8Engine::getV4(q_func()->handle()); }
 
     QQuickWorkerScriptEngine *getWorkerScriptEngine();
-    QQuickWorkerScriptEngine *workerScriptEngine;
+    QList<QQuickWorkerScriptEngine *> workerScriptEngines;
 
     QUrl baseUrl;
 
@@ -52,6 +52,7 @@
 #include <private/qv4domerrors_p.h>
 #include <private/qv4engine_p.h>
 #include <private/qv4functionobject_p.h>
+#include <private/qv4arraybuffer_p.h>
 #include <private/qqmlcontextwrapper_p.h>
 #include <private/qv4scopedvalue_p.h>
 
@@ -1075,7 +1076,11 @@ public:
 
     QString responseBody();
     const QByteArray & rawResponseBody() const;
+    ReturnedValue arrayBufferResponse();
     bool receivedXml() const;
+
+    const QString & responseType() const;
+    void setResponseType(const QString &);
 private slots:
     void readyRead();
     void error(QNetworkReply::NetworkError);
@@ -1093,6 +1098,7 @@ private:
     QByteArray m_responseEntityBody;
     QByteArray m_data;
     int m_redirectCount;
+    QString m_responseType;
 
     typedef QPair<QByteArray, QByteArray> HeaderPair;
     typedef QList<HeaderPair> HeadersList;
@@ -1111,6 +1117,7 @@ private:
     ReturnedValue getMe() const;
     void setMe(const ValueRef me);
     PersistentValue m_me;
+    PersistentValue m_arrayBufferResponse;
 
     void dispatchCallbackImpl(const ValueRef me);
     void dispatchCallback(const ValueRef me);
@@ -1169,6 +1176,7 @@ ReturnedValue QQmlXMLHttpRequest::open(const ValueRef me, const QString &method,
     m_sendFlag = false;
     m_errorFlag = false;
     m_responseEntityBody = QByteArray();
+    m_arrayBufferResponse.clear();
     m_method = method;
     m_url = url;
     m_state = Opened;
@@ -1306,6 +1314,7 @@ ReturnedValue QQmlXMLHttpRequest::abort(const ValueRef me)
 {
     destroyNetwork();
     m_responseEntityBody = QByteArray();
+    m_arrayBufferResponse.clear();
     m_errorFlag = true;
     m_request = QNetworkRequest();
 
@@ -1540,6 +1549,24 @@ const QByteArray &QQmlXMLHttpRequest::rawResponseBody() const
     return m_responseEntityBody;
 }
 
+// Every read of response returns the same buffer until the next open() or abort().
+ReturnedValue QQmlXMLHttpRequest::arrayBufferResponse()
+{
+    if (m_arrayBufferResponse.isUndefined())
+        m_arrayBufferResponse = v4->newArrayBuffer(m_responseEntityBody);
+    return m_arrayBufferResponse.value();
+}
+
+const QString &QQmlXMLHttpRequest::responseType() const
+{
+    return m_responseType;
+}
+
+void QQmlXMLHttpRequest::setResponseType(const QString &responseType)
+{
+    m_responseType = responseType;
+}
+
 void QQmlXMLHttpRequest::dispatchCallbackImpl(const ValueRef me)
 {
     ExecutionContext *ctx = v4->currentContext();
@@ -1691,6 +1718,9 @@ struct QQmlXMLHttpRequestCtor : public FunctionObject
     static ReturnedValue method_get_statusText(CallContext *ctx);
     static ReturnedValue method_get_responseText(CallContext *ctx);
     static ReturnedValue method_get_responseXML(CallContext *ctx);
+    static ReturnedValue method_get_response(CallContext *ctx);
+    static ReturnedValue method_get_responseType(CallContext *ctx);
+    static ReturnedValue method_set_responseType(CallContext *ctx);
 
 
     Object *proto;
@@ -1719,6 +1749,10 @@ void QQmlXMLHttpRequestCtor::setupProto()
     proto->defineAccessorProperty(QStringLiteral("statusText"),method_get_statusText, 0);
     proto->defineAccessorProperty(QStringLiteral("responseText"),method_get_responseText, 0);
     proto->defineAccessorProperty(QStringLiteral("responseXML"),method_get_responseXML, 0);
+    proto->defineAccessorProperty(QStringLiteral("response"),method_get_response, 0);
+
+    // Read-write properties
+    proto->defineAccessorProperty(QStringLiteral("responseType"),method_get_responseType, method_set_responseType);
 
     // State values
     proto->defineReadonlyProperty(QStringLiteral("UNSENT"), Primitive::fromInt32(0));
@@ -1987,6 +2021,64 @@ ReturnedValue QQmlXMLHttpRequestCtor::method_get_responseXML(CallContext *ctx)
     }
 }
 
+ReturnedValue QQmlXMLHttpRequestCtor::method_get_response(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<QQmlXMLHttpRequestWrapper> w(scope, ctx->callData->thisObject.as<QQmlXMLHttpRequestWrapper>());
+    if (!w)
+        V4THROW_REFERENCE("Not an XMLHttpRequest object");
+    QQmlXMLHttpRequest *r = w->request;
+
+    if (r->responseType() == QLatin1String("arraybuffer")) {
+        // The buffer shares the body with the request, so no copy is made
+        // unless script code writes into it. It is created once per response.
+        if (r->readyState() != QQmlXMLHttpRequest::Done)
+            return Encode::null();
+        return r->arrayBufferResponse();
+    }
+
+    if (r->readyState() != QQmlXMLHttpRequest::Loading &&
+        r->readyState() != QQmlXMLHttpRequest::Done)
+        return ctx->engine->v8Engine->toString(QString());
+    else
+        return ctx->engine->v8Engine->toString(r->responseBody());
+}
+
+ReturnedValue QQmlXMLHttpRequestCtor::method_get_responseType(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<QQmlXMLHttpRequestWrapper> w(scope, ctx->callData->thisObject.as<QQmlXMLHttpRequestWrapper>());
+    if (!w)
+        V4THROW_REFERENCE("Not an XMLHttpRequest object");
+    QQmlXMLHttpRequest *r = w->request;
+    return ctx->engine->v8Engine->toString(r->responseType());
+}
+
+ReturnedValue QQmlXMLHttpRequestCtor::method_set_responseType(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<QQmlXMLHttpRequestWrapper> w(scope, ctx->callData->thisObject.as<QQmlXMLHttpRequestWrapper>());
+    if (!w)
+        V4THROW_REFERENCE("Not an XMLHttpRequest object");
+    QQmlXMLHttpRequest *r = w->request;
+
+    if (ctx->callData->argc < 1)
+        V4THROW_DOM(DOMEXCEPTION_SYNTAX_ERR, "Incorrect argument count");
+
+    if (r->readyState() == QQmlXMLHttpRequest::Loading ||
+        r->readyState() == QQmlXMLHttpRequest::Done)
+        V4THROW_DOM(DOMEXCEPTION_INVALID_STATE_ERR, "Invalid state");
+
+    // Unsupported response types are ignored, as the specification requires.
+    QString responseType = ctx->callData->args[0].toQStringNoThrow();
+    if (responseType.isEmpty()
+            || responseType == QLatin1String("text")
+            || responseType == QLatin1String("arraybuffer"))
+        r->setResponseType(responseType);
+
+    return Encode::undefined();
+}
+
 void qt_rem_qmlxmlhttprequest(QV8Engine * /* engine */, void *d)
 {
     QQmlXMLHttpRequestData *data = (QQmlXMLHttpRequestData *)d;
@@ -61,6 +61,8 @@
 #include <QXmlStreamReader>
 #include <QtCore/qdatetime.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 // Set to 1024 as a debugging aid - easier to distinguish uids from indices of elements/models.
@@ -248,6 +250,24 @@ const ListLayout::Role *ListLayout::getExistingRole(const QV4::StringRef key)
     return r;
 }
 
+// Returns the role type a JS value is stored as, or Invalid for null and undefined
+ListLayout::Role::DataType ListLayout::roleType(const QV4::ValueRef value)
+{
+    if (value->isString())
+        return Role::String;
+    if (value->isNumber())
+        return Role::Number;
+    if (value->asArrayObject())
+        return Role::List;
+    if (value->isBoolean())
+        return Role::Bool;
+    if (value->asDateObject())
+        return Role::DateTime;
+    if (QV4::Object *o = value->asObject())
+        return o->as<QV4::QObjectWrapper>() ? Role::QObject : Role::VariantMap;
+    return Role::Invalid;
+}
+
 ModelObject *ListModel::getOrCreateModelObject(QQmlListModel *model, int elementIndex)
 {
     ListElement *e = elements[elementIndex];
@@ -496,62 +516,17 @@ void ListModel::set(int elementIndex, QV4::ObjectRef object, QV8Engine *eng)
     QV4::ObjectIterator it(scope, object, QV4::ObjectIterator::WithProtoChain|QV4::ObjectIterator::EnumerableOnly);
     QV4::Scoped<QV4::String> propertyName(scope);
     QV4::ScopedValue propertyValue(scope);
-    QV4::ScopedObject o(scope);
-    QV4::ScopedArrayObject a(scope);
-    QV4::Scoped<QV4::DateObject> date(scope);
     while (1) {
         propertyName = it.nextPropertyNameAsString(propertyValue);
         if (!propertyName)
             break;
 
         // Add the value now
-        if (propertyValue->isString()) {
-            const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::String);
-            if (r.type == ListLayout::Role::String)
-                e->setStringPropertyFast(r, propertyValue->stringValue()->toQString());
-        } else if (propertyValue->isNumber()) {
-            const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::Number);
-            if (r.type == ListLayout::Role::Number) {
-                e->setDoublePropertyFast(r, propertyValue->asDouble());
-            }
-        } else if (propertyValue->asArrayObject()) {
-            a = propertyValue;
-            const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::List);
-            if (r.type == ListLayout::Role::List) {
-                ListModel *subModel = new ListModel(r.subLayout, 0, -1);
-
-                int arrayLength = a->getLength();
-                for (int j=0 ; j < arrayLength ; ++j) {
-                    o = a->getIndexed(j);
-                    subModel->append(o, eng);
-                }
-
-                e->setListPropertyFast(r, subModel);
-            }
-        } else if (propertyValue->isBoolean()) {
-            const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::Bool);
-            if (r.type == ListLayout::Role::Bool) {
-                e->setBoolPropertyFast(r, propertyValue->booleanValue());
-            }
-        } else if (propertyValue->asDateObject()) {
-            date = propertyValue;
-            const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::DateTime);
-            if (r.type == ListLayout::Role::DateTime) {
-                QDateTime dt = date->toQDateTime();;
-                e->setDateTimePropertyFast(r, dt);
-            }
-        } else if (propertyValue->isObject()) {
-            o = propertyValue;
-            if (QV4::QObjectWrapper *wrapper = o->as<QV4::QObjectWrapper>()) {
-                QObject *o = wrapper->object();
-                const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::QObject);
-                if (r.type == ListLayout::Role::QObject)
-                    e->setQObjectPropertyFast(r, o);
-            } else {
-                const ListLayout::Role &role = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::VariantMap);
-                if (role.type == ListLayout::Role::VariantMap)
-                    e->setVariantMapFast(role, o, eng);
-            }
+        ListLayout::Role::DataType type = ListLayout::roleType(propertyValue);
+        if (type != ListLayout::Role::Invalid) {
+            const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, type);
+            if (r.type == type)
+                setValueFast(e, r, propertyValue, eng);
         } else if (propertyValue->isNullOrUndefined()) {
             const ListLayout::Role *r = m_layout->getExistingRole(propertyName);
             if (r)
@@ -593,6 +568,123 @@ int ListModel::append(QV4::ObjectRef object, QV8Engine *eng)
     return elementIndex;
 }
 
+/*
+    Appends \a rowCount elements, taking the values from the arrays held by
+    each property of \a columns. Each role is looked up once per column rather
+    than once per element.
+*/
+void ListModel::appendColumns(QV4::ObjectRef columns, int rowCount, QV8Engine *eng)
+{
+    const int firstElement = elements.count();
+    elements.reserve(firstElement + rowCount);
+    for (int i=0 ; i < rowCount ; ++i)
+        newElement(firstElement + i);
+
+    QV4::ExecutionEngine *v4 = columns->engine();
+    QV4::Scope scope(v4);
+
+    QV4::ObjectIterator it(scope, columns, QV4::ObjectIterator::WithProtoChain|QV4::ObjectIterator::EnumerableOnly);
+    QV4::Scoped<QV4::String> propertyName(scope);
+    QV4::ScopedValue column(scope);
+    QV4::ScopedArrayObject values(scope);
+    QV4::ScopedValue value(scope);
+    while (1) {
+        propertyName = it.nextPropertyNameAsString(column);
+        if (!propertyName)
+            break;
+
+        values = column;
+        if (!values)
+            continue;
+
+        const ListLayout::Role *r = 0;
+        const int length = qMin<int>(rowCount, values->getLength());
+        for (int j=0 ; j < length ; ++j) {
+            value = values->getIndexed(j);
+            ListLayout::Role::DataType type = ListLayout::roleType(value);
+            if (type == ListLayout::Role::Invalid)
+                continue;
+            if (!r || r->type != type)
+                r = &m_layout->getRoleOrCreate(propertyName, type);
+            if (r->type == type)
+                setValueFast(elements[firstElement + j], *r, value, eng);
+        }
+    }
+}
+
+/*
+    Sets the role \a r of \a e, whose type must be the one returned by
+    ListLayout::roleType() for \a value.
+*/
+void ListModel::setValueFast(ListElement *e, const ListLayout::Role &r, const QV4::ValueRef value, QV8Engine *eng)
+{
+    QV4::Scope scope(QV8Engine::getV4(eng));
+
+    switch (r.type) {
+    case ListLayout::Role::String:
+        e->setStringPropertyFast(r, value->stringValue()->toQString());
+        break;
+    case ListLayout::Role::Number:
+        e->setDoublePropertyFast(r, value->asDouble());
+        break;
+    case ListLayout::Role::Bool:
+        e->setBoolPropertyFast(r, value->booleanValue());
+        break;
+    case ListLayout::Role::DateTime:
+        e->setDateTimePropertyFast(r, value->asDateObject()->toQDateTime());
+        break;
+    case ListLayout::Role::List: {
+        QV4::ScopedArrayObject a(scope, value);
+        QV4::ScopedObject o(scope);
+        ListModel *subModel = new ListModel(r.subLayout, 0, -1);
+
+        int arrayLength = a->getLength();
+        for (int j=0 ; j < arrayLength ; ++j) {
+            o = a->getIndexed(j);
+            subModel->append(o, eng);
+        }
+
+        e->setListPropertyFast(r, subModel);
+        break;
+    }
+    case ListLayout::Role::QObject:
+        e->setQObjectPropertyFast(r, value->asObject()->as<QV4::QObjectWrapper>()->object());
+        break;
+    case ListLayout::Role::VariantMap: {
+        QV4::ScopedObject o(scope, value);
+        e->setVariantMapFast(r, o, eng);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/*
+    Rebuilds the element list from the element indices in \a rows, in that
+    order. Elements which are not listed are destroyed.
+*/
+void ListModel::reorder(const QVector<int> &rows)
+{
+    QVector<ListElement *> kept(elements.count(), 0);
+    for (int i=0 ; i < rows.count() ; ++i)
+        kept[rows.at(i)] = elements[rows.at(i)];
+
+    for (int i=0 ; i < kept.count() ; ++i) {
+        if (!kept.at(i)) {
+            elements[i]->destroy(m_layout);
+            delete elements[i];
+        }
+    }
+
+    elements.clear();
+    elements.reserve(rows.count());
+    for (int i=0 ; i < rows.count() ; ++i)
+        elements.append(kept.at(rows.at(i)));
+
+    updateCacheIndices();
+}
+
 int ListModel::setOrCreateProperty(int elementIndex, const QString &key, const QVariant &data)
 {
     int roleIndex = -1;
@@ -1501,6 +1593,10 @@ QQmlListModelParser::ListInstruction *QQmlListModelParser::ListModelData::instru
     cannot be changed once set. Whatever properties are first added to the model
     are the only permitted properties in the model.
 
+    Large amounts of data are best added with appendRows(), and modified with
+    setRange(), sortByRole() and filter(). Each of these notifies views once
+    for the whole batch instead of once per item.
+
     \section1 Using Threaded List Models with WorkerScript
 
     ListModel can be used together with WorkerScript access a list model
@@ -1625,6 +1721,36 @@ QV8Engine *QQmlListModel::engine() const
     return m_engine;
 }
 
+int QQmlListModel::roleIndex(const QString &role) const
+{
+    if (m_dynamicRoles)
+        return m_roles.indexOf(role);
+
+    const ListLayout::Role *r = m_listModel->getExistingRole(role);
+    return r ? r->index : -1;
+}
+
+void QQmlListModel::reorderRows(const QVector<int> &rows)
+{
+    if (m_dynamicRoles) {
+        QVector<DynamicRoleModelNode *> kept(m_modelObjects.count(), 0);
+        for (int i = 0; i < rows.count(); ++i)
+            kept[rows.at(i)] = m_modelObjects.at(rows.at(i));
+
+        QVector<DynamicRoleModelNode *> objects;
+        objects.reserve(rows.count());
+        for (int i = 0; i < kept.count(); ++i) {
+            if (!kept.at(i))
+                delete m_modelObjects.at(i);
+        }
+        for (int i = 0; i < rows.count(); ++i)
+            objects.append(kept.at(rows.at(i)));
+        m_modelObjects = objects;
+    } else {
+        m_listModel->reorder(rows);
+    }
+}
+
 void QQmlListModel::sync(QQmlListModel *src, QQmlListModel *target, QHash<int, QQmlListModel *> *targetModelHash)
 {
     Q_ASSERT(src->m_dynamicRoles && target->m_dynamicRoles);
@@ -1696,15 +1822,19 @@ void QQmlListModel::emitItemsChanged(int index, int count, const QVector<int> &r
     } else {
         int uid = m_dynamicRoles ? getUid() : m_listModel->getUid();
         m_agent->data.changedChange(uid, index, count, roles);
+        m_agent->trackElements(this, index, count);
     }
 }
 
 void QQmlListModel::emitItemsAboutToBeRemoved(int index, int count)
 {
-    if (count <= 0 || !m_mainThread)
+    if (count <= 0)
         return;
 
-    beginRemoveRows(QModelIndex(), index, index + count - 1);
+    if (m_mainThread)
+        beginRemoveRows(QModelIndex(), index, index + count - 1);
+    else
+        m_agent->untrackElements(this, index, count);
 }
 
 void QQmlListModel::emitItemsRemoved(int index, int count)
@@ -1741,7 +1871,7 @@ void QQmlListModel::emitItemsInserted(int index, int count)
         emit countChanged();
     } else {
         int uid = m_dynamicRoles ? getUid() : m_listModel->getUid();
-        m_agent->data.insertChange(uid, index, count);
+        m_agent->data.insertChange(uid, index, count, m_agent->trackElements(this, index, count));
     }
 }
 
@@ -1766,6 +1896,63 @@ void QQmlListModel::emitItemsMoved(int from, int to, int n)
     }
 }
 
+void QQmlListModel::emitItemsAboutToBeSorted()
+{
+    if (!m_mainThread)
+        return;
+
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>() << QPersistentModelIndex(), QAbstractItemModel::VerticalSortHint);
+}
+
+void QQmlListModel::emitItemsSorted(const QVector<int> &rows)
+{
+    if (m_mainThread) {
+        QVector<int> newRows(rows.count());
+        for (int i = 0; i < rows.count(); ++i)
+            newRows[rows.at(i)] = i;
+
+        const QModelIndexList from = persistentIndexList();
+        QModelIndexList to;
+        to.reserve(from.count());
+        for (int i = 0; i < from.count(); ++i)
+            to.append(createIndex(newRows.at(from.at(i).row()), 0));
+        changePersistentIndexList(from, to);
+
+        emit layoutChanged(QList<QPersistentModelIndex>() << QPersistentModelIndex(), QAbstractItemModel::VerticalSortHint);
+    } else {
+        // Worker changes are replayed as row changes, so report the new
+        // order as all rows being replaced
+        int uid = m_dynamicRoles ? getUid() : m_listModel->getUid();
+        m_agent->data.fullSync = true;
+        m_agent->data.removeChange(uid, 0, rows.count());
+        m_agent->data.insertChange(uid, 0, rows.count());
+    }
+}
+
+void QQmlListModel::emitItemsAboutToBeReset()
+{
+    if (!m_mainThread)
+        return;
+
+    beginResetModel();
+}
+
+void QQmlListModel::emitItemsReset(int oldCount, int newCount)
+{
+    if (m_mainThread) {
+        endResetModel();
+        if (oldCount != newCount)
+            emit countChanged();
+    } else {
+        int uid = m_dynamicRoles ? getUid() : m_listModel->getUid();
+        m_agent->data.fullSync = true;
+        if (oldCount > 0)
+            m_agent->data.removeChange(uid, 0, oldCount);
+        if (newCount > 0)
+            m_agent->data.insertChange(uid, 0, newCount);
+    }
+}
+
 QQmlListModelWorkerAgent *QQmlListModel::agent()
 {
     if (m_agent)
@@ -2093,6 +2280,11 @@ void QQmlListModel::append(QQmlV4Function *args)
             int index = count();
             emitItemsAboutToBeInserted(index, objectArrayLength);
 
+            if (m_dynamicRoles)
+                m_modelObjects.reserve(index + objectArrayLength);
+            else
+                m_listModel->reserve(index + objectArrayLength);
+
             for (int i=0 ; i < objectArrayLength ; ++i) {
                 argObject = objectArray->getIndexed(i);
 
@@ -2281,6 +2473,10 @@ void QQmlListModel::setProperty(int index, const QString& property, const QVaria
 
     Writes any unsaved changes to the list model after it has been modified
     from a worker script.
+
+    Unless the model uses dynamic roles or nested lists were modified, only
+    the items changed since the previous sync() are copied, and the worker
+    script does not wait for the main thread to apply them.
 */
 void QQmlListModel::sync()
 {
@@ -2290,6 +2486,316 @@ void QQmlListModel::sync()
     qmlInfo(this) << "List sync() can only be called from a WorkerScript";
 }
 
+/*!
+    \qmlmethod ListModel::appendRows(rows)
+    \since 5.4
+
+    Adds several items to the end of the list model in one operation.
+    \a rows is either an array of objects, as accepted by append(), or an
+    object holding one array per role, with the n-th element of each array
+    giving the value of that role for the n-th new item:
+
+    \code
+        fruitModel.appendRows({"name": ["Apple", "Banana"], "cost": [2.45, 1.95]})
+    \endcode
+
+    The column form avoids creating an object for each item and looks up
+    each role only once, which makes it the fastest way to populate a large
+    model. Views are notified with a single insertion.
+
+    \sa append(), setRange()
+*/
+void QQmlListModel::appendRows(QQmlV4Function *args)
+{
+    if (args->length() != 1) {
+        qmlInfo(this) << tr("appendRows: value is not an array or an object of arrays");
+        return;
+    }
+
+    QV4::Scope scope(args->v4engine());
+    QV4::ScopedArrayObject rows(scope, (*args)[0]);
+    QV4::ScopedObject columns(scope, (*args)[0]);
+    const int index = count();
+
+    if (rows) {
+        const int rowCount = rows->getLength();
+        if (rowCount <= 0)
+            return;
+
+        emitItemsAboutToBeInserted(index, rowCount);
+
+        QV4::ScopedObject row(scope);
+        if (m_dynamicRoles)
+            m_modelObjects.reserve(index + rowCount);
+        else
+            m_listModel->reserve(index + rowCount);
+
+        for (int i = 0; i < rowCount; ++i) {
+            row = rows->getIndexed(i);
+            if (m_dynamicRoles)
+                m_modelObjects.append(DynamicRoleModelNode::create(args->engine()->variantMapFromJS(row), this));
+            else
+                m_listModel->append(row, args->engine());
+        }
+
+        emitItemsInserted(index, rowCount);
+    } else if (columns) {
+        QV4::ObjectIterator it(scope, columns, QV4::ObjectIterator::WithProtoChain|QV4::ObjectIterator::EnumerableOnly);
+        QV4::Scoped<QV4::String> name(scope);
+        QV4::ScopedValue column(scope);
+        QV4::ScopedArrayObject values(scope);
+
+        // Dynamic roles are stored as variants anyway, so convert whole columns
+        QList<QPair<QString, QVariantList> > variantColumns;
+        int rowCount = 0;
+        while (1) {
+            name = it.nextPropertyNameAsString(column);
+            if (!name)
+                break;
+            values = column;
+            if (!values)
+                continue;
+            rowCount = qMax<int>(rowCount, values->getLength());
+            if (m_dynamicRoles)
+                variantColumns.append(qMakePair(name->toQString(), args->engine()->toVariant(column, -1).toList()));
+        }
+
+        if (rowCount <= 0)
+            return;
+
+        emitItemsAboutToBeInserted(index, rowCount);
+
+        if (m_dynamicRoles) {
+            m_modelObjects.reserve(index + rowCount);
+            for (int i = 0; i < rowCount; ++i) {
+                QVariantMap row;
+                for (int j = 0; j < variantColumns.count(); ++j) {
+                    const QVariantList &values = variantColumns.at(j).second;
+                    if (i < values.count())
+                        row.insert(variantColumns.at(j).first, values.at(i));
+                }
+                m_modelObjects.append(DynamicRoleModelNode::create(row, this));
+            }
+        } else {
+            m_listModel->appendColumns(columns, rowCount, args->engine());
+        }
+
+        emitItemsInserted(index, rowCount);
+    } else {
+        qmlInfo(this) << tr("appendRows: value is not an array or an object of arrays");
+    }
+}
+
+/*!
+    \qmlmethod ListModel::setRange(int index, array rows)
+    \since 5.4
+
+    Changes the items starting at \a index with the values of the objects
+    in \a rows, as set() does for a single item. All the items must already
+    exist. Views are notified with a single change covering the whole range.
+
+    \sa set(), appendRows()
+*/
+void QQmlListModel::setRange(QQmlV4Function *args)
+{
+    if (args->length() != 2) {
+        qmlInfo(this) << tr("setRange: incorrect number of arguments");
+        return;
+    }
+
+    QV4::Scope scope(args->v4engine());
+    const int index = QV4::ScopedValue(scope, (*args)[0])->toInt32();
+    QV4::ScopedArrayObject rows(scope, (*args)[1]);
+    if (!rows) {
+        qmlInfo(this) << tr("setRange: value is not an array");
+        return;
+    }
+
+    const int rowCount = rows->getLength();
+    if (index < 0 || index + rowCount > count()) {
+        qmlInfo(this) << tr("setRange: indices [%1 - %2] out of range [0 - %3]").arg(index).arg(index+rowCount).arg(count());
+        return;
+    }
+
+    QVector<int> roles;
+    QVector<int> rowRoles;
+    QV4::ScopedObject row(scope);
+    for (int i = 0; i < rowCount; ++i) {
+        row = rows->getIndexed(i);
+        if (!row)
+            continue;
+
+        rowRoles.clear();
+        if (m_dynamicRoles)
+            m_modelObjects[index+i]->updateValues(args->engine()->variantMapFromJS(row), rowRoles);
+        else
+            m_listModel->set(index+i, row, &rowRoles, args->engine());
+
+        for (int j = 0; j < rowRoles.count(); ++j) {
+            if (!roles.contains(rowRoles.at(j)))
+                roles.append(rowRoles.at(j));
+        }
+    }
+
+    if (roles.count())
+        emitItemsChanged(index, rowCount, roles);
+}
+
+struct SortKey
+{
+    QVariant value;
+    int row;
+};
+
+static bool isNumericType(int type)
+{
+    return type == QMetaType::Double || type == QMetaType::Int || type == QMetaType::UInt
+            || type == QMetaType::LongLong || type == QMetaType::ULongLong || type == QMetaType::Float;
+}
+
+// In ascending order, items without a value for the role sort after all others
+static bool variantLessThan(const QVariant &left, const QVariant &right)
+{
+    if (!left.isValid() || !right.isValid())
+        return left.isValid() && !right.isValid();
+
+    const int leftType = left.userType();
+    const int rightType = right.userType();
+    if (isNumericType(leftType) && isNumericType(rightType))
+        return left.toDouble() < right.toDouble();
+    if (leftType == QMetaType::Bool && rightType == QMetaType::Bool)
+        return left.toBool() < right.toBool();
+    if (leftType == QMetaType::QDateTime && rightType == QMetaType::QDateTime)
+        return left.toDateTime() < right.toDateTime();
+    return left.toString() < right.toString();
+}
+
+struct SortKeyLessThan
+{
+    SortKeyLessThan(bool isDescending) : descending(isDescending) {}
+
+    bool operator()(const SortKey &left, const SortKey &right) const
+    {
+        return descending ? variantLessThan(right.value, left.value) : variantLessThan(left.value, right.value);
+    }
+
+    bool descending;
+};
+
+/*!
+    \qmlmethod ListModel::sortByRole(string role, enumeration order = Qt.AscendingOrder)
+    \since 5.4
+
+    Sorts the items of the list model by the values of \a role, in the given
+    \a order. The sort is stable. Numbers, booleans and dates are compared by
+    value, other values by their string representation.
+
+    Views are notified with a single layout change, so existing delegates are
+    moved rather than recreated.
+
+    \code
+        fruitModel.sortByRole("cost", Qt.DescendingOrder)
+    \endcode
+*/
+void QQmlListModel::sortByRole(const QString &role, int order)
+{
+    const int index = roleIndex(role);
+    if (index == -1) {
+        qmlInfo(this) << tr("sortByRole: role %1 does not exist").arg(role);
+        return;
+    }
+
+    const int rowCount = count();
+    if (rowCount < 2)
+        return;
+
+    QVector<SortKey> keys(rowCount);
+    for (int i = 0; i < rowCount; ++i) {
+        keys[i].value = data(i, index);
+        keys[i].row = i;
+    }
+    std::stable_sort(keys.begin(), keys.end(), SortKeyLessThan(order == Qt::DescendingOrder));
+
+    QVector<int> rows(rowCount);
+    bool moved = false;
+    for (int i = 0; i < rowCount; ++i) {
+        rows[i] = keys.at(i).row;
+        moved |= rows.at(i) != i;
+    }
+    if (!moved)
+        return;
+
+    emitItemsAboutToBeSorted();
+    reorderRows(rows);
+    emitItemsSorted(rows);
+}
+
+/*!
+    \qmlmethod ListModel::filter(string role, function predicate)
+    \since 5.4
+
+    Removes the items for which \a predicate, called with the value of
+    \a role for each item, returns false. The predicate must not modify the
+    model.
+
+    \code
+        fruitModel.filter("cost", function(cost) { return cost < 5 })
+    \endcode
+
+    Views are notified with a single model reset rather than one removal for
+    each run of removed items.
+
+    \sa remove()
+*/
+void QQmlListModel::filter(QQmlV4Function *args)
+{
+    if (args->length() != 2) {
+        qmlInfo(this) << tr("filter: incorrect number of arguments");
+        return;
+    }
+
+    QV4::Scope scope(args->v4engine());
+    const QString role = QV4::ScopedValue(scope, (*args)[0])->toQStringNoThrow();
+    QV4::Scoped<QV4::FunctionObject> predicate(scope, (*args)[1]);
+    if (!predicate) {
+        qmlInfo(this) << tr("filter: predicate is not a function");
+        return;
+    }
+
+    const int index = roleIndex(role);
+    if (index == -1) {
+        qmlInfo(this) << tr("filter: role %1 does not exist").arg(role);
+        return;
+    }
+
+    const int rowCount = count();
+    QVector<int> rows;
+    rows.reserve(rowCount);
+
+    QV4::ScopedCallData callData(scope, 1);
+    QV4::ScopedValue result(scope);
+    for (int i = 0; i < rowCount; ++i) {
+        callData->thisObject = QV4::Primitive::undefinedValue();
+        callData->args[0] = args->engine()->fromVariant(data(i, index));
+        result = predicate->call(callData);
+        if (scope.engine->hasException)
+            return;
+        if (result->toBoolean())
+            rows.append(i);
+    }
+
+    if (count() != rowCount) {
+        qmlInfo(this) << tr("filter: model modified by the predicate");
+        return;
+    }
+    if (rows.count() == rowCount)
+        return;
+
+    emitItemsAboutToBeReset();
+    reorderRows(rows);
+    emitItemsReset(rowCount, rows.count());
+}
+
 bool QQmlListModelParser::compileProperty(const QV4::CompiledData::QmlUnit *qmlUnit, const QV4::CompiledData::Binding *binding, QList<QQmlListModelParser::ListInstruction> &instr, QByteArray &data)
 {
     if (binding->type >= QV4::CompiledData::Binding::Type_Object) {
@@ -90,6 +90,11 @@ public:
     Q_INVOKABLE void move(int from, int to, int count);
     Q_INVOKABLE void sync();
 
+    Q_INVOKABLE void appendRows(QQmlV4Function *args);
+    Q_INVOKABLE void setRange(QQmlV4Function *args);
+    Q_INVOKABLE void sortByRole(const QString &role, int order = Qt::AscendingOrder);
+    Q_INVOKABLE void filter(QQmlV4Function *args);
+
     QQmlListModelWorkerAgent *agent();
 
     bool dynamicRoles() const { return m_dynamicRoles; }
@@ -114,6 +119,9 @@ private:
 
     QV8Engine *engine() const;
 
+    int roleIndex(const QString &role) const;
+    void reorderRows(const QVector<int> &rows);
+
     inline bool canMove(int from, int to, int n) const { return !(from+n > count() || to+n > count() || from < 0 || to < 0 || n < 0); }
 
     QQmlListModelWorkerAgent *m_agent;
@@ -150,6 +158,10 @@ private:
     void emitItemsInserted(int index, int count);
     void emitItemsAboutToBeMoved(int from, int to, int n);
     void emitItemsMoved(int from, int to, int n);
+    void emitItemsAboutToBeSorted();
+    void emitItemsSorted(const QVector<int> &rows);
+    void emitItemsAboutToBeReset();
+    void emitItemsReset(int oldCount, int newCount);
 };
 
 // ### FIXME
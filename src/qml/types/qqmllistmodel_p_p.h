@@ -218,6 +218,8 @@ public:
 
     int roleCount() const { return roles.count(); }
 
+    static Role::DataType roleType(const QV4::ValueRef value);
+
     static void sync(ListLayout *src, ListLayout *target);
 
 private:
@@ -293,6 +295,7 @@ private:
     ModelObject *m_objectCache;
 
     friend class ListModel;
+    friend class QQmlListModelWorkerAgent;
 };
 
 /*!
@@ -328,6 +331,11 @@ public:
         return m_layout->getRoleOrCreate(name, ListLayout::Role::List);
     }
 
+    const ListLayout::Role *getExistingRole(const QString &key)
+    {
+        return m_layout->getExistingRole(key);
+    }
+
     int elementCount() const
     {
         return elements.count();
@@ -338,6 +346,10 @@ public:
 
     int append(QV4::ObjectRef object, QV8Engine *eng);
     void insert(int elementIndex, QV4::ObjectRef object, QV8Engine *eng);
+    void appendColumns(QV4::ObjectRef columns, int rowCount, QV8Engine *eng);
+
+    void reserve(int count) { elements.reserve(count); }
+    void reorder(const QVector<int> &rows);
 
     void clear();
     void remove(int index, int count);
@@ -369,6 +381,7 @@ private:
     };
 
     void newElement(int index);
+    void setValueFast(ListElement *e, const ListLayout::Role &r, const QV4::ValueRef value, QV8Engine *eng);
 
     void updateCacheIndices();
 
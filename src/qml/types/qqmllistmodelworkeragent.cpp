@@ -55,6 +55,9 @@ QT_BEGIN_NAMESPACE
 
 void QQmlListModelWorkerAgent::Data::clearChange(int uid)
 {
+    // Earlier changes are dropped, so they can't be replayed as a delta
+    fullSync = true;
+
     for (int i=0 ; i < changes.count() ; ++i) {
         if (changes[i].modelUid == uid) {
             changes.removeAt(i);
@@ -63,32 +66,42 @@ void QQmlListModelWorkerAgent::Data::clearChange(int uid)
     }
 }
 
-void QQmlListModelWorkerAgent::Data::insertChange(int uid, int index, int count)
+void QQmlListModelWorkerAgent::Data::insertChange(int uid, int index, int count, const QVector<int> &uids)
 {
-    Change c = { uid, Change::Inserted, index, count, 0, QVector<int>() };
+    Change c = { uid, Change::Inserted, index, count, 0, QVector<int>(), uids };
     changes << c;
 }
 
 void QQmlListModelWorkerAgent::Data::removeChange(int uid, int index, int count)
 {
-    Change c = { uid, Change::Removed, index, count, 0, QVector<int>() };
+    Change c = { uid, Change::Removed, index, count, 0, QVector<int>(), QVector<int>() };
     changes << c;
 }
 
 void QQmlListModelWorkerAgent::Data::moveChange(int uid, int index, int count, int to)
 {
-    Change c = { uid, Change::Moved, index, count, to, QVector<int>() };
+    Change c = { uid, Change::Moved, index, count, to, QVector<int>(), QVector<int>() };
     changes << c;
 }
 
 void QQmlListModelWorkerAgent::Data::changedChange(int uid, int index, int count, const QVector<int> &roles)
 {
-    Change c = { uid, Change::Changed, index, count, 0, roles };
+    Change c = { uid, Change::Changed, index, count, 0, roles, QVector<int>() };
     changes << c;
 }
 
+QQmlListModelWorkerAgent::Sync::~Sync()
+{
+    QHash<int, ListElement *>::const_iterator it = elements.constBegin();
+    for (; it != elements.constEnd(); ++it) {
+        it.value()->destroy(layout);
+        delete it.value();
+    }
+    delete layout;
+}
+
 QQmlListModelWorkerAgent::QQmlListModelWorkerAgent(QQmlListModel *model)
-: m_ref(1), m_orig(model), m_copy(new QQmlListModel(model, this))
+: m_ref(1), m_engine(0), m_orig(model), m_copy(new QQmlListModel(model, this))
 {
 }
 
@@ -99,9 +112,17 @@ QQmlListModelWorkerAgent::~QQmlListModelWorkerAgent()
     mutex.unlock();
 }
 
-void QQmlListModelWorkerAgent::setV8Engine(QV8Engine *eng)
+/*
+    The worker side copy of the model is not guarded, so it can only be used
+    by the worker scripts of one thread. Returns false if the model was already
+    passed to a worker script running on another engine.
+*/
+bool QQmlListModelWorkerAgent::setV8Engine(QV8Engine *eng)
 {
+    if (!m_engine.testAndSetOrdered(0, eng) && m_engine.load() != eng)
+        return false;
     m_copy->m_engine = eng;
+    return true;
 }
 
 void QQmlListModelWorkerAgent::addref()
@@ -167,12 +188,151 @@ void QQmlListModelWorkerAgent::move(int from, int to, int count)
     m_copy->move(from, to, count);
 }
 
+void QQmlListModelWorkerAgent::appendRows(QQmlV4Function *args)
+{
+    m_copy->appendRows(args);
+}
+
+void QQmlListModelWorkerAgent::setRange(QQmlV4Function *args)
+{
+    m_copy->setRange(args);
+}
+
+void QQmlListModelWorkerAgent::sortByRole(const QString &role, int order)
+{
+    m_copy->sortByRole(role, order);
+}
+
+void QQmlListModelWorkerAgent::filter(QQmlV4Function *args)
+{
+    m_copy->filter(args);
+}
+
+/*
+    Records the elements of the worker copy that were inserted or changed, so
+    that sync() only has to copy those. Returns their uids, or an empty list
+    if the change requires a full sync.
+*/
+QVector<int> QQmlListModelWorkerAgent::trackElements(QQmlListModel *model, int index, int count)
+{
+    QVector<int> uids;
+    if (model != m_copy || model->m_dynamicRoles) {
+        data.fullSync = true;
+        return uids;
+    }
+
+    ListModel *list = model->m_listModel;
+    uids.reserve(count);
+    for (int i = index; i < index + count; ++i) {
+        ListElement *e = list->elements[i];
+        uids.append(e->getUid());
+        data.dirtyElements.insert(e->getUid(), e);
+    }
+    return uids;
+}
+
+void QQmlListModelWorkerAgent::untrackElements(QQmlListModel *model, int index, int count)
+{
+    if (model != m_copy || model->m_dynamicRoles) {
+        data.fullSync = true;
+        return;
+    }
+
+    ListModel *list = model->m_listModel;
+    for (int i = index; i < index + count; ++i)
+        data.dirtyElements.remove(list->elements[i]->getUid());
+}
+
+/*
+    Replays the recorded changes on the original model, then copies the dirty
+    elements over. Only touches the elements affected by the changes.
+*/
+void QQmlListModelWorkerAgent::applyDelta(Sync *s)
+{
+    ListModel *target = m_orig->m_listModel;
+    ListLayout::sync(s->layout, target->m_layout);
+
+    QHash<int, ListElement *> targets;
+    bool structureChanged = false;
+    const QList<Change> &changes = s->data.changes;
+    for (int ii = 0; ii < changes.count(); ++ii) {
+        const Change &change = changes.at(ii);
+        switch (change.type) {
+        case Change::Inserted:
+            for (int i = 0; i < change.count; ++i) {
+                ListElement *e = new ListElement(change.uids.at(i));
+                target->elements.insert(change.index + i, e);
+                targets.insert(e->getUid(), e);
+            }
+            structureChanged = true;
+            break;
+        case Change::Removed:
+            for (int i = 0; i < change.count; ++i) {
+                ListElement *e = target->elements[change.index + i];
+                targets.remove(e->getUid());
+                e->destroy(target->m_layout);
+                delete e;
+            }
+            target->elements.remove(change.index, change.count);
+            structureChanged = true;
+            break;
+        case Change::Moved:
+            target->move(change.index, change.to, change.count);
+            break;
+        case Change::Changed:
+            for (int i = 0; i < change.count; ++i) {
+                ListElement *e = target->elements[change.index + i];
+                targets.insert(e->getUid(), e);
+            }
+            break;
+        }
+    }
+
+    if (structureChanged)
+        target->updateCacheIndices();
+
+    QHash<int, ListElement *>::const_iterator it = s->elements.constBegin();
+    for (; it != s->elements.constEnd(); ++it) {
+        ListElement *e = targets.value(it.key());
+        if (!e)
+            continue;
+        ListElement::sync(it.value(), s->layout, e, target->m_layout, 0);
+        if (e->m_objectCache)
+            e->m_objectCache->updateValues();
+    }
+}
+
 void QQmlListModelWorkerAgent::sync()
 {
     Sync *s = new Sync;
     s->data = data;
     s->list = m_copy;
     data.changes.clear();
+    data.dirtyElements.clear();
+    data.fullSync = false;
+
+    if (!s->data.fullSync) {
+        // Copy the dirty elements now, so the original model can be updated
+        // without the worker waiting for the GUI thread
+        if (s->data.changes.isEmpty()) {
+            delete s;
+            return;
+        }
+
+        ListModel *source = m_copy->m_listModel;
+        s->layout = new ListLayout(source->m_layout);
+        QHash<int, ListElement *>::const_iterator it = s->data.dirtyElements.constBegin();
+        for (; it != s->data.dirtyElements.constEnd(); ++it) {
+            ListElement *e = new ListElement(it.key());
+            ListElement::sync(it.value(), source->m_layout, e, s->layout, 0);
+            s->elements.insert(it.key(), e);
+        }
+        s->data.dirtyElements.clear();
+        s->list = 0;
+
+        QCoreApplication::postEvent(this, s);
+        return;
+    }
 
     mutex.lock();
     QCoreApplication::postEvent(this, s);
@@ -189,16 +349,23 @@ bool QQmlListModelWorkerAgent::event(QEvent *e)
             Sync *s = static_cast<Sync *>(e);
             const QList<Change> &changes = s->data.changes;
 
-            cc = m_orig->count() != s->list->count();
+            const int oldCount = m_orig->count();
 
             QHash<int, QQmlListModel *> targetModelDynamicHash;
             QHash<int, ListModel *> targetModelStaticHash;
 
-            Q_ASSERT(m_orig->m_dynamicRoles == s->list->m_dynamicRoles);
-            if (m_orig->m_dynamicRoles)
-                QQmlListModel::sync(s->list, m_orig, &targetModelDynamicHash);
-            else
-                ListModel::sync(s->list->m_listModel, m_orig->m_listModel, &targetModelStaticHash);
+            if (s->layout) {
+                applyDelta(s);
+                targetModelStaticHash.insert(m_orig->m_listModel->getUid(), m_orig->m_listModel);
+            } else {
+                Q_ASSERT(m_orig->m_dynamicRoles == s->list->m_dynamicRoles);
+                if (m_orig->m_dynamicRoles)
+                    QQmlListModel::sync(s->list, m_orig, &targetModelDynamicHash);
+                else
+                    ListModel::sync(s->list->m_listModel, m_orig->m_listModel, &targetModelStaticHash);
+            }
+
+            cc = m_orig->count() != oldCount;
 
             for (int ii = 0; ii < changes.count(); ++ii) {
                 const Change &change = changes.at(ii);
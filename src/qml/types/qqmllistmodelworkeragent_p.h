@@ -64,6 +64,8 @@ QT_BEGIN_NAMESPACE
 
 
 class QQmlListModel;
+class ListElement;
+class ListLayout;
 
 class QQmlListModelWorkerAgent : public QObject
 {
@@ -73,7 +75,7 @@ class QQmlListModelWorkerAgent : public QObject
 public:
     QQmlListModelWorkerAgent(QQmlListModel *);
     ~QQmlListModelWorkerAgent();
-    void setV8Engine(QV8Engine *eng);
+    bool setV8Engine(QV8Engine *eng);
 
     void addref();
     void release();
@@ -90,6 +92,11 @@ public:
     Q_INVOKABLE void move(int from, int to, int count);
     Q_INVOKABLE void sync();
 
+    Q_INVOKABLE void appendRows(QQmlV4Function *args);
+    Q_INVOKABLE void setRange(QQmlV4Function *args);
+    Q_INVOKABLE void sortByRole(const QString &role, int order = Qt::AscendingOrder);
+    Q_INVOKABLE void filter(QQmlV4Function *args);
+
     struct VariantRef
     {
         VariantRef() : a(0) {}
@@ -122,14 +129,21 @@ private:
         int count; // Inserted/Removed/Moved/Changed
         int to;    // Moved
         QVector<int> roles;
+        QVector<int> uids; // Inserted, when the change can be synced as a delta
     };
 
     struct Data
     {
+        Data() : fullSync(false) {}
+
         QList<Change> changes;
 
+        // Inserted or changed elements of the top level model, by uid
+        QHash<int, ListElement *> dirtyElements;
+        bool fullSync;
+
         void clearChange(int uid);
-        void insertChange(int uid, int index, int count);
+        void insertChange(int uid, int index, int count, const QVector<int> &uids = QVector<int>());
         void removeChange(int uid, int index, int count);
         void moveChange(int uid, int index, int count, int to);
         void changedChange(int uid, int index, int count, const QVector<int> &roles);
@@ -137,12 +151,23 @@ private:
     Data data;
 
     struct Sync : public QEvent {
-        Sync() : QEvent(QEvent::User) {}
+        Sync() : QEvent(QEvent::User), layout(0) {}
+        ~Sync();
         Data data;
         QQmlListModel *list;
+
+        // Copies of the dirty elements when syncing a delta, in which case
+        // list must not be accessed
+        ListLayout *layout;
+        QHash<int, ListElement *> elements;
     };
 
+    QVector<int> trackElements(QQmlListModel *model, int index, int count);
+    void untrackElements(QQmlListModel *model, int index, int count);
+    void applyDelta(Sync *s);
+
     QAtomicInt m_ref;
+    QAtomicPointer<QV8Engine> m_engine;
     QQmlListModel *m_orig;
     QQmlListModel *m_copy;
     QMutex mutex;
@@ -54,6 +54,7 @@
 #include <QtCore/qwaitcondition.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qdatetime.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtNetwork/qnetworkaccessmanager.h>
 #include <QtQml/qqmlinfo.h>
 #include <QtQml/qqmlfile.h>
@@ -74,15 +75,15 @@ class WorkerDataEvent : public QEvent
 public:
     enum Type { WorkerData = QEvent::User };
 
-    WorkerDataEvent(int workerId, const QByteArray &data);
+    WorkerDataEvent(int workerId, const QV4::Serialize::Message &data);
     virtual ~WorkerDataEvent();
 
     int workerId() const;
-    QByteArray data() const;
+    QV4::Serialize::Message data() const;
 
 private:
     int m_id;
-    QByteArray m_data;
+    QV4::Serialize::Message m_data;
 };
 
 class WorkerLoadEvent : public QEvent
@@ -174,12 +175,17 @@ public:
         bool initialized;
         QQuickWorkerScript *owner;
         QV4::PersistentValue object;
+
+        // Guarded by m_lock
+        int pendingMessages;
+        qint64 busyTime;
     };
 
     QHash<int, WorkerScript *> workers;
     QV4::ReturnedValue getWorker(WorkerScript *);
 
     int m_nextId;
+    int m_scriptCount; // Only used by the thread owning the QQmlEngine
 
     static QV4::ReturnedValue method_sendMessage(QV4::CallContext *ctx);
 
@@ -190,7 +196,7 @@ protected:
     virtual bool event(QEvent *);
 
 private:
-    void processMessage(int, const QByteArray &);
+    void processMessage(int, const QV4::Serialize::Message &);
     void processLoad(int, const QUrl &);
     void reportScriptException(WorkerScript *, const QQmlError &error);
 };
@@ -277,7 +283,7 @@ QNetworkAccessManager *QQuickWorkerScriptEnginePrivate::WorkerEngine::networkAcc
 }
 
 QQuickWorkerScriptEnginePrivate::QQuickWorkerScriptEnginePrivate(QQmlEngine *engine)
-: workerEngine(0), qmlengine(engine), m_nextId(0)
+: workerEngine(0), qmlengine(engine), m_nextId(0), m_scriptCount(0)
 {
 }
 
@@ -289,7 +295,7 @@ QV4::ReturnedValue QQuickWorkerScriptEnginePrivate::method_sendMessage(QV4::Call
 
     QV4::Scope scope(ctx);
     QV4::ScopedValue v(scope, ctx->callData->argument(2));
-    QByteArray data = QV4::Serialize::serialize(v, engine);
+    QV4::Serialize::Message data = QV4::Serialize::serialize(v, engine);
 
     QMutexLocker locker(&engine->p->m_lock);
     WorkerScript *script = engine->p->workers.value(id);
@@ -340,6 +346,7 @@ bool QQuickWorkerScriptEnginePrivate::event(QEvent *event)
         return true;
     } else if (event->type() == (QEvent::Type)WorkerRemoveEvent::WorkerRemove) {
         WorkerRemoveEvent *workerEvent = static_cast<WorkerRemoveEvent *>(event);
+        QMutexLocker locker(&m_lock);
         QHash<int, WorkerScript *>::iterator itr = workers.find(workerEvent->workerId());
         if (itr != workers.end()) {
             delete itr.value();
@@ -351,12 +358,19 @@ bool QQuickWorkerScriptEnginePrivate::event(QEvent *event)
     }
 }
 
-void QQuickWorkerScriptEnginePrivate::processMessage(int id, const QByteArray &data)
+void QQuickWorkerScriptEnginePrivate::processMessage(int id, const QV4::Serialize::Message &data)
 {
     WorkerScript *script = workers.value(id);
     if (!script)
         return;
 
+    QElapsedTimer timer;
+    timer.start();
+
+    m_lock.lock();
+    --script->pendingMessages;
+    m_lock.unlock();
+
     QV4::ExecutionEngine *v4 = QV8Engine::getV4(workerEngine);
     QV4::Scope scope(v4);
     QV4::ScopedFunctionObject f(scope, workerEngine->onmessage.value());
@@ -373,6 +387,9 @@ void QQuickWorkerScriptEnginePrivate::processMessage(int id, const QByteArray &d
         QQmlError error = QV4::ExecutionEngine::catchExceptionAsQmlError(ctx);
         reportScriptException(script, error);
     }
+
+    QMutexLocker locker(&m_lock);
+    script->busyTime += timer.nsecsElapsed();
 }
 
 void QQuickWorkerScriptEnginePrivate::processLoad(int id, const QUrl &url)
@@ -433,7 +450,7 @@ void QQuickWorkerScriptEnginePrivate::reportScriptException(WorkerScript *script
         QCoreApplication::postEvent(script->owner, new WorkerErrorEvent(error));
 }
 
-WorkerDataEvent::WorkerDataEvent(int workerId, const QByteArray &data)
+WorkerDataEvent::WorkerDataEvent(int workerId, const QV4::Serialize::Message &data)
 : QEvent((QEvent::Type)WorkerData), m_id(workerId), m_data(data)
 {
 }
@@ -447,7 +464,7 @@ int WorkerDataEvent::workerId() const
     return m_id;
 }
 
-QByteArray WorkerDataEvent::data() const
+QV4::Serialize::Message WorkerDataEvent::data() const
 {
     return m_data;
 }
@@ -518,7 +535,7 @@ QQuickWorkerScriptEngine::~QQuickWorkerScriptEngine()
 }
 
 QQuickWorkerScriptEnginePrivate::WorkerScript::WorkerScript()
-: id(-1), initialized(false), owner(0)
+: id(-1), initialized(false), owner(0), pendingMessages(0), busyTime(0)
 {
 }
 
@@ -537,6 +554,7 @@ int QQuickWorkerScriptEngine::registerWorkerScript(QQuickWorkerScript *owner)
     d->m_lock.lock();
     d->workers.insert(script->id, script);
     d->m_lock.unlock();
+    ++d->m_scriptCount;
 
     return script->id;
 }
@@ -546,17 +564,42 @@ void QQuickWorkerScriptEngine::removeWorkerScript(int id)
     QQuickWorkerScriptEnginePrivate::WorkerScript* script = d->workers.value(id);
     if (script) {
         script->owner = 0;
+        --d->m_scriptCount;
         QCoreApplication::postEvent(d, new WorkerRemoveEvent(id));
     }
 }
 
+int QQuickWorkerScriptEngine::workerScriptCount() const
+{
+    return d->m_scriptCount;
+}
+
+int QQuickWorkerScriptEngine::pendingMessages(int id) const
+{
+    QMutexLocker locker(&d->m_lock);
+    QQuickWorkerScriptEnginePrivate::WorkerScript *script = d->workers.value(id);
+    return script ? script->pendingMessages : 0;
+}
+
+qint64 QQuickWorkerScriptEngine::busyTime(int id) const
+{
+    QMutexLocker locker(&d->m_lock);
+    QQuickWorkerScriptEnginePrivate::WorkerScript *script = d->workers.value(id);
+    return script ? script->busyTime : 0;
+}
+
 void QQuickWorkerScriptEngine::executeUrl(int id, const QUrl &url)
 {
     QCoreApplication::postEvent(d, new WorkerLoadEvent(id, url));
 }
 
-void QQuickWorkerScriptEngine::sendMessage(int id, const QByteArray &data)
+void QQuickWorkerScriptEngine::sendMessage(int id, const QV4::Serialize::Message &data)
 {
+    d->m_lock.lock();
+    if (QQuickWorkerScriptEnginePrivate::WorkerScript *script = d->workers.value(id))
+        ++script->pendingMessages;
+    d->m_lock.unlock();
+
     QCoreApplication::postEvent(d, new WorkerDataEvent(id, data));
 }
 
@@ -573,8 +616,10 @@ void QQuickWorkerScriptEngine::run()
 
     exec();
 
+    d->m_lock.lock();
     qDeleteAll(d->workers);
     d->workers.clear();
+    d->m_lock.unlock();
 
     delete d->workerEngine; d->workerEngine = 0;
 }
@@ -594,6 +639,16 @@ void QQuickWorkerScriptEngine::run()
     Messages can be passed between the new thread and the parent thread
     using \l sendMessage() and the \c onMessage() handler.
 
+    Worker scripts are spread over several threads, each with its own
+    JavaScript engine, so that busy scripts do not hold up each other. By
+    default up to four threads are used, depending on the number of CPU cores.
+    The limit can be changed with the \c QML_WORKERSCRIPT_THREADS environment
+    variable.
+
+    A \l ListModel passed to worker scripts can only be used by scripts
+    running on the same thread. If several worker scripts need to modify the
+    same model, set \c QML_WORKERSCRIPT_THREADS to 1.
+
     An example:
 
     \snippet qml/workerscript/workerscript.qml 0
@@ -693,6 +748,37 @@ void QQuickWorkerScript::sendMessage(QQmlV4Function *args)
         argument = (*args)[0];
 
     m_engine->sendMessage(m_scriptId, QV4::Serialize::serialize(argument, args->engine()));
+    emit statisticsChanged();
+}
+
+/*!
+    \qmlproperty int WorkerScript::pendingMessages
+    \since 5.4
+
+    This property holds the number of messages sent to the worker script
+    which it has not started to handle yet. A growing queue means the script
+    cannot keep up with the messages it is sent.
+
+    \sa busyTime
+*/
+int QQuickWorkerScript::pendingMessages() const
+{
+    return m_engine ? m_engine->pendingMessages(m_scriptId) : 0;
+}
+
+/*!
+    \qmlproperty real WorkerScript::busyTime
+    \since 5.4
+
+    This property holds the time in milliseconds that the worker thread has
+    spent handling messages sent to this worker script.
+
+    Both this property and \l pendingMessages are refreshed whenever a
+    message is sent or received.
+*/
+qreal QQuickWorkerScript::busyTime() const
+{
+    return m_engine ? m_engine->busyTime(m_scriptId) / 1000000. : 0.;
 }
 
 void QQuickWorkerScript::classBegin()
@@ -746,6 +832,7 @@ bool QQuickWorkerScript::event(QEvent *event)
             QV4::Scope scope(QV8Engine::getV4(v8engine));
             QV4::ScopedValue value(scope, QV4::Serialize::deserialize(workerEvent->data(), v8engine));
             emit message(QQmlV4Handle(value));
+            emit statisticsChanged();
         }
         return true;
     } else if (event->type() == (QEvent::Type)WorkerErrorEvent::WorkerError) {
@@ -59,6 +59,7 @@
 #include <QtCore/qthread.h>
 #include <QtQml/qjsvalue.h>
 #include <QtCore/qurl.h>
+#include <private/qv4serialize_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -75,7 +76,11 @@ public:
     int registerWorkerScript(QQuickWorkerScript *);
     void removeWorkerScript(int);
     void executeUrl(int, const QUrl &);
-    void sendMessage(int, const QByteArray &);
+    void sendMessage(int, const QV4::Serialize::Message &);
+
+    int workerScriptCount() const;
+    int pendingMessages(int) const;
+    qint64 busyTime(int) const;
 
 protected:
     virtual void run();
@@ -90,6 +95,8 @@ class Q_AUTOTEST_EXPORT QQuickWorkerScript : public QObject, public QQmlParserSt
 {
     Q_OBJECT
     Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(int pendingMessages READ pendingMessages NOTIFY statisticsChanged REVISION 1)
+    Q_PROPERTY(qreal busyTime READ busyTime NOTIFY statisticsChanged REVISION 1)
 
     Q_INTERFACES(QQmlParserStatus)
 public:
@@ -99,12 +106,16 @@ public:
     QUrl source() const;
     void setSource(const QUrl &);
 
+    int pendingMessages() const;
+    qreal busyTime() const;
+
 public Q_SLOTS:
     void sendMessage(QQmlV4Function*);
 
 Q_SIGNALS:
     void sourceChanged();
     void message(const QQmlV4Handle &messageObject);
+    Q_REVISION(1) void statisticsChanged();
 
 protected:
     virtual void classBegin();
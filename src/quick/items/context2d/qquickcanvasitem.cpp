@@ -845,6 +845,9 @@ void QQuickCanvasItem::requestPaint()
     Mark the given \a area as dirty, so that when this area is visible the
     canvas renderer will redraw it. This will trigger the \c paint signal.
 
+    With the \c Canvas.Image render target, only the given \a area of the
+    canvas is repainted and uploaded; drawing outside of it is discarded.
+
     \sa paint, requestPaint()
 */
 
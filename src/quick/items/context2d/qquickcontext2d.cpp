@@ -4063,7 +4063,7 @@ bool QQuickContext2D::isPointInPath(qreal x, qreal y) const
 
 QQuickContext2D::QQuickContext2D(QObject *parent)
     : QQuickCanvasContext(parent)
-    , m_buffer(new QQuickContext2DCommandBuffer)
+    , m_buffer(QQuickContext2DCommandBuffer::create())
     , m_v8engine(0)
     , m_surface(0)
     , m_glContext(0)
@@ -4074,7 +4074,7 @@ QQuickContext2D::QQuickContext2D(QObject *parent)
 
 QQuickContext2D::~QQuickContext2D()
 {
-    delete m_buffer;
+    QQuickContext2DCommandBuffer::release(m_buffer);
     m_texture->deleteLater();
 }
 
@@ -4176,7 +4176,7 @@ void QQuickContext2D::flush()
         else
             QCoreApplication::postEvent(m_texture, new QQuickContext2DTexture::PaintEvent(m_buffer));
     }
-    m_buffer = new QQuickContext2DCommandBuffer();
+    m_buffer = QQuickContext2DCommandBuffer::create();
 }
 
 QQuickContext2DTexture *QQuickContext2D::texture() const
@@ -258,77 +258,114 @@ static void qt_drawImage(QPainter *p, QQuickContext2D::State& state, QImage imag
     p->endNativePainting();
 }
 
-void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& state)
+/*
+    Commands whose device space bounds miss the paint device are skipped.
+    Tiles and bands replay the whole buffer into a small device each, so most
+    of the commands of a large canvas fall outside of any single one of them.
+*/
+static inline bool qt_isCulled(QPainter *p, const QRectF &deviceRect, const QRectF &bounds, qreal margin = 0)
+{
+    const QTransform &m = p->worldTransform();
+    if (deviceRect.isEmpty() || m.type() > QTransform::TxShear)
+        return false;
+    QRectF r = bounds.normalized().adjusted(-margin, -margin, margin, margin);
+    r = m.mapRect(r).adjusted(-1, -1, 1, 1);
+    return !r.intersects(deviceRect);
+}
+
+/*
+    Several threads can replay the same buffer at once. QPainterPath computes
+    its control point rect and vector path lazily and stores them in its
+    shared data without locking, so every replay works on a copy of its own.
+*/
+static inline QPainterPath qt_detachedPath(const QPainterPath &path)
+{
+    QPainterPath copy;
+    copy.setFillRule(path.fillRule());
+    copy.addPath(path);
+    return copy;
+}
+
+static inline qreal qt_strokeMargin(QPainter *p, const QQuickContext2D::State &state)
+{
+    return p->pen().widthF() * qMax(qreal(1), state.miterLimit);
+}
+
+void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& state) const
 {
     if (!p)
         return;
 
-    reset();
+    Reader r(this);
 
     QTransform originMatrix = p->worldTransform();
+    const QRectF deviceRect = p->device() ? QRectF(0, 0, p->device()->width(), p->device()->height()) : QRectF();
 
     QPen pen = makePen(state);
     setPainterState(p, state, pen);
 
-    while (hasNext()) {
-        QQuickContext2D::PaintCommand cmd = takeNextCommand();
+    while (r.hasNext()) {
+        QQuickContext2D::PaintCommand cmd = r.takeNextCommand();
         switch (cmd) {
         case QQuickContext2D::UpdateMatrix:
         {
-            state.matrix = takeMatrix();
+            state.matrix = r.takeMatrix();
             p->setWorldTransform(state.matrix * originMatrix);
             break;
         }
         case QQuickContext2D::ClearRect:
         {
+            QRectF rect = r.takeRect();
+            if (qt_isCulled(p, deviceRect, rect))
+                break;
             QPainter::CompositionMode  cm = p->compositionMode();
             p->setCompositionMode(QPainter::CompositionMode_Clear);
-            p->fillRect(takeRect(), Qt::white);
+            p->fillRect(rect, Qt::white);
             p->setCompositionMode(cm);
             break;
         }
         case QQuickContext2D::FillRect:
         {
-            QRectF r = takeRect();
+            QRectF rect = r.takeRect();
             if (HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor))
-                fillRectShadow(p, r, state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
-            else
-                p->fillRect(r, p->brush());
+                fillRectShadow(p, rect, state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
+            else if (!qt_isCulled(p, deviceRect, rect))
+                p->fillRect(rect, p->brush());
             break;
         }
         case QQuickContext2D::ShadowColor:
         {
-            state.shadowColor = takeColor();
+            state.shadowColor = r.takeColor();
             break;
         }
         case QQuickContext2D::ShadowBlur:
         {
-            state.shadowBlur = takeShadowBlur();
+            state.shadowBlur = r.takeShadowBlur();
             break;
         }
         case QQuickContext2D::ShadowOffsetX:
         {
-            state.shadowOffsetX = takeShadowOffsetX();
+            state.shadowOffsetX = r.takeShadowOffsetX();
             break;
         }
         case QQuickContext2D::ShadowOffsetY:
         {
-            state.shadowOffsetY = takeShadowOffsetY();
+            state.shadowOffsetY = r.takeShadowOffsetY();
             break;
         }
         case QQuickContext2D::FillStyle:
         {
-            state.fillStyle = takeFillStyle();
-            state.fillPatternRepeatX = takeBool();
-            state.fillPatternRepeatY = takeBool();
+            state.fillStyle = r.takeFillStyle();
+            state.fillPatternRepeatX = r.takeBool();
+            state.fillPatternRepeatY = r.takeBool();
             p->setBrush(state.fillStyle);
             break;
         }
         case QQuickContext2D::StrokeStyle:
         {
-            state.strokeStyle = takeStrokeStyle();
-            state.strokePatternRepeatX = takeBool();
-            state.strokePatternRepeatY = takeBool();
+            state.strokeStyle = r.takeStrokeStyle();
+            state.strokePatternRepeatX = r.takeBool();
+            state.strokePatternRepeatY = r.takeBool();
             QPen nPen = p->pen();
             nPen.setBrush(state.strokeStyle);
             p->setPen(nPen);
@@ -336,7 +373,7 @@ void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& s
         }
         case QQuickContext2D::LineWidth:
         {
-            state.lineWidth = takeLineWidth();
+            state.lineWidth = r.takeLineWidth();
             QPen nPen = p->pen();
 
             nPen.setWidthF(state.lineWidth);
@@ -345,7 +382,7 @@ void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& s
         }
         case QQuickContext2D::LineCap:
         {
-            state.lineCap = takeLineCap();
+            state.lineCap = r.takeLineCap();
             QPen nPen = p->pen();
             nPen.setCapStyle(state.lineCap);
             p->setPen(nPen);
@@ -353,7 +390,7 @@ void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& s
         }
         case QQuickContext2D::LineJoin:
         {
-            state.lineJoin = takeLineJoin();
+            state.lineJoin = r.takeLineJoin();
             QPen nPen = p->pen();
             nPen.setJoinStyle(state.lineJoin);
             p->setPen(nPen);
@@ -361,7 +398,7 @@ void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& s
         }
         case QQuickContext2D::MiterLimit:
         {
-            state.miterLimit = takeMiterLimit();
+            state.miterLimit = r.takeMiterLimit();
             QPen nPen = p->pen();
             nPen.setMiterLimit(state.miterLimit);
             p->setPen(nPen);
@@ -372,59 +409,66 @@ void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& s
             break;
         case QQuickContext2D::Fill:
         {
-            QPainterPath path = takePath();
+            QPainterPath path = qt_detachedPath(r.takePath());
             path.closeSubpath();
             if (HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor))
                 fillShadowPath(p,path, state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
-            else
+            else if (!qt_isCulled(p, deviceRect, path.controlPointRect()))
                 p->fillPath(path, p->brush());
             break;
         }
+        case QQuickContext2D::StrokeRect:
+        {
+            QRectF rect = r.takeRect();
+            const bool hasShadow = HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
+            if (!hasShadow && qt_isCulled(p, deviceRect, rect, qt_strokeMargin(p, state)))
+                break;
+            QPainterPath path;
+            path.addRect(rect);
+            if (hasShadow)
+                strokeShadowPath(p, path, state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
+            else
+                p->strokePath(path, p->pen());
+            break;
+        }
         case QQuickContext2D::Stroke:
         {
+            const QPainterPath path = qt_detachedPath(r.takePath());
             if (HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor))
-                strokeShadowPath(p,takePath(), state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
-            else
-                p->strokePath(takePath(), p->pen());
+                strokeShadowPath(p,path, state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
+            else if (!qt_isCulled(p, deviceRect, path.controlPointRect(), qt_strokeMargin(p, state)))
+                p->strokePath(path, p->pen());
             break;
         }
         case QQuickContext2D::Clip:
         {
-            state.clipPath = takePath();
+            state.clipPath = qt_detachedPath(r.takePath());
             p->setClipping(true);
             p->setClipPath(state.clipPath);
             break;
         }
         case QQuickContext2D::GlobalAlpha:
         {
-            state.globalAlpha = takeGlobalAlpha();
+            state.globalAlpha = r.takeGlobalAlpha();
             p->setOpacity(state.globalAlpha);
             break;
         }
         case QQuickContext2D::GlobalCompositeOperation:
         {
-            state.globalCompositeOperation = takeGlobalCompositeOperation();
+            state.globalCompositeOperation = r.takeGlobalCompositeOperation();
             p->setCompositionMode(state.globalCompositeOperation);
             break;
         }
         case QQuickContext2D::DrawImage:
-        {
-            QRectF sr = takeRect();
-            QRectF dr = takeRect();
-            qt_drawImage(p, state, takeImage(), sr, dr, HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor));
-            break;
-        }
         case QQuickContext2D::DrawPixmap:
         {
-            QRectF sr = takeRect();
-            QRectF dr = takeRect();
-
-            QQmlRefPointer<QQuickCanvasPixmap> pix = takePixmap();
-            Q_ASSERT(!pix.isNull());
-
+            QRectF sr = r.takeRect();
+            QRectF dr = r.takeRect();
+            const QImage &image = r.takeImage();
             const bool hasShadow = HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
-            //TODO: generate shadow blur with shaders
-            qt_drawImage(p, state, pix->image(), sr, dr, hasShadow);
+            if (!hasShadow && qt_isCulled(p, deviceRect, dr))
+                break;
+            qt_drawImage(p, state, image, sr, dr, hasShadow);
             break;
         }
         case QQuickContext2D::GetImageData:
@@ -441,17 +485,10 @@ void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& s
 }
 
 QQuickContext2DCommandBuffer::QQuickContext2DCommandBuffer()
-    : cmdIdx(0)
-    , intIdx(0)
-    , boolIdx(0)
-    , realIdx(0)
-    , rectIdx(0)
-    , colorIdx(0)
-    , matrixIdx(0)
-    , brushIdx(0)
-    , pathIdx(0)
-    , imageIdx(0)
-    , pixmapIdx(0)
+    : stream(0)
+    , streamSize(0)
+    , streamCapacity(0)
+    , commandCount(0)
 {
     static bool registered = false;
     if (!registered) {
@@ -463,37 +500,79 @@ QQuickContext2DCommandBuffer::QQuickContext2DCommandBuffer()
 
 QQuickContext2DCommandBuffer::~QQuickContext2DCommandBuffer()
 {
+    ::free(stream);
 }
 
-void QQuickContext2DCommandBuffer::clear()
+/*
+    Buffers are handed from the GUI thread to the texture, which may live on
+    the render thread, once per frame. Instead of allocating a fresh buffer
+    each time, finished buffers are parked here with their storage intact so
+    the next frame can record into memory that is already large enough.
+*/
+class QQuickContext2DCommandBufferPool
 {
-    commands.clear();
-    ints.clear();
-    bools.clear();
-    reals.clear();
-    rects.clear();
-    colors.clear();
-    matrixes.clear();
-    brushes.clear();
-    pathes.clear();
-    images.clear();
-    pixmaps.clear();
-    reset();
+public:
+    ~QQuickContext2DCommandBufferPool() { qDeleteAll(buffers); }
+
+    enum { MaxBuffers = 4 };
+
+    QMutex mutex;
+    QVector<QQuickContext2DCommandBuffer *> buffers;
+};
+
+Q_GLOBAL_STATIC(QQuickContext2DCommandBufferPool, qquick_context2d_buffer_pool)
+
+QQuickContext2DCommandBuffer *QQuickContext2DCommandBuffer::create()
+{
+    QQuickContext2DCommandBufferPool *pool = qquick_context2d_buffer_pool();
+    if (pool) {
+        QMutexLocker locker(&pool->mutex);
+        if (!pool->buffers.isEmpty()) {
+            QQuickContext2DCommandBuffer *buffer = pool->buffers.last();
+            pool->buffers.removeLast();
+            return buffer;
+        }
+    }
+    return new QQuickContext2DCommandBuffer;
 }
 
-void QQuickContext2DCommandBuffer::reset()
+void QQuickContext2DCommandBuffer::release(QQuickContext2DCommandBuffer *buffer)
+{
+    if (!buffer)
+        return;
+
+    buffer->clear();
+
+    QQuickContext2DCommandBufferPool *pool = qquick_context2d_buffer_pool();
+    if (pool) {
+        QMutexLocker locker(&pool->mutex);
+        if (pool->buffers.size() < QQuickContext2DCommandBufferPool::MaxBuffers) {
+            pool->buffers.append(buffer);
+            return;
+        }
+    }
+    delete buffer;
+}
+
+void QQuickContext2DCommandBuffer::growStream(int size)
+{
+    int capacity = qMax(streamCapacity, 256);
+    while (capacity < size)
+        capacity *= 2;
+    char *newStream = static_cast<char *>(::realloc(stream, capacity));
+    Q_CHECK_PTR(newStream);
+    stream = newStream;
+    streamCapacity = capacity;
+}
+
+void QQuickContext2DCommandBuffer::clear()
 {
-    cmdIdx = 0;
-    intIdx = 0;
-    boolIdx = 0;
-    realIdx = 0;
-    rectIdx = 0;
-    colorIdx = 0;
-    matrixIdx = 0;
-    brushIdx = 0;
-    pathIdx = 0;
-    imageIdx = 0;
-    pixmapIdx = 0;
+    // Keep the allocated capacity around for the next frame.
+    streamSize = 0;
+    commandCount = 0;
+    brushes.erase(brushes.begin(), brushes.end());
+    pathes.erase(pathes.begin(), pathes.end());
+    images.erase(images.begin(), images.end());
 }
 
 QT_END_NAMESPACE
@@ -43,6 +43,7 @@
 #define QQUICKCONTEXT2DCOMMANDBUFFER_P_H
 
 #include <QtCore/qmutex.h>
+#include <private/qtquickglobal_p.h>
 #include "qquickcontext2d_p.h"
 
 QT_BEGIN_NAMESPACE
@@ -50,112 +51,99 @@ QT_BEGIN_NAMESPACE
 class QQuickCanvasItem;
 class QMutex;
 
-class QQuickContext2DCommandBuffer
+class Q_QUICK_PRIVATE_EXPORT QQuickContext2DCommandBuffer
 {
 public:
     QQuickContext2DCommandBuffer();
     ~QQuickContext2DCommandBuffer();
-    void reset();
     void clear();
 
-    inline int size() {return commands.size();}
-    inline bool isEmpty() const {return commands.isEmpty(); }
-    inline bool hasNext() const {return cmdIdx < commands.size(); }
-    inline QQuickContext2D::PaintCommand takeNextCommand() { return commands[cmdIdx++]; }
+    static QQuickContext2DCommandBuffer *create();
+    static void release(QQuickContext2DCommandBuffer *buffer);
 
-    inline qreal takeGlobalAlpha() { return takeReal(); }
-    inline QPainter::CompositionMode takeGlobalCompositeOperation(){ return static_cast<QPainter::CompositionMode>(takeInt()); }
-    inline QBrush takeStrokeStyle() { return takeBrush(); }
-    inline QBrush takeFillStyle() { return takeBrush(); }
-
-    inline qreal takeLineWidth() { return takeReal(); }
-    inline Qt::PenCapStyle takeLineCap() { return static_cast<Qt::PenCapStyle>(takeInt());}
-    inline Qt::PenJoinStyle takeLineJoin(){ return static_cast<Qt::PenJoinStyle>(takeInt());}
-    inline qreal takeMiterLimit() { return takeReal(); }
+    inline int size() {return commandCount;}
+    inline bool isEmpty() const {return commandCount == 0; }
 
     inline void setGlobalAlpha( qreal alpha)
     {
-        commands << QQuickContext2D::GlobalAlpha;
-        reals << alpha;
+        writeCommand(QQuickContext2D::GlobalAlpha);
+        write(alpha);
     }
 
     inline void setGlobalCompositeOperation(QPainter::CompositionMode cm)
     {
-        commands << QQuickContext2D::GlobalCompositeOperation;
-        ints << cm;
+        writeCommand(QQuickContext2D::GlobalCompositeOperation);
+        write<int>(cm);
     }
 
     inline void setStrokeStyle(const QBrush &style, bool repeatX = false, bool repeatY = false)
     {
-        commands << QQuickContext2D::StrokeStyle;
+        writeCommand(QQuickContext2D::StrokeStyle);
         brushes << style;
-        bools << repeatX << repeatY;
+        write(repeatX);
+        write(repeatY);
     }
 
     inline void drawImage(const QImage& image,  const QRectF& sr, const QRectF& dr)
     {
-        commands << QQuickContext2D::DrawImage;
+        writeCommand(QQuickContext2D::DrawImage);
         images << image;
-        rects << sr << dr;
+        write(sr);
+        write(dr);
     }
 
+    // The pixmap is resolved to its image here, on the thread recording the
+    // commands. QQuickCanvasPixmap::image() caches without locking, so the
+    // replays, which may run on several threads at once, never call it.
     inline void drawPixmap(QQmlRefPointer<QQuickCanvasPixmap> pixmap, const QRectF& sr, const QRectF& dr)
     {
-        commands << QQuickContext2D::DrawPixmap;
-        pixmaps << pixmap;
-        rects << sr << dr;
+        writeCommand(QQuickContext2D::DrawPixmap);
+        images << pixmap->image();
+        write(sr);
+        write(dr);
     }
 
-    inline qreal takeShadowOffsetX() { return takeReal(); }
-    inline qreal takeShadowOffsetY() { return takeReal(); }
-    inline qreal takeShadowBlur() { return takeReal(); }
-    inline QColor takeShadowColor() { return takeColor(); }
-
-
     inline void updateMatrix(const QTransform& matrix)
     {
-        commands << QQuickContext2D::UpdateMatrix;
-        matrixes << matrix;
+        writeCommand(QQuickContext2D::UpdateMatrix);
+        write(matrix);
     }
 
     inline void clearRect(const QRectF& r)
     {
-        commands << QQuickContext2D::ClearRect;
-        rects << r;
+        writeCommand(QQuickContext2D::ClearRect);
+        write(r);
     }
 
     inline void fillRect(const QRectF& r)
     {
-        commands << QQuickContext2D::FillRect;
-        rects << r;
+        writeCommand(QQuickContext2D::FillRect);
+        write(r);
     }
 
     inline void strokeRect(const QRectF& r)
     {
-        QPainterPath p;
-        p.addRect(r);
-
-        commands << QQuickContext2D::Stroke;
-        pathes << p;
+        writeCommand(QQuickContext2D::StrokeRect);
+        write(r);
     }
 
 
     inline void fill(const QPainterPath& path)
     {
-        commands << QQuickContext2D::Fill;
+        writeCommand(QQuickContext2D::Fill);
         pathes << path;
 
     }
 
     inline void stroke(const QPainterPath& path)
     {
-        commands << QQuickContext2D::Stroke;
+        writeCommand(QQuickContext2D::Stroke);
         pathes << path;
     }
 
     inline void clip(const QPainterPath& path)
     {
-        commands << QQuickContext2D::Clip;
+        writeCommand(QQuickContext2D::Clip);
         pathes << path;
     }
 
@@ -163,102 +151,164 @@ public:
 
     inline void setFillStyle(const QBrush &style, bool repeatX = false, bool repeatY = false)
     {
-        commands << QQuickContext2D::FillStyle;
+        writeCommand(QQuickContext2D::FillStyle);
         brushes << style;
-        bools << repeatX << repeatY;
+        write(repeatX);
+        write(repeatY);
     }
 
 
     inline void setLineWidth( qreal w)
     {
-        commands << QQuickContext2D::LineWidth;
-        reals << w;
+        writeCommand(QQuickContext2D::LineWidth);
+        write(w);
     }
 
     inline void setLineCap(Qt::PenCapStyle  cap)
     {
-        commands << QQuickContext2D::LineCap;
-        ints << cap;
+        writeCommand(QQuickContext2D::LineCap);
+        write<int>(cap);
     }
 
     inline void setLineJoin(Qt::PenJoinStyle join)
     {
-        commands << QQuickContext2D::LineJoin;
-        ints << join;
+        writeCommand(QQuickContext2D::LineJoin);
+        write<int>(join);
     }
 
     inline void setMiterLimit( qreal limit)
     {
-        commands << QQuickContext2D::MiterLimit;
-        reals << limit;
+        writeCommand(QQuickContext2D::MiterLimit);
+        write(limit);
     }
 
     inline void setShadowOffsetX( qreal x)
     {
-        commands << QQuickContext2D::ShadowOffsetX;
-        reals << x;
+        writeCommand(QQuickContext2D::ShadowOffsetX);
+        write(x);
     }
 
     inline void setShadowOffsetY( qreal y)
     {
-        commands << QQuickContext2D::ShadowOffsetY;
-        reals << y;
+        writeCommand(QQuickContext2D::ShadowOffsetY);
+        write(y);
     }
 
     inline void setShadowBlur( qreal b)
     {
-        commands << QQuickContext2D::ShadowBlur;
-        reals << b;
+        writeCommand(QQuickContext2D::ShadowBlur);
+        write(b);
     }
 
     inline void setShadowColor(const QColor &color)
     {
-        commands << QQuickContext2D::ShadowColor;
-        colors << color;
+        writeCommand(QQuickContext2D::ShadowColor);
+        write(color);
     }
 
-    inline QTransform takeMatrix() { return matrixes[matrixIdx++]; }
+    void replay(QPainter* painter, QQuickContext2D::State& state) const;
 
-    inline QRectF takeRect() { return rects[rectIdx++]; }
+    // Reads the recorded commands back in order. Readers only keep their own
+    // position, so several of them may walk the same buffer at once.
+    class Reader
+    {
+    public:
+        Reader(const QQuickContext2DCommandBuffer *buffer)
+            : b(buffer), streamPos(0), brushIdx(0), pathIdx(0), imageIdx(0) {}
+
+        inline bool hasNext() const {return streamPos < b->streamSize; }
+        inline QQuickContext2D::PaintCommand takeNextCommand() { return static_cast<QQuickContext2D::PaintCommand>(read<quint32>()); }
+
+        inline qreal takeGlobalAlpha() { return takeReal(); }
+        inline QPainter::CompositionMode takeGlobalCompositeOperation(){ return static_cast<QPainter::CompositionMode>(takeInt()); }
+        inline QBrush takeStrokeStyle() { return takeBrush(); }
+        inline QBrush takeFillStyle() { return takeBrush(); }
+
+        inline qreal takeLineWidth() { return takeReal(); }
+        inline Qt::PenCapStyle takeLineCap() { return static_cast<Qt::PenCapStyle>(takeInt());}
+        inline Qt::PenJoinStyle takeLineJoin(){ return static_cast<Qt::PenJoinStyle>(takeInt());}
+        inline qreal takeMiterLimit() { return takeReal(); }
+
+        inline qreal takeShadowOffsetX() { return takeReal(); }
+        inline qreal takeShadowOffsetY() { return takeReal(); }
+        inline qreal takeShadowBlur() { return takeReal(); }
+        inline QColor takeShadowColor() { return takeColor(); }
+
+        inline QTransform takeMatrix() { return read<QTransform>(); }
+
+        inline QRectF takeRect() { return read<QRectF>(); }
+
+        inline const QPainterPath &takePath() { return b->pathes[pathIdx++]; }
+
+        inline const QImage& takeImage() { return b->images[imageIdx++]; }
+
+        inline int takeInt() { return read<int>(); }
+        inline bool takeBool() {return read<bool>(); }
+        inline qreal takeReal() { return read<qreal>(); }
+        inline QColor takeColor() { return read<QColor>(); }
+        inline QBrush takeBrush() { return b->brushes[brushIdx++]; }
+
+    private:
+        template <typename T>
+        inline T read()
+        {
+            const int offset = alignedOffset<T>(streamPos);
+            Q_ASSERT(offset + int(sizeof(T)) <= b->streamSize);
+            streamPos = offset + int(sizeof(T));
+            return *reinterpret_cast<const T *>(b->stream + offset);
+        }
+
+        const QQuickContext2DCommandBuffer *b;
+        int streamPos;
+        int brushIdx;
+        int pathIdx;
+        int imageIdx;
+    };
 
-    inline QPainterPath takePath() { return pathes[pathIdx++]; }
+private:
+    friend class Reader;
+
+    static QPen makePen(const QQuickContext2D::State& state);
+    static void setPainterState(QPainter* painter, const QQuickContext2D::State& state, const QPen& pen);
+
+    // Commands and their plain value arguments are stored back to back in a
+    // single byte stream, each value aligned to its own alignment. Only types
+    // that need no destructor may go into the stream; implicitly shared
+    // arguments (brushes, paths and images) live in the side arrays
+    // below and are consumed in command order.
+    template <typename T>
+    static inline int alignedOffset(int offset)
+    {
+        return (offset + int(Q_ALIGNOF(T)) - 1) & ~(int(Q_ALIGNOF(T)) - 1);
+    }
 
-    inline const QImage& takeImage() { return images[imageIdx++]; }
-    inline QQmlRefPointer<QQuickCanvasPixmap> takePixmap() { return pixmaps[pixmapIdx++]; }
+    template <typename T>
+    inline void write(const T &value)
+    {
+        const int offset = alignedOffset<T>(streamSize);
+        const int end = offset + int(sizeof(T));
+        if (end > streamCapacity)
+            growStream(end);
+        new (stream + offset) T(value);
+        streamSize = end;
+    }
 
-    inline int takeInt() { return ints[intIdx++]; }
-    inline bool takeBool() {return bools[boolIdx++]; }
-    inline qreal takeReal() { return reals[realIdx++]; }
-    inline QColor takeColor() { return colors[colorIdx++]; }
-    inline QBrush takeBrush() { return brushes[brushIdx++]; }
+    inline void writeCommand(QQuickContext2D::PaintCommand cmd)
+    {
+        write<quint32>(cmd);
+        ++commandCount;
+    }
+
+    void growStream(int size);
+
+    char *stream;
+    int streamSize;
+    int streamCapacity;
+    int commandCount;
 
-    void replay(QPainter* painter, QQuickContext2D::State& state);
-private:
-    QPen makePen(const QQuickContext2D::State& state);
-    void setPainterState(QPainter* painter, const QQuickContext2D::State& state, const QPen& pen);
-    int cmdIdx;
-    int intIdx;
-    int boolIdx;
-    int realIdx;
-    int rectIdx;
-    int colorIdx;
-    int matrixIdx;
-    int brushIdx;
-    int pathIdx;
-    int imageIdx;
-    int pixmapIdx;
-    QVector<QQuickContext2D::PaintCommand> commands;
-
-    QVector<int> ints;
-    QVector<bool> bools;
-    QVector<qreal> reals;
-    QVector<QRectF> rects;
-    QVector<QColor> colors;
-    QVector<QTransform> matrixes;
     QVector<QBrush> brushes;
     QVector<QPainterPath> pathes;
     QVector<QImage> images;
-    QVector<QQmlRefPointer<QQuickCanvasPixmap> > pixmaps;
     QMutex queueLock;
 };
 
@@ -44,12 +44,15 @@
 #include "qquickcanvasitem_p.h"
 #include <private/qquickitem_p.h>
 #include <QtQuick/private/qsgtexture_p.h>
+#include <QtQuick/private/qsgpainternode_p.h>
 #include "qquickcontext2dcommandbuffer_p.h"
 #include <QOpenGLPaintDevice>
 
 #include <QOpenGLFramebufferObject>
 #include <QOpenGLFramebufferObjectFormat>
 #include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QSemaphore>
 #include <QtGui/QGuiApplication>
 
 QT_BEGIN_NAMESPACE
@@ -172,6 +175,8 @@ bool QQuickContext2DTexture::setDirtyRect(const QRect &r)
         }
     } else {
         doDirty = m_canvasWindow.intersected(r).isValid();
+        if (doDirty)
+            m_dirtyRect |= r;
     }
     return doDirty;
 }
@@ -202,30 +207,142 @@ void QQuickContext2DTexture::canvasChanged(const QSize& canvasSize, const QSize&
     setAntialiasing(antialiasing);
 }
 
+static void qt_setupPainter(QPainter *p, bool smooth, bool antialiasing)
+{
+    if (antialiasing)
+        p->setRenderHints(QPainter::Antialiasing | QPainter::HighQualityAntialiasing | QPainter::TextAntialiasing, true);
+    else
+        p->setRenderHints(QPainter::Antialiasing | QPainter::HighQualityAntialiasing | QPainter::TextAntialiasing, false);
+
+    if (smooth)
+        p->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    else
+        p->setRenderHint(QPainter::SmoothPixmapTransform, false);
+
+    p->setCompositionMode(QPainter::CompositionMode_SourceOver);
+}
+
+Q_GLOBAL_STATIC(QThreadPool, qquick_context2d_raster_pool)
+
+// Raster canvases smaller than this are painted on the calling thread only
+static const int qquick_context2d_concurrent_pixels = 512 * 512;
+static const int qquick_context2d_min_band_height = 64;
+
+/*
+    One unit of concurrent rasterization: either a whole tile, or a band of
+    the canvas image wrapped in a QImage of its own. Every job replays the
+    complete command buffer from its own copy of the state, with commands
+    outside of the job's device culled by the replay.
+*/
+struct QQuickContext2DRasterJob
+{
+    QQuickContext2DRasterJob() : tile(0) {}
+
+    QQuickContext2DTile *tile;
+    QImage band;
+    QPoint bandOrigin;
+    QQuickContext2D::State state;
+};
+
+class QQuickContext2DRasterRunnable : public QRunnable
+{
+public:
+    QQuickContext2DRasterRunnable(const QQuickContext2DCommandBuffer *ccb, QVector<QQuickContext2DRasterJob> *jobs,
+                                  QAtomicInt *next, QSemaphore *done, bool smooth, bool antialiasing)
+        : ccb(ccb), jobs(jobs), next(next), done(done), smooth(smooth), antialiasing(antialiasing) {}
+
+    void run()
+    {
+        int i;
+        while ((i = next->fetchAndAddRelaxed(1)) < jobs->size()) {
+            QQuickContext2DRasterJob &job = (*jobs)[i];
+            if (job.tile) {
+                ccb->replay(job.tile->createPainter(smooth, antialiasing), job.state);
+            } else {
+                QPainter p(&job.band);
+                qt_setupPainter(&p, smooth, antialiasing);
+                p.translate(-job.bandOrigin);
+                ccb->replay(&p, job.state);
+            }
+        }
+        if (done)
+            done->release();
+    }
+
+private:
+    const QQuickContext2DCommandBuffer *ccb;
+    QVector<QQuickContext2DRasterJob> *jobs;
+    QAtomicInt *next;
+    QSemaphore *done;
+    bool smooth;
+    bool antialiasing;
+};
+
+static void qt_rasterConcurrently(const QQuickContext2DCommandBuffer *ccb, QVector<QQuickContext2DRasterJob> *jobs, bool smooth, bool antialiasing)
+{
+    QThreadPool *pool = qquick_context2d_raster_pool();
+    int workers = qMin(pool->maxThreadCount(), jobs->size() - 1);
+
+    // Canvases on other threads share the pool, so only wait for our own runnables
+    QAtomicInt next(0);
+    QSemaphore done;
+    for (int i = 0; i < workers; ++i)
+        pool->start(new QQuickContext2DRasterRunnable(ccb, jobs, &next, &done, smooth, antialiasing));
+    QQuickContext2DRasterRunnable(ccb, jobs, &next, 0, smooth, antialiasing).run();
+    done.acquire(workers);
+}
+
 void QQuickContext2DTexture::paintWithoutTiles(QQuickContext2DCommandBuffer *ccb)
 {
     if (!ccb || ccb->isEmpty())
         return;
 
+    const bool windowChanged = m_canvasWindowChanged;
     QPaintDevice* device = beginPainting();
     if (!device) {
         endPainting();
         return;
     }
 
-    QPainter p;
-    p.begin(device);
-    if (m_antialiasing)
-        p.setRenderHints(QPainter::Antialiasing | QPainter::HighQualityAntialiasing | QPainter::TextAntialiasing, true);
-    else
-        p.setRenderHints(QPainter::Antialiasing | QPainter::HighQualityAntialiasing | QPainter::TextAntialiasing, false);
+    // The image target only repaints the dirty part of the canvas. That part
+    // is wrapped in QImages of its own, so nothing outside of it is touched,
+    // and a large one is split into bands of rows rasterized in parallel.
+    if (renderTarget() == QQuickCanvasItem::Image) {
+        QImage *image = static_cast<QImage *>(device);
+        QRect region = image->rect();
+        if (m_dirtyRect.isValid() && !windowChanged)
+            region &= m_dirtyRect.translated(-m_canvasWindow.topLeft());
+        m_dirtyRect = QRect();
+        m_updatedRect = region;
+        if (region.isEmpty()) {
+            endPainting();
+            return;
+        }
 
-    if (m_smooth)
-        p.setRenderHint(QPainter::SmoothPixmapTransform, true);
-    else
-        p.setRenderHint(QPainter::SmoothPixmapTransform, false);
+        int bands = 1;
+        if (region.width() * region.height() >= qquick_context2d_concurrent_pixels)
+            bands = qBound(1, qMin(QThread::idealThreadCount(), region.height() / qquick_context2d_min_band_height), region.height());
+
+        const int bpl = image->bytesPerLine();
+        uchar *bits = image->bits() + region.left() * (image->depth() / 8);
+        QVector<QQuickContext2DRasterJob> jobs(bands);
+        for (int i = 0; i < bands; ++i) {
+            const int top = region.top() + region.height() * i / bands;
+            const int bottom = region.top() + region.height() * (i + 1) / bands;
+            jobs[i].band = QImage(bits + top * bpl, region.width(), bottom - top, bpl, image->format());
+            jobs[i].bandOrigin = QPoint(region.left(), top);
+            jobs[i].state = m_state;
+        }
+        qt_rasterConcurrently(ccb, &jobs, m_smooth, m_antialiasing);
+        m_state = jobs.first().state;
+        endPainting();
+        markDirtyTexture();
+        return;
+    }
 
-    p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    QPainter p;
+    p.begin(device);
+    qt_setupPainter(&p, m_smooth, m_antialiasing);
 
     ccb->replay(&p, m_state);
     endPainting();
@@ -240,7 +357,7 @@ bool QQuickContext2DTexture::canvasDestroyed()
 void QQuickContext2DTexture::paint(QQuickContext2DCommandBuffer *ccb)
 {
     if (canvasDestroyed()) {
-        delete ccb;
+        QQuickContext2DCommandBuffer::release(ccb);
         return;
     }
 
@@ -248,38 +365,54 @@ void QQuickContext2DTexture::paint(QQuickContext2DCommandBuffer *ccb)
 
     if (!m_tiledCanvas) {
         paintWithoutTiles(ccb);
-        delete ccb;
+        QQuickContext2DCommandBuffer::release(ccb);
         return;
     }
 
     QRect tiledRegion = createTiles(m_canvasWindow.intersected(QRect(QPoint(0, 0), m_canvasSize)));
     if (!tiledRegion.isEmpty()) {
-        QRect dirtyRect;
-        foreach (QQuickContext2DTile* tile, m_tiles) {
-            if (tile->dirty()) {
-                if (dirtyRect.isEmpty())
-                    dirtyRect = tile->rect();
-                else
-                    dirtyRect |= tile->rect();
-            }
-        }
+        // Clean tiles are already in the image unless it was just recreated
+        const bool compositeAll = m_canvasWindowChanged || renderTarget() != QQuickCanvasItem::Image;
+        m_updatedRect = compositeAll ? QRect(QPoint(0, 0), m_canvasWindow.size()) : QRect();
 
         if (beginPainting()) {
             QQuickContext2D::State oldState = m_state;
+            if (renderTarget() == QQuickCanvasItem::Image) {
+                // Image tiles need no GL context, so the dirty ones are
+                // rasterized in parallel and composited afterwards.
+                QVector<QQuickContext2DRasterJob> jobs;
+                foreach (QQuickContext2DTile* tile, m_tiles) {
+                    if (tile->dirty()) {
+                        QQuickContext2DRasterJob job;
+                        job.tile = tile;
+                        job.state = m_state;
+                        jobs.append(job);
+                    }
+                }
+                if (!jobs.isEmpty()) {
+                    qt_rasterConcurrently(ccb, &jobs, m_smooth, m_antialiasing);
+                    oldState = jobs.first().state;
+                }
+            }
             foreach (QQuickContext2DTile* tile, m_tiles) {
-                if (tile->dirty()) {
-                    ccb->replay(tile->createPainter(m_smooth, m_antialiasing), oldState);
+                const bool dirty = tile->dirty();
+                if (dirty) {
+                    if (renderTarget() != QQuickCanvasItem::Image)
+                        ccb->replay(tile->createPainter(m_smooth, m_antialiasing), oldState);
                     tile->drawFinished();
                     tile->markDirty(false);
                 }
-                compositeTile(tile);
+                if (dirty || compositeAll)
+                    compositeTile(tile);
+                if (dirty && !compositeAll)
+                    m_updatedRect |= tile->rect().intersected(m_canvasWindow).translated(-m_canvasWindow.topLeft());
             }
             endPainting();
             m_state = oldState;
             markDirtyTexture();
         }
     }
-    delete ccb;
+    QQuickContext2DCommandBuffer::release(ccb);
 }
 
 QRect QQuickContext2DTexture::tiledRect(const QRectF& window, const QSize& tileSize)
@@ -620,6 +753,7 @@ void QQuickContext2DFBOTexture::endPainting()
 
 QQuickContext2DImageTexture::QQuickContext2DImageTexture()
     : QQuickContext2DTexture()
+    , m_imageRecreated(false)
 {
 }
 
@@ -647,18 +781,22 @@ void QQuickContext2DImageTexture::grabImage(const QRectF& rf)
 
 QSGTexture *QQuickContext2DImageTexture::textureForNextFrame(QSGTexture *last)
 {
-    QSGPlainTexture *texture = static_cast<QSGPlainTexture *>(last);
+    QSGPainterTexture *texture = static_cast<QSGPainterTexture *>(last);
 
     if (m_onCustomThread)
         m_mutex.lock();
 
     if (!texture) {
-        texture = new QSGPlainTexture();
+        texture = new QSGPainterTexture();
         texture->setHasAlphaChannel(true);
         m_dirtyTexture = true;
+        m_displayDirtyRect = m_displayImage.rect();
     }
     if (m_dirtyTexture) {
+        // Only the part painted since the last frame needs uploading
         texture->setImage(m_displayImage);
+        texture->setDirtyRect(m_displayDirtyRect);
+        m_displayDirtyRect = QRect();
         m_dirtyTexture = false;
     }
 
@@ -679,6 +817,7 @@ QPaintDevice* QQuickContext2DImageTexture::beginPainting()
         m_image = QImage(m_canvasWindow.size(), QImage::Format_ARGB32_Premultiplied);
         m_image.fill(0x00000000);
         m_canvasWindowChanged = false;
+        m_imageRecreated = true;
     }
 
     return &m_image;
@@ -690,6 +829,12 @@ void QQuickContext2DImageTexture::endPainting()
     if (m_onCustomThread)
         m_mutex.lock();
     m_displayImage = m_image;
+    if (m_imageRecreated)
+        m_displayDirtyRect = m_image.rect();
+    else if (m_updatedRect.isValid())
+        m_displayDirtyRect |= m_updatedRect;
+    m_imageRecreated = false;
+    m_updatedRect = QRect();
     if (m_onCustomThread)
         m_mutex.unlock();
 }
@@ -142,6 +142,8 @@ protected:
     QSize m_canvasSize;
     QSize m_tileSize;
     QRect m_canvasWindow;
+    QRect m_dirtyRect;      // Canvas area still to be repainted, untiled canvases only
+    QRect m_updatedRect;    // Image area changed by the last paint
 
     QMutex m_mutex;
     QWaitCondition m_condition;
@@ -211,7 +213,9 @@ public Q_SLOTS:
 private:
     QImage m_image;
     QImage m_displayImage;
+    QRect m_displayDirtyRect;
     QPainter m_painter;
+    bool m_imageRecreated;
 };
 
 QT_END_NAMESPACE
@@ -44,8 +44,9 @@
 
 #include <private/qtquickglobal_p.h>
 #include <QtQuick/qsgnode.h>
+#include <QtQuick/private/qsgpoolallocator_p.h>
 
-class Q_QUICK_PRIVATE_EXPORT QQuickDefaultClipNode : public QSGClipNode
+class Q_QUICK_PRIVATE_EXPORT QQuickDefaultClipNode : public QSGClipNode, public QSGPooledAllocation
 {
 public:
     QQuickDefaultClipNode(const QRectF &);
@@ -70,18 +70,27 @@ class QQuickFlipablePrivate : public QQuickItemPrivate
 {
     Q_DECLARE_PUBLIC(QQuickFlipable)
 public:
-    QQuickFlipablePrivate() : current(QQuickFlipable::Front), front(0), back(0), sideDirty(false) {}
+    QQuickFlipablePrivate()
+        : current(QQuickFlipable::Front), pendingSide(QQuickFlipable::Front), front(0), back(0)
+        , sideDirty(false), sidePending(false)
+    {
+        hasConcurrentPolish = true;
+    }
 
     virtual void transformChanged();
+    virtual void concurrentPolish();
+    QQuickFlipable::Side computeSide();
     void updateSide();
     void setBackTransform();
 
     QQuickFlipable::Side current;
+    QQuickFlipable::Side pendingSide;
     QPointer<QQuickLocalTransform> backTransform;
     QPointer<QQuickItem> front;
     QPointer<QQuickItem> back;
 
     bool sideDirty;
+    bool sidePending;
     bool wantBackXFlipped;
     bool wantBackYFlipped;
 };
@@ -224,19 +233,29 @@ void QQuickFlipablePrivate::transformChanged()
         sideDirty = true;
         q->polish();
     }
+    sidePending = false;
 
     QQuickItemPrivate::transformChanged();
 }
 
+/*
+    Only reads the flipable's own geometry and transforms, so the side can
+    be worked out on a polish worker. updateSide() applies it afterwards.
+ */
+void QQuickFlipablePrivate::concurrentPolish()
+{
+    if (!sideDirty)
+        return;
+    pendingSide = computeSide();
+    sidePending = true;
+}
+
 void QQuickFlipable::updatePolish()
 {
     Q_D(QQuickFlipable);
     d->updateSide();
 }
 
-// determination on the currently visible side of the flipable
-// has to be done on the complete scene transform to give
-// correct results.
 void QQuickFlipablePrivate::updateSide()
 {
     Q_Q(QQuickFlipable);
@@ -246,6 +265,26 @@ void QQuickFlipablePrivate::updateSide()
 
     sideDirty = false;
 
+    QQuickFlipable::Side newSide = sidePending ? pendingSide : computeSide();
+    sidePending = false;
+
+    if (newSide != current) {
+        current = newSide;
+        if (current == QQuickFlipable::Back && back)
+            setBackTransform();
+        if (front)
+            front->setOpacity((current==QQuickFlipable::Front)?1.:0.);
+        if (back)
+            back->setOpacity((current==QQuickFlipable::Back)?1.:0.);
+        emit q->sideChanged();
+    }
+}
+
+// determination on the currently visible side of the flipable
+// has to be done on the complete scene transform to give
+// correct results.
+QQuickFlipable::Side QQuickFlipablePrivate::computeSide()
+{
     QTransform sceneTransform;
     itemToParentTransform(sceneTransform);
 
@@ -268,23 +307,9 @@ void QQuickFlipablePrivate::updateSide()
     wantBackYFlipped = scenep1.x() >= scenep2.x();
     wantBackXFlipped = scenep2.y() >= scenep3.y();
 
-    QQuickFlipable::Side newSide;
-    if (cross > 0) {
-        newSide = QQuickFlipable::Back;
-    } else {
-        newSide = QQuickFlipable::Front;
-    }
-
-    if (newSide != current) {
-        current = newSide;
-        if (current == QQuickFlipable::Back && back)
-            setBackTransform();
-        if (front)
-            front->setOpacity((current==QQuickFlipable::Front)?1.:0.);
-        if (back)
-            back->setOpacity((current==QQuickFlipable::Back)?1.:0.);
-        emit q->sideChanged();
-    }
+    if (cross > 0)
+        return QQuickFlipable::Back;
+    return QQuickFlipable::Front;
 }
 
 /* Depends on the width/height of the back item, and so needs reevaulating
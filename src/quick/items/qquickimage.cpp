@@ -797,4 +797,60 @@ void QQuickImage::setMipmap(bool use)
     update();
 }
 
+/*!
+    \qmlproperty rect QtQuick::Image::sourceClipRect
+    \since 5.4
+
+    This property, if set, holds the rectangular region of the source image
+    to be loaded.
+
+    Only the requested part of the image is decoded and kept in memory, which
+    makes it possible to show parts of very large images, for example by
+    splitting them into tiles inside a \l Flickable:
+
+    \code
+    Image {
+        source: "reallyBigImage.jpg"
+        sourceClipRect: Qt.rect(1024, 2048, 512, 512)
+    }
+    \endcode
+
+    The rectangle is normally in the coordinate system of the source image.
+    If \l sourceSize is also set and the image is scaled down to fit it, or
+    the source is an SVG image, which is always scaled to \l sourceSize, the
+    rectangle is in the coordinate system of the scaled image instead. Since
+    images are never scaled up, a \l sourceSize larger than the source image
+    leaves the rectangle in source image coordinates. The implicit size of the
+    Image is the size of the loaded region.
+
+    Image formats whose decoder supports clipping, such as JPEG, skip the work
+    for the parts outside of the region. This property has no effect on images
+    from an image provider.
+
+    By default, this property holds an invalid rectangle and the whole image
+    is loaded.
+*/
+QRectF QQuickImage::sourceClipRect() const
+{
+    Q_D(const QQuickImage);
+    return d->sourceClipRect;
+}
+
+void QQuickImage::setSourceClipRect(const QRectF &rect)
+{
+    Q_D(QQuickImage);
+    if (d->sourceClipRect == rect)
+        return;
+
+    d->sourceClipRect = rect;
+    emit sourceClipRectChanged();
+    if (isComponentComplete())
+        load();
+}
+
+void QQuickImage::resetSourceClipRect()
+{
+    setSourceClipRect(QRectF());
+}
+
 QT_END_NAMESPACE
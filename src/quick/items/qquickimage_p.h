@@ -61,6 +61,7 @@ class Q_AUTOTEST_EXPORT QQuickImage : public QQuickImageBase
     Q_PROPERTY(HAlignment horizontalAlignment READ horizontalAlignment WRITE setHorizontalAlignment NOTIFY horizontalAlignmentChanged)
     Q_PROPERTY(VAlignment verticalAlignment READ verticalAlignment WRITE setVerticalAlignment NOTIFY verticalAlignmentChanged)
     Q_PROPERTY(bool mipmap READ mipmap WRITE setMipmap NOTIFY mipmapChanged REVISION 1)
+    Q_PROPERTY(QRectF sourceClipRect READ sourceClipRect WRITE setSourceClipRect RESET resetSourceClipRect NOTIFY sourceClipRectChanged REVISION 2)
 
 public:
     QQuickImage(QQuickItem *parent=0);
@@ -95,12 +96,17 @@ public:
     bool mipmap() const;
     void setMipmap(bool use);
 
+    QRectF sourceClipRect() const;
+    void setSourceClipRect(const QRectF &rect);
+    void resetSourceClipRect();
+
 Q_SIGNALS:
     void fillModeChanged();
     void paintedGeometryChanged();
     void horizontalAlignmentChanged(HAlignment alignment);
     void verticalAlignmentChanged(VAlignment alignment);
     Q_REVISION(1) void mipmapChanged(bool);
+    Q_REVISION(2) void sourceClipRectChanged();
 
 protected:
     QQuickImage(QQuickImagePrivate &dd, QQuickItem *parent);
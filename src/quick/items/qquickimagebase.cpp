@@ -219,7 +219,13 @@ void QQuickImageBase::load()
 
         QUrl loadUrl = d->url;
         resolve2xLocalFile(d->url, targetDevicePixelRatio, &loadUrl, &d->devicePixelRatio);
-        d->pix.load(qmlEngine(this), loadUrl, d->sourcesize * d->devicePixelRatio, options);
+        d->pix.setVisible(isVisible());
+        QRect loadRegion;
+        if (d->sourceClipRect.isValid()) {
+            loadRegion = QRectF(d->sourceClipRect.topLeft() * d->devicePixelRatio,
+                                d->sourceClipRect.size() * d->devicePixelRatio).toAlignedRect();
+        }
+        d->pix.load(qmlEngine(this), loadUrl, loadRegion, d->sourcesize * d->devicePixelRatio, options);
 
         if (d->pix.isLoading()) {
             if (d->progress != 0.0) {
@@ -307,6 +313,15 @@ void QQuickImageBase::componentComplete()
         load();
 }
 
+void QQuickImageBase::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    Q_D(QQuickImageBase);
+    // Pending loads of hidden images yield to the visible ones.
+    if (change == ItemVisibleHasChanged)
+        d->pix.setVisible(value.boolValue);
+    QQuickImplicitSizeItem::itemChange(change, value);
+}
+
 void QQuickImageBase::pixmapChange()
 {
     Q_D(QQuickImageBase);
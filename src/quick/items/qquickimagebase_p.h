@@ -100,6 +100,7 @@ Q_SIGNALS:
 protected:
     virtual void load();
     virtual void componentComplete();
+    virtual void itemChange(ItemChange change, const ItemChangeData &value);
     virtual void pixmapChange();
     QQuickImageBase(QQuickImageBasePrivate &dd, QQuickItem *parent);
 
@@ -82,6 +82,7 @@ public:
     qreal progress;
     QSize sourcesize;
     QSize oldSourceSize;
+    QRectF sourceClipRect;
     qreal devicePixelRatio;
     bool async : 1;
     bool cache : 1;
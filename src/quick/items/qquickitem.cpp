@@ -68,6 +68,7 @@
 #include <private/qquickitem_p.h>
 #include <private/qqmlaccessors_p.h>
 #include <QtQuick/private/qquickaccessibleattached_p.h>
+#include <QtQuick/private/qsgpoolallocator_p.h>
 
 #include <private/qv4engine_p.h>
 #include <private/qv4object_p.h>
@@ -2792,6 +2793,7 @@ QQuickItemPrivate::QQuickItemPrivate()
     , activeFocusOnTab(false)
     , implicitAntialiasing(false)
     , antialiasingValid(false)
+    , hasConcurrentPolish(false)
     , dirtyAttributes(0)
     , nextDirtyItem(0)
     , prevDirtyItem(0)
@@ -3459,7 +3461,7 @@ void QQuickItem::releaseResources()
 
 QSGTransformNode *QQuickItemPrivate::createTransformNode()
 {
-    return new QSGTransformNode;
+    return new QSGPooledNode<QSGTransformNode>;
 }
 
 /*!
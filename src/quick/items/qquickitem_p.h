@@ -424,6 +424,7 @@ public:
     bool activeFocusOnTab:1;
     bool implicitAntialiasing:1;
     bool antialiasingValid:1;
+    bool hasConcurrentPolish:1;
 
     enum DirtyType {
         TransformOrigin         = 0x00000001,
@@ -582,6 +583,12 @@ public:
 
     virtual void mirrorChange() {}
 
+    // Items setting hasConcurrentPolish have concurrentPolish() called before
+    // updatePolish(), possibly on a worker thread and in parallel with other
+    // items. It may only compute into state private to the item; updatePolish()
+    // then commits the result on the GUI thread.
+    virtual void concurrentPolish() {}
+
     void incrementCursorCount(int delta);
 
     // recursive helper to let a visual parent mark its visual children
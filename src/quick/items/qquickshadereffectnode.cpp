@@ -46,6 +46,7 @@
 #include <QtQuick/qsgtextureprovider.h>
 #include <QtQuick/private/qsgrenderer_p.h>
 #include <QtQuick/private/qsgshadersourcebuilder_p.h>
+#include <QtQuick/private/qsgshadercache_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -242,6 +243,12 @@ void QQuickCustomMaterialShader::compile()
 
     m_log.clear();
     m_compiled = true;
+
+    // A cached binary already carries the attribute locations it was linked with
+    char const *const *attr = attributeNames();
+    if (QSGShaderCache::load(program(), vertexShader(), fragmentShader(), attr))
+        return;
+
     if (!program()->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShader())) {
         m_log += QLatin1String("*** Vertex shader ***\n");
         m_log += program()->log();
@@ -253,7 +260,6 @@ void QQuickCustomMaterialShader::compile()
         m_compiled = false;
     }
 
-    char const *const *attr = attributeNames();
 #ifndef QT_NO_DEBUG
     int maxVertexAttribs = 0;
     glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxVertexAttribs);
@@ -278,8 +284,11 @@ void QQuickCustomMaterialShader::compile()
             if (*attr[i])
                 program()->bindAttributeLocation(attr[i], i);
         }
+        QSGShaderCache::prepare(program());
         m_compiled = program()->link();
         m_log += program()->log();
+        if (m_compiled)
+            QSGShaderCache::store(program(), vertexShader(), fragmentShader(), attr);
     }
 
     if (!m_compiled) {
@@ -43,6 +43,7 @@
 #define QQUICKTEXTNODE_P_H
 
 #include <QtQuick/qsgnode.h>
+#include <QtQuick/private/qsgpoolallocator_p.h>
 #include "qquicktext_p.h"
 #include <qglyphrun.h>
 
@@ -65,7 +66,7 @@ class QSGTexture;
 
 class QQuickTextNodeEngine;
 
-class QQuickTextNode : public QSGTransformNode
+class QQuickTextNode : public QSGTransformNode, public QSGPooledAllocation
 {
 public:
     enum Decoration {
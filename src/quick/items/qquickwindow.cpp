@@ -50,6 +50,7 @@
 
 #include <QtQuick/private/qsgrenderer_p.h>
 #include <QtQuick/private/qsgtexture_p.h>
+#include <QtQuick/private/qsgpoolallocator_p.h>
 #include <private/qsgrenderloop_p.h>
 #include <private/qquickrendercontrol_p.h>
 #include <private/qquickanimatorcontroller_p.h>
@@ -66,6 +67,8 @@
 #include <QtCore/qvarlengtharray.h>
 #include <QtCore/qabstractanimation.h>
 #include <QtCore/QLibraryInfo>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
 #include <QtQml/qqmlincubator.h>
 
 #include <QtQuick/private/qquickpixmapcache_p.h>
@@ -257,6 +260,63 @@ void QQuickWindow::focusInEvent(QFocusEvent *ev)
     d->updateFocusItemTransform();
 }
 
+// Below this many items, handing the work to other threads costs more than it saves.
+static const int qquick_concurrent_polish_threshold = 4;
+
+Q_GLOBAL_STATIC(QThreadPool, qquick_polish_pool)
+
+class QQuickConcurrentPolishRunnable : public QRunnable
+{
+public:
+    QQuickConcurrentPolishRunnable(const QVector<QQuickItemPrivate *> &items, QAtomicInt *next)
+        : items(items), next(next) {}
+
+    void run()
+    {
+        int i;
+        while ((i = next->fetchAndAddRelaxed(1)) < items.size())
+            items.at(i)->concurrentPolish();
+    }
+
+private:
+    const QVector<QQuickItemPrivate *> &items;
+    QAtomicInt *next;
+};
+
+/*
+    Runs the concurrentPolish() step of the items that have one. The GUI
+    thread takes part in the work and this function returns only once all
+    items are done, so updatePolish() always sees the finished result.
+ */
+static void qquick_concurrent_polish(const QSet<QQuickItem *> &itms)
+{
+    QVector<QQuickItemPrivate *> items;
+    for (QSet<QQuickItem *>::const_iterator it = itms.constBegin(); it != itms.constEnd(); ++it) {
+        QQuickItemPrivate *d = QQuickItemPrivate::get(*it);
+        if (d->hasConcurrentPolish)
+            items.append(d);
+    }
+
+    if (items.isEmpty())
+        return;
+
+    QThreadPool *pool = qquick_polish_pool();
+    int workers = qMin(pool->maxThreadCount(), items.size() / qquick_concurrent_polish_threshold);
+    if (workers < 1) {
+        for (int i = 0; i < items.size(); ++i)
+            items.at(i)->concurrentPolish();
+        return;
+    }
+
+    QAtomicInt next(0);
+    for (int i = 0; i < workers; ++i) {
+        QQuickConcurrentPolishRunnable *r = new QQuickConcurrentPolishRunnable(items, &next);
+        pool->start(r);
+    }
+    QQuickConcurrentPolishRunnable(items, &next).run();
+    pool->waitForDone();
+}
+
 void QQuickWindowPrivate::polishItems()
 {
     int maxPolishCycles = 100000;
@@ -265,6 +325,8 @@ void QQuickWindowPrivate::polishItems()
         QSet<QQuickItem *> itms = itemsToPolish;
         itemsToPolish.clear();
 
+        qquick_concurrent_polish(itms);
+
         for (QSet<QQuickItem *>::iterator it = itms.begin(); it != itms.end(); ++it) {
             QQuickItem *item = *it;
             QQuickItemPrivate::get(item)->polishScheduled = false;
@@ -2633,7 +2695,7 @@ void QQuickWindowPrivate::updateDirtyNode(QQuickItem *item)
                       ? itemPriv->opacity() : qreal(0);
 
         if (opacity != 1 && !itemPriv->opacityNode()) {
-            itemPriv->extra.value().opacityNode = new QSGOpacityNode;
+            itemPriv->extra.value().opacityNode = new QSGPooledNode<QSGOpacityNode>;
 
             QSGNode *parent = itemPriv->itemNode();
             QSGNode *child = itemPriv->clipNode();
@@ -211,6 +211,32 @@ public:
     QQuickRenderControl *renderControl;
     QQuickAnimatorController *animationController;
 
+    // Timings of the last frame, filled in by render loops that measure
+    // them. Only accessed on the GUI thread. Times are in nanoseconds.
+    struct FrameTiming {
+        FrameTiming()
+            : polishTime(0)
+            , lockTime(0)
+            , syncTime(0)
+            , animationTime(0)
+            , renderTime(0)
+            , frameDelta(0)
+            , frameCount(0)
+            , missedFrames(0)
+        {
+        }
+
+        qint64 polishTime;
+        qint64 lockTime;
+        qint64 syncTime;
+        qint64 animationTime;
+        qint64 renderTime;
+        qint64 frameDelta;
+        int frameCount;
+        int missedFrames;
+    };
+    FrameTiming frameTiming;
+
     QColor clearColor;
 
     uint clearBeforeRendering : 1;
@@ -43,6 +43,10 @@
 #include "qsgbatchrenderer_p.h"
 #include <private/qsgshadersourcebuilder_p.h>
 
+#include <QtQuick/qsgflatcolormaterial.h>
+#include <QtQuick/qsgtexturematerial.h>
+#include <QtQuick/qsgvertexcolormaterial.h>
+
 #include <QQuickWindow>
 
 #include <qmath.h>
@@ -78,6 +82,7 @@ const bool debug_dump       = qgetenv("QSG_RENDERER_DEBUG").contains("dump");
 const bool debug_noalpha    = qgetenv("QSG_RENDERER_DEBUG").contains("noalpha");
 const bool debug_noopaque   = qgetenv("QSG_RENDERER_DEBUG").contains("noopaque");
 const bool debug_noclip     = qgetenv("QSG_RENDERER_DEBUG").contains("noclip");
+const bool debug_noocclusion = qgetenv("QSG_RENDERER_DEBUG").contains("noocclusion");
 
 #ifndef QSG_NO_RENDER_TIMING
 static bool qsg_render_timing = !qgetenv("QSG_RENDER_TIMING").isEmpty();
@@ -125,6 +130,7 @@ struct QMatrix4x4_Accessor
 };
 
 const float OPAQUE_LIMIT                = 0.999f;
+const int MAX_OCCLUDERS                 = 8;
 
 ShaderManager::Shader *ShaderManager::prepareMaterial(QSGMaterial *material)
 {
@@ -282,6 +288,7 @@ void Updater::updateStates(QSGNode *n)
     m_current_clip = 0;
 
     m_added = 0;
+    m_addedTop = 0;
     m_transformChange = 0;
     m_opacityChange = 0;
 
@@ -315,8 +322,11 @@ void Updater::visitNode(Node *n)
         return;
 
     int count = m_added;
-    if (n->dirtyState & QSGNode::DirtyNodeAdded)
+    if (n->dirtyState & QSGNode::DirtyNodeAdded) {
+        if (m_added == 0)
+            m_addedTop = n;
         ++m_added;
+    }
 
     int force = m_force_update;
     if (n->dirtyState & QSGNode::DirtyForceUpdate)
@@ -471,13 +481,18 @@ void Updater::visitGeometryNode(Node *n)
         e->translateOnlyToRoot = QMatrix4x4_Accessor::isTranslate(*gn->matrix());
 
         if (e->root) {
-            BatchRootInfo *info = renderer->batchRootInfo(e->root);
-            info->availableOrders--;
-            if (info->availableOrders < 0) {
+            Node *rebuildRoot = renderer->reserveRenderOrder(e->root);
+            if (!rebuildRoot) {
                 renderer->m_rebuild |= Renderer::BuildRenderLists;
             } else {
                 renderer->m_rebuild |= Renderer::BuildRenderListsForTaggedRoots;
-                renderer->m_taggedRoots << e->root;
+                // When the element's own root has room, the added subtree
+                // is inserted into the existing render lists. Otherwise the
+                // enclosing root with room is rebuilt.
+                if (rebuildRoot != e->root)
+                    renderer->m_taggedRoots << rebuildRoot;
+                else if (!renderer->m_addedSubtrees.size() || renderer->m_addedSubtrees.last() != m_addedTop)
+                    renderer->m_addedSubtrees.add(m_addedTop);
             }
         } else {
             renderer->m_rebuild |= Renderer::FullRebuild;
@@ -752,7 +767,11 @@ Renderer::Renderer(QSGRenderContext *ctx)
     , m_alphaRenderList(64)
     , m_nextRenderOrder(0)
     , m_partialRebuild(false)
+    , m_partialRebuildOverflow(false)
     , m_partialRebuildRoot(0)
+    , m_addedSubtrees(16)
+    , m_occludedElements(0)
+    , m_occludedBatches(0)
     , m_useDepthBuffer(true)
     , m_opaqueBatches(16)
     , m_alphaBatches(16)
@@ -760,6 +779,7 @@ Renderer::Renderer(QSGRenderContext *ctx)
     , m_elementsToDelete(64)
     , m_tmpAlphaElements(16)
     , m_tmpOpaqueElements(16)
+    , m_occluders(MAX_OCCLUDERS)
     , m_rebuild(FullRebuild)
     , m_zRange(0)
     , m_renderOrderRebuildLower(-1)
@@ -1031,10 +1051,8 @@ void Renderer::nodeWasRemoved(Node *node)
             e->removed = true;
             m_elementsToDelete.add(e);
             e->node = 0;
-            if (e->root) {
-                BatchRootInfo *info = batchRootInfo(e->root);
-                info->availableOrders++;
-            }
+            if (e->root)
+                releaseRenderOrder(e->root);
             if (e->batch) {
                 e->batch->needsUpload = true;
             }
@@ -1065,6 +1083,35 @@ void Renderer::nodeWasRemoved(Node *node)
     delete m_nodes.take(node->sgNode);
 }
 
+/*
+ * Claims one render order for a new element under \a root. Every enclosing
+ * root loses one too, as their ranges contain the range of \a root.
+ *
+ * Returns the innermost root which still has room, so that only its subtree
+ * needs to be rebuilt, or 0 if the render lists have to be built from scratch.
+ */
+Node *Renderer::reserveRenderOrder(Node *root)
+{
+    Node *rebuildRoot = 0;
+    while (root) {
+        BatchRootInfo *info = batchRootInfo(root);
+        info->availableOrders--;
+        if (!rebuildRoot && info->availableOrders >= 0)
+            rebuildRoot = root;
+        root = info->parentRoot;
+    }
+    return rebuildRoot;
+}
+
+void Renderer::releaseRenderOrder(Node *root)
+{
+    while (root) {
+        BatchRootInfo *info = batchRootInfo(root);
+        info->availableOrders++;
+        root = info->parentRoot;
+    }
+}
+
 void Renderer::turnNodeIntoBatchRoot(Node *node)
 {
     if (Q_UNLIKELY(debug_change)) qDebug() << " - new batch root";
@@ -1270,6 +1317,10 @@ void Renderer::buildRenderLists(QSGNode *node)
             m_nextRenderOrder = info->firstOrder;
             QSGNODE_TRAVERSE(node)
                     buildRenderLists(child);
+            // Sub roots are padded anew, which can take more orders than
+            // were reserved. Orders would then overlap the next sibling.
+            if (m_nextRenderOrder > info->lastOrder)
+                m_partialRebuildOverflow = true;
             m_nextRenderOrder = info->lastOrder + 1;
         } else {
             int currentOrder = m_nextRenderOrder;
@@ -1338,8 +1389,11 @@ static void qsg_addBackOrphanedElements(QDataBuffer<Element *> &orphans, QDataBu
  *
  * Then we sort the render lists based on their render order, to restore the
  * right order for rendering.
+ *
+ * Returns false if a root ran out of render orders while being rebuilt, in
+ * which case the render lists must be built from scratch.
  */
-void Renderer::buildRenderListsForTaggedRoots()
+bool Renderer::buildRenderListsForTaggedRoots()
 {
     // Flag any element that is currently in the render lists, but which
     // is not in a batch. This happens when we have a partial rebuild
@@ -1375,6 +1429,7 @@ void Renderer::buildRenderListsForTaggedRoots()
     m_alphaRenderList.reset();
     int maxRenderOrder = m_nextRenderOrder;
     m_partialRebuild = true;
+    m_partialRebuildOverflow = false;
     // Traverse each root, assigning it
     for (QSet<Node *>::const_iterator it = m_taggedRoots.constBegin();
          it != m_taggedRoots.constEnd(); ++it) {
@@ -1401,6 +1456,245 @@ void Renderer::buildRenderListsForTaggedRoots()
     if (m_alphaRenderList.size())
         std::sort(&m_alphaRenderList.first(), &m_alphaRenderList.last() + 1, qsg_sort_element_increasing_order);
 
+    return !m_partialRebuildOverflow;
+}
+
+static void qsg_removeNullElements(QDataBuffer<Element *> &renderList)
+{
+    int count = 0;
+    for (int i=0; i<renderList.size(); ++i) {
+        Element *e = renderList.at(i);
+        if (e)
+            renderList.data()[count++] = e;
+    }
+    renderList.resize(count);
+}
+
+/*
+ * Subtrees which were added under a root that still had free render orders
+ * are inserted into the existing render lists instead of rebuilding the
+ * root. The elements after the insertion point move up into the root's
+ * padding, and only batches spanning the insertion point are invalidated,
+ * so the new elements are batched locally. A subtree which does not fit
+ * tags its root for a partial rebuild instead.
+ */
+void Renderer::insertAddedSubtrees()
+{
+    if (!m_addedSubtrees.size())
+        return;
+
+    qsg_removeNullElements(m_opaqueRenderList);
+    qsg_removeNullElements(m_alphaRenderList);
+
+    for (int i=0; i<m_addedSubtrees.size(); ++i) {
+        Node *node = m_addedSubtrees.at(i);
+        Node *root = node->parent;
+        while (root->type() != QSGNode::ClipNodeType && !root->isBatchRoot)
+            root = root->parent;
+
+        // A rebuild of an enclosing root covers the subtree anyway.
+        bool tagged = false;
+        for (Node *r = root; r && !tagged; r = batchRootInfo(r)->parentRoot)
+            tagged = m_taggedRoots.contains(r);
+        if (tagged)
+            continue;
+
+        if (insertAddedSubtree(node, root))
+            ++m_renderListStatistics.insertedSubtrees;
+        else
+            m_taggedRoots << root;
+    }
+    m_addedSubtrees.reset();
+}
+
+bool Renderer::insertAddedSubtree(Node *node, Node *root)
+{
+    BatchRootInfo *info = batchRootInfo(root);
+    if (info->firstOrder < 0)
+        return false;
+
+    const int opaqueCount = m_opaqueRenderList.size();
+    const int alphaCount = m_alphaRenderList.size();
+    const int after = renderOrderBefore(node->sgNode, root);
+
+    // The highest order in use by the root, including the padding of its sub roots
+    int used = after;
+    for (QSet<Node *>::const_iterator it = info->subRoots.constBegin();
+         it != info->subRoots.constEnd(); ++it) {
+        used = qMax(used, batchRootInfo(*it)->lastOrder);
+    }
+    for (int i=0; i<opaqueCount; ++i) {
+        int order = m_opaqueRenderList.at(i)->order;
+        if (order > info->firstOrder && order <= info->lastOrder)
+            used = qMax(used, order);
+    }
+    for (int i=0; i<alphaCount; ++i) {
+        int order = m_alphaRenderList.at(i)->order;
+        if (order > info->firstOrder && order <= info->lastOrder)
+            used = qMax(used, order);
+    }
+
+    int nextRenderOrder = m_nextRenderOrder;
+    m_nextRenderOrder = after;
+    buildRenderLists(node->sgNode);
+    const int count = m_nextRenderOrder - after;
+    m_nextRenderOrder = nextRenderOrder;
+
+    if (used + count > info->lastOrder) {
+        for (int i=opaqueCount; i<m_opaqueRenderList.size(); ++i)
+            m_opaqueRenderList.at(i)->order = 0;
+        for (int i=alphaCount; i<m_alphaRenderList.size(); ++i)
+            m_alphaRenderList.at(i)->order = 0;
+        m_opaqueRenderList.resize(opaqueCount);
+        m_alphaRenderList.resize(alphaCount);
+        return false;
+    }
+
+    if (count == 0)
+        return true;
+
+    // Make room for the new elements, then merge them into the sorted lists.
+    for (int i=0; i<opaqueCount; ++i) {
+        Element *e = m_opaqueRenderList.at(i);
+        if (e->order > after && e->order <= info->lastOrder)
+            e->order += count;
+    }
+    for (int i=0; i<alphaCount; ++i) {
+        Element *e = m_alphaRenderList.at(i);
+        if (e->order > after && e->order <= info->lastOrder)
+            e->order += count;
+    }
+    shiftRenderOrders(root, after, count);
+
+    if (m_opaqueRenderList.size() > opaqueCount) {
+        Element **begin = m_opaqueRenderList.data();
+        Element **end = begin + m_opaqueRenderList.size();
+        std::reverse(begin + opaqueCount, end);
+        std::inplace_merge(begin, begin + opaqueCount, end, qsg_sort_element_decreasing_order);
+    }
+    if (m_alphaRenderList.size() > alphaCount) {
+        Element **begin = m_alphaRenderList.data();
+        Element **end = begin + m_alphaRenderList.size();
+        std::inplace_merge(begin, begin + alphaCount, end, qsg_sort_element_increasing_order);
+        invalidateAlphaBatchesInRange(after + 1, after + count);
+    }
+
+    m_rebuild |= BuildBatches;
+    return true;
+}
+
+/*
+ * Returns the render order of the element which is rendered right before
+ * \a node within \a root, or the first order of \a root if there is none.
+ */
+int Renderer::renderOrderBefore(QSGNode *node, Node *root)
+{
+    QSGNode *n = node;
+    while (n != root->sgNode) {
+        for (QSGNode *s = n->previousSibling(); s; s = s->previousSibling()) {
+            int order = lastRenderOrderIn(s);
+            if (order > 0)
+                return order;
+        }
+        n = n->parent();
+        if (n->type() == QSGNode::GeometryNodeType) {
+            Node *sn = m_nodes.value(n);
+            if (sn && sn->element()->order > 0)
+                return sn->element()->order;
+        }
+    }
+    return batchRootInfo(root)->firstOrder;
+}
+
+/*
+ * Returns the last render order used by the subtree of \a node, or 0 if it
+ * has no elements in the render lists. Roots count with their padding.
+ */
+int Renderer::lastRenderOrderIn(QSGNode *node)
+{
+    Node *sn = m_nodes.value(node);
+    if (!sn)
+        return 0;
+    if (node->type() == QSGNode::ClipNodeType || sn->isBatchRoot)
+        return qMax(0, batchRootInfo(sn)->lastOrder);
+    for (QSGNode *c = node->lastChild(); c; c = c->previousSibling()) {
+        int order = lastRenderOrderIn(c);
+        if (order > 0)
+            return order;
+    }
+    if (node->type() == QSGNode::GeometryNodeType)
+        return sn->element()->order;
+    if (node->type() == QSGNode::RenderNodeType)
+        return sn->renderNodeElement()->order;
+    return 0;
+}
+
+/*
+ * Moves everything in \a root which comes after the render order \a after
+ * up by \a count orders: sub roots, batches and the pending rebuild range.
+ * The elements themselves are moved by the caller.
+ */
+void Renderer::shiftRenderOrders(Node *root, int after, int count)
+{
+    BatchRootInfo *info = batchRootInfo(root);
+    for (QSet<Node *>::const_iterator it = info->subRoots.constBegin();
+         it != info->subRoots.constEnd(); ++it) {
+        BatchRootInfo *sub = batchRootInfo(*it);
+        if (sub->firstOrder < after)
+            continue;
+        QDataBuffer<Node *> roots(8);
+        roots.add(*it);
+        while (roots.size()) {
+            Node *r = roots.last();
+            roots.pop_back();
+            BatchRootInfo *i = batchRootInfo(r);
+            i->firstOrder += count;
+            i->lastOrder += count;
+            for (QSet<Node *>::const_iterator s = i->subRoots.constBegin(); s != i->subRoots.constEnd(); ++s)
+                roots.add(*s);
+        }
+    }
+
+    const int last = info->lastOrder;
+    for (int pass=0; pass<2; ++pass) {
+        QDataBuffer<Batch *> &batches = pass ? m_alphaBatches : m_opaqueBatches;
+        for (int i=0; i<batches.size(); ++i) {
+            Batch *b = batches.at(i);
+            if (!b->first || b->lastOrderInBatch <= after || b->lastOrderInBatch > last)
+                continue;
+            // Merged batches carry the z order in their vertex data.
+            b->lastOrderInBatch += count;
+            b->needsUpload = true;
+        }
+    }
+
+    if (m_renderOrderRebuildLower > after && m_renderOrderRebuildLower <= last)
+        m_renderOrderRebuildLower += count;
+    if (m_renderOrderRebuildUpper > after && m_renderOrderRebuildUpper <= last)
+        m_renderOrderRebuildUpper += count;
+}
+
+/*
+ * Alpha batches must not be formed across a valid batch, so every alpha
+ * batch which overlaps the union of the pending rebuild range and the
+ * range from \a first to \a last is invalidated.
+ */
+void Renderer::invalidateAlphaBatchesInRange(int first, int last)
+{
+    if (m_renderOrderRebuildLower < 0 || first < m_renderOrderRebuildLower)
+        m_renderOrderRebuildLower = first;
+    if (m_renderOrderRebuildUpper < 0 || last > m_renderOrderRebuildUpper)
+        m_renderOrderRebuildUpper = last;
+
+    for (int i=0; i<m_alphaBatches.size(); ++i) {
+        Batch *b = m_alphaBatches.at(i);
+        if (b->first) {
+            int bf = b->first->order;
+            int bl = b->lastOrderInBatch;
+            if (bl >= m_renderOrderRebuildLower && bf <= m_renderOrderRebuildUpper)
+                b->invalidate();
+        }
+    }
 }
 
 void Renderer::buildRenderListsFromScratch()
@@ -2163,6 +2457,13 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
     while (e) {
         gn = e->node;
 
+        if (e->occluded) {
+            vOffset += gn->geometry()->sizeOfVertex() * gn->geometry()->vertexCount();
+            iOffset += gn->geometry()->indexCount() * gn->geometry()->sizeOfIndex();
+            e = e->nextInBatch;
+            continue;
+        }
+
         m_current_model_view_matrix = rootMatrix * *gn->matrix();
         m_current_determinant = m_current_model_view_matrix.determinant();
 
@@ -2212,12 +2513,185 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
     }
 }
 
+/*
+ * Occlusion culling
+ *
+ * Opaque rectangles and images are used as occluders when their geometry is
+ * a single axis aligned quad which is neither clipped nor rotated. Elements
+ * with a lower render order whose bounds are entirely inside an occluder
+ * cannot contribute to the final image, so their draw calls are skipped.
+ * Unmerged batches skip the individual elements, merged batches are only
+ * skipped if all their elements are covered. Only the largest occluders
+ * are kept to bound the cost of the test.
+ */
+
+static bool qsg_isOccluderMaterial(QSGMaterial *material)
+{
+    if (material->flags() & (QSGMaterial::Blending | QSGMaterial::CustomCompileStep))
+        return false;
+    static QSGMaterialType *flatColorType = QSGFlatColorMaterial().type();
+    static QSGMaterialType *vertexColorType = QSGVertexColorMaterial().type();
+    static QSGMaterialType *opaqueTextureType = QSGOpaqueTextureMaterial().type();
+    static QSGMaterialType *textureType = QSGTextureMaterial().type();
+    QSGMaterialType *type = material->type();
+    return type == flatColorType
+            || type == vertexColorType
+            || type == opaqueTextureType
+            || type == textureType;
+}
+
+static bool qsg_quadRect(QSGGeometry *g, Rect *rect)
+{
+    if (g->drawingMode() != GL_TRIANGLE_STRIP)
+        return false;
+    int count = g->indexCount() ? g->indexCount() : g->vertexCount();
+    int offset = qsg_positionAttribute(g);
+    if (count != 4 || offset == -1)
+        return false;
+
+    Pt p[4];
+    const char *vd = (const char *) g->vertexData() + offset;
+    for (int i=0; i<4; ++i) {
+        int index = i;
+        if (g->indexCount()) {
+            if (g->indexType() == GL_UNSIGNED_SHORT)
+                index = g->indexDataAsUShort()[i];
+            else if (g->indexType() == GL_UNSIGNED_INT)
+                index = g->indexDataAsUInt()[i];
+            else
+                index = static_cast<const uchar *>(g->indexData())[i];
+            if (index >= g->vertexCount())
+                return false;
+        }
+        p[i] = *(const Pt *) (vd + index * g->sizeOfVertex());
+    }
+
+    // A strip of four vertices covers its bounding rect if the first and
+    // last pair each form one edge and the pairs are aligned with each other.
+    bool rows = p[0].y == p[1].y && p[2].y == p[3].y && p[0].x == p[2].x && p[1].x == p[3].x;
+    bool columns = p[0].x == p[1].x && p[2].x == p[3].x && p[0].y == p[2].y && p[1].y == p[3].y;
+    if (!rows && !columns)
+        return false;
+
+    rect->set(qMin(p[0].x, p[3].x), qMin(p[0].y, p[3].y), qMax(p[0].x, p[3].x), qMax(p[0].y, p[3].y));
+    return rect->tl.x < rect->br.x && rect->tl.y < rect->br.y;
+}
+
+void Renderer::addOccluder(Element *e)
+{
+    if (!e || e->isRenderNode || e->removed)
+        return;
+
+    QSGGeometryNode *gn = e->node;
+    if (gn->clipList()
+            || gn->inheritedOpacity() <= OPAQUE_LIMIT
+            || !qsg_isOccluderMaterial(gn->activeMaterial())
+            || !QMatrix4x4_Accessor::isScale(*gn->matrix()))
+        return;
+
+    Occluder o;
+    if (!qsg_quadRect(gn->geometry(), &o.rect))
+        return;
+    o.rect.map(*gn->matrix());
+    if (e->root) {
+        QMatrix4x4 rootMatrix = qsg_matrixForRoot(e->root);
+        if (!QMatrix4x4_Accessor::isScale(rootMatrix))
+            return;
+        o.rect.map(rootMatrix);
+    }
+    if (o.rect.isOutsideFloatRange())
+        return;
+    o.area = (o.rect.br.x - o.rect.tl.x) * (o.rect.br.y - o.rect.tl.y);
+    o.element = e;
+
+    if (m_occluders.size() < MAX_OCCLUDERS) {
+        m_occluders.add(o);
+        return;
+    }
+
+    // Replace the smallest occluder if this one is larger
+    int smallest = 0;
+    for (int i=1; i<m_occluders.size(); ++i) {
+        if (m_occluders.at(i).area < m_occluders.at(smallest).area)
+            smallest = i;
+    }
+    if (m_occluders.at(smallest).area < o.area)
+        m_occluders.at(smallest) = o;
+}
+
+void Renderer::cullOccludedElements(Batch *batch)
+{
+    batch->isOccluded = false;
+    if (batch->isRenderNode)
+        return;
+
+    QMatrix4x4 rootMatrix;
+    if (batch->root)
+        rootMatrix = qsg_matrixForRoot(batch->root);
+
+    int count = 0;
+    int occluded = 0;
+    for (Element *e = batch->first; e; e = e->nextInBatch) {
+        ++count;
+        e->occluded = false;
+        if (!m_occluders.size())
+            continue;
+        e->ensureBoundsValid();
+        Rect bounds = e->bounds;
+        if (batch->root)
+            bounds.map(rootMatrix);
+        for (int i=0; i<m_occluders.size(); ++i) {
+            const Occluder &o = m_occluders.at(i);
+            if (o.element->order > e->order && o.rect.contains(bounds)) {
+                e->occluded = true;
+                ++occluded;
+                break;
+            }
+        }
+    }
+
+    if (occluded == 0)
+        return;
+
+    if (occluded == count) {
+        batch->isOccluded = true;
+        ++m_occludedBatches;
+    } else if (batch->merged) {
+        // Merged batches are drawn with a single call, so partially covered
+        // ones are drawn in full.
+        for (Element *e = batch->first; e; e = e->nextInBatch)
+            e->occluded = false;
+        return;
+    }
+    m_occludedElements += occluded;
+}
+
+void Renderer::cullOccludedBatches()
+{
+    m_occluders.reset();
+    m_occludedElements = 0;
+    m_occludedBatches = 0;
+
+    if (Q_LIKELY(!debug_noocclusion)) {
+        for (int i=0; i<m_opaqueRenderList.size(); ++i)
+            addOccluder(m_opaqueRenderList.at(i));
+        for (int i=0; i<m_alphaRenderList.size(); ++i)
+            addOccluder(m_alphaRenderList.at(i));
+    }
+
+    for (int i=0; i<m_opaqueBatches.size(); ++i)
+        cullOccludedElements(m_opaqueBatches.at(i));
+    for (int i=0; i<m_alphaBatches.size(); ++i)
+        cullOccludedElements(m_alphaBatches.at(i));
+}
+
 void Renderer::renderBatches()
 {
     if (Q_UNLIKELY(debug_render)) {
         qDebug().nospace() << "Rendering:" << endl
                            << " -> Opaque: " << qsg_countNodesInBatches(m_opaqueBatches) << " nodes in " << m_opaqueBatches.size() << " batches..." << endl
-                           << " -> Alpha: " << qsg_countNodesInBatches(m_alphaBatches) << " nodes in " << m_alphaBatches.size() << " batches...";
+                           << " -> Alpha: " << qsg_countNodesInBatches(m_alphaBatches) << " nodes in " << m_alphaBatches.size() << " batches..." << endl
+                           << " -> Occluded: " << m_occludedElements << " nodes, " << m_occludedBatches << " whole batches by " << m_occluders.size() << " occluders...";
     }
 
     QRect r = viewportRect();
@@ -2257,6 +2731,8 @@ void Renderer::renderBatches()
     if (Q_LIKELY(renderOpaque)) {
         for (int i=0; i<m_opaqueBatches.size(); ++i) {
             Batch *b = m_opaqueBatches.at(i);
+            if (b->isOccluded)
+                continue;
             if (b->merged)
                 renderMergedBatch(b);
             else
@@ -2272,6 +2748,8 @@ void Renderer::renderBatches()
     if (Q_LIKELY(renderAlpha)) {
         for (int i=0; i<m_alphaBatches.size(); ++i) {
             Batch *b = m_alphaBatches.at(i);
+            if (b->isOccluded)
+                continue;
             if (b->merged)
                 renderMergedBatch(b);
             else if (b->isRenderNode)
@@ -2351,14 +2829,36 @@ void Renderer::render()
         qDebug() << "Renderer::render()" << this << type;
     }
 
+    m_renderListStatistics = RenderListStatistics();
+
     if (m_rebuild & (BuildRenderLists | BuildRenderListsForTaggedRoots)) {
+        if (!(m_rebuild & BuildRenderLists))
+            insertAddedSubtrees();
+        m_addedSubtrees.reset();
+
         bool complete = (m_rebuild & BuildRenderLists) != 0;
-        if (complete)
+        if (complete) {
             buildRenderListsFromScratch();
-        else
-            buildRenderListsForTaggedRoots();
+        } else if (!m_taggedRoots.isEmpty()) {
+            if (buildRenderListsForTaggedRoots()) {
+                ++m_renderListStatistics.partialBuilds;
+            } else {
+                ++m_renderListStatistics.overflows;
+                complete = true;
+                buildRenderListsFromScratch();
+            }
+        }
+        if (complete)
+            ++m_renderListStatistics.fullBuilds;
         m_rebuild |= BuildBatches;
 
+        if (Q_UNLIKELY(debug_render || debug_build)) {
+            qDebug() << " - render lists: full:" << m_renderListStatistics.fullBuilds
+                     << "partial:" << m_renderListStatistics.partialBuilds
+                     << "inserted subtrees:" << m_renderListStatistics.insertedSubtrees
+                     << "overflowed:" << m_renderListStatistics.overflows;
+        }
+
         if (Q_UNLIKELY(debug_build)) {
             qDebug() << "Opaque render lists" << (complete ? "(complete)" : "(partial)") << ":";
             for (int i=0; i<m_opaqueRenderList.size(); ++i) {
@@ -2430,6 +2930,8 @@ void Renderer::render()
     for (int i=0; i<m_alphaBatches.size(); ++i)
         uploadBatch(m_alphaBatches.at(i));
 
+    cullOccludedBatches();
+
     renderBatches();
 
     m_rebuild = 0;
@@ -2779,6 +3281,49 @@ void Renderer::visualizeOverdraw()
             window->update();
 }
 
+void Renderer::visualizeElement(Element *e)
+{
+    VisualizeShader *shader = static_cast<VisualizeShader *>(m_shaderManager->visualizeProgram);
+    QSGGeometryNode *gn = e->node;
+
+    QMatrix4x4 matrix = projectionMatrix();
+    if (e->root)
+        matrix = matrix * qsg_matrixForRoot(e->root);
+    matrix = matrix * *gn->matrix();
+    shader->setUniformValue(shader->matrix, matrix);
+    visualizeDrawGeometry(gn->geometry());
+}
+
+void Renderer::visualizeOcclusion()
+{
+    VisualizeShader *shader = static_cast<VisualizeShader *>(m_shaderManager->visualizeProgram);
+    QRect viewport = viewportRect();
+
+    // Occluders are drawn with a green tint...
+    float ca = 0.33f;
+    shader->setUniformValue(shader->tweak, viewport.width(), viewport.height(), 0, 0);
+    shader->setUniformValue(shader->color, 0.3f * ca, 1.0f * ca, 0.3f * ca, ca);
+    for (int i=0; i<m_occluders.size(); ++i)
+        visualizeElement(m_occluders.at(i).element);
+
+    // ... and the elements they cull with a red pattern on top.
+    ca = 0.5f;
+    shader->setUniformValue(shader->tweak, viewport.width(), viewport.height(), 0.5, 0);
+    shader->setUniformValue(shader->color, 1.0f * ca, 0.3f * ca, 0.3f * ca, ca);
+    for (int i=0; i<m_opaqueBatches.size(); ++i) {
+        for (Element *e = m_opaqueBatches.at(i)->first; e; e = e->nextInBatch) {
+            if (e->occluded)
+                visualizeElement(e);
+        }
+    }
+    for (int i=0; i<m_alphaBatches.size(); ++i) {
+        for (Element *e = m_alphaBatches.at(i)->first; e; e = e->nextInBatch) {
+            if (e->occluded)
+                visualizeElement(e);
+        }
+    }
+}
+
 void Renderer::setCustomRenderMode(const QByteArray &mode)
 {
     if (mode.isEmpty()) m_visualizeMode = VisualizeNothing;
@@ -2786,6 +3331,7 @@ void Renderer::setCustomRenderMode(const QByteArray &mode)
     else if (mode == "overdraw") m_visualizeMode = VisualizeOverdraw;
     else if (mode == "batches") m_visualizeMode = VisualizeBatches;
     else if (mode == "changes") m_visualizeMode = VisualizeChanges;
+    else if (mode == "occlusion") m_visualizeMode = VisualizeOcclusion;
 }
 
 void Renderer::visualize()
@@ -2841,6 +3387,8 @@ void Renderer::visualize()
         m_visualizeChanceSet.clear();
     } else if (m_visualizeMode == VisualizeOverdraw) {
         visualizeOverdraw();
+    } else if (m_visualizeMode == VisualizeOcclusion) {
+        visualizeOcclusion();
     }
 
     // Reset state back to defaults..
@@ -130,6 +130,10 @@ struct Rect {
         return xOverlap && yOverlap;
     }
 
+    bool contains(const Rect &r) const {
+        return r.tl.x >= tl.x && r.br.x <= br.x && r.tl.y >= tl.y && r.br.y <= br.y;
+    }
+
     bool isOutsideFloatRange() const {
         return tl.x < -QSG_RENDERER_COORD_LIMIT
                 || tl.y < -QSG_RENDERER_COORD_LIMIT
@@ -163,6 +167,7 @@ struct Element {
         , removed(false)
         , orphaned(false)
         , isRenderNode(false)
+        , occluded(false)
     {
     }
 
@@ -187,6 +192,7 @@ struct Element {
     uint removed : 1;
     uint orphaned : 1;
     uint isRenderNode : 1;
+    uint occluded : 1;
 };
 
 struct RenderNodeElement : public Element {
@@ -261,6 +267,7 @@ struct Batch
         positionAttribute = -1;
         uploadedThisFrame = false;
         isRenderNode = false;
+        isOccluded = false;
     }
 
     Element *first;
@@ -277,6 +284,7 @@ struct Batch
     uint needsUpload : 1;
     uint merged : 1;
     uint isRenderNode : 1;
+    uint isOccluded : 1;
 
     mutable uint uploadedThisFrame : 1; // solely for debugging purposes
 
@@ -288,6 +296,13 @@ struct Batch
     QDataBuffer<DrawSet> drawSets;
 };
 
+struct Occluder
+{
+    Rect rect; // in scene coordinates
+    float area;
+    Element *element;
+};
+
 struct Node
 {
     Node(QSGNode *node, Node *sparent = 0)
@@ -359,6 +374,7 @@ private:
     QDataBuffer<QMatrix4x4> m_rootMatrices;
 
     int m_added;
+    Node *m_addedTop;
     int m_transformChange;
     int m_opacityChange;
 
@@ -410,9 +426,21 @@ public:
         VisualizeBatches,
         VisualizeClipping,
         VisualizeChanges,
-        VisualizeOverdraw
+        VisualizeOverdraw,
+        VisualizeOcclusion
     };
 
+    // How the render lists were maintained in the last frame.
+    struct RenderListStatistics {
+        RenderListStatistics() : fullBuilds(0), partialBuilds(0), insertedSubtrees(0), overflows(0) { }
+        int fullBuilds;
+        int partialBuilds;
+        int insertedSubtrees;
+        int overflows;
+    };
+
+    const RenderListStatistics &renderListStatistics() const { return m_renderListStatistics; }
+
 protected:
     void nodeChanged(QSGNode *node, QSGNode::DirtyState state);
     void preprocess() Q_DECL_OVERRIDE;
@@ -433,9 +461,15 @@ private:
     void unmap(Buffer *buffer, bool isIndexBuf = false);
 
     void buildRenderListsFromScratch();
-    void buildRenderListsForTaggedRoots();
+    bool buildRenderListsForTaggedRoots();
     void tagSubRoots(Node *node);
     void buildRenderLists(QSGNode *node);
+    void insertAddedSubtrees();
+    bool insertAddedSubtree(Node *node, Node *root);
+    int renderOrderBefore(QSGNode *node, Node *root);
+    int lastRenderOrderIn(QSGNode *node);
+    void shiftRenderOrders(Node *root, int after, int count);
+    void invalidateAlphaBatchesInRange(int first, int last);
 
     void deleteRemovedElements();
     void cleanupBatches(QDataBuffer<Batch *> *batches);
@@ -443,6 +477,9 @@ private:
     bool checkOverlap(int first, int last, const Rect &bounds);
     void prepareAlphaBatches();
     void invalidateBatchAndOverlappingRenderOrders(Batch *batch);
+    void addOccluder(Element *e);
+    void cullOccludedElements(Batch *batch);
+    void cullOccludedBatches();
 
     void uploadBatch(Batch *b);
     void uploadMergedElement(Element *e, int vaOffset, char **vertexData, char **zData, char **indexData, quint16 *iBase, int *indexCount);
@@ -460,6 +497,8 @@ private:
     void removeBatchRootFromParent(Node *childRoot);
     void nodeChangedBatchRoot(Node *node, Node *root);
     void turnNodeIntoBatchRoot(Node *node);
+    Node *reserveRenderOrder(Node *root);
+    void releaseRenderOrder(Node *root);
     void nodeWasTransformed(Node *node, int *vertexCount);
     void nodeWasRemoved(Node *node);
     void nodeWasAdded(QSGNode *node, Node *shadowParent);
@@ -475,6 +514,8 @@ private:
     void visualizeChanges(Node *n);
     void visualizeOverdraw();
     void visualizeOverdraw_helper(Node *node);
+    void visualizeOcclusion();
+    void visualizeElement(Element *e);
     void visualizeDrawGeometry(const QSGGeometry *g);
     void setCustomRenderMode(const QByteArray &mode);
 
@@ -483,7 +524,14 @@ private:
     QDataBuffer<Element *> m_alphaRenderList;
     int m_nextRenderOrder;
     bool m_partialRebuild;
+    bool m_partialRebuildOverflow;
     QSGNode *m_partialRebuildRoot;
+    QDataBuffer<Node *> m_addedSubtrees;
+
+    RenderListStatistics m_renderListStatistics;
+
+    int m_occludedElements;
+    int m_occludedBatches;
 
     bool m_useDepthBuffer;
 
@@ -496,6 +544,7 @@ private:
     QDataBuffer<Element *> m_elementsToDelete;
     QDataBuffer<Element *> m_tmpAlphaElements;
     QDataBuffer<Element *> m_tmpOpaqueElements;
+    QDataBuffer<Occluder> m_occluders;
 
     uint m_rebuild;
     qreal m_zRange;
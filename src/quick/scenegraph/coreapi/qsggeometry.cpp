@@ -45,10 +45,7 @@
 #include <qopenglcontext.h>
 #include <qopenglfunctions.h>
 #include <private/qopenglextensions_p.h>
-
-#ifdef Q_OS_QNX
-#include <malloc.h>
-#endif
+#include <private/qsgpoolallocator_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -407,6 +404,7 @@ QSGGeometry::QSGGeometry(const QSGGeometry::AttributeSet &attributes,
     , m_owns_data(false)
     , m_index_usage_pattern(AlwaysUploadPattern)
     , m_vertex_usage_pattern(AlwaysUploadPattern)
+    , m_data_size_class(0)
     , m_line_width(1.0)
 {
     Q_UNUSED(m_reserved_bits);
@@ -457,7 +455,7 @@ QSGGeometry::QSGGeometry(const QSGGeometry::AttributeSet &attributes,
 QSGGeometry::~QSGGeometry()
 {
     if (m_owns_data)
-        free(m_data);
+        QSGPoolAllocator::release(m_data, int(m_data_size_class) - 1);
 
     if (m_server_data)
         delete m_server_data;
@@ -590,7 +588,7 @@ void QSGGeometry::allocate(int vertexCount, int indexCount)
     int vertexByteSize = m_attributes.stride * m_vertex_count;
 
     if (m_owns_data)
-        free(m_data);
+        QSGPoolAllocator::release(m_data, int(m_data_size_class) - 1);
 
     if (canUsePrealloc && vertexByteSize <= (int) sizeof(m_prealloc)) {
         m_data = (void *) &m_prealloc[0];
@@ -599,7 +597,11 @@ void QSGGeometry::allocate(int vertexCount, int indexCount)
     } else {
         Q_ASSERT(m_index_type == GL_UNSIGNED_INT || m_index_type == GL_UNSIGNED_SHORT);
         int indexByteSize = indexCount * (m_index_type == GL_UNSIGNED_SHORT ? sizeof(quint16) : sizeof(quint32));
-        m_data = (void *) malloc(vertexByteSize + indexByteSize);
+        // Vertex and index storage comes from the render context's pool, so
+        // nodes which are torn down and recreated reuse the same blocks.
+        int sizeClass;
+        m_data = QSGPoolAllocator::allocate(vertexByteSize + indexByteSize, &sizeClass);
+        m_data_size_class = sizeClass + 1;
         m_index_data_offset = vertexByteSize;
         m_owns_data = true;
     }
@@ -180,7 +180,8 @@ private:
     uint m_vertex_usage_pattern : 2;
     uint m_dirty_index_data : 1;
     uint m_dirty_vertex_data : 1;
-    uint m_reserved_bits : 25;
+    uint m_data_size_class : 6;
+    uint m_reserved_bits : 19;
 
     float m_prealloc[16];
 
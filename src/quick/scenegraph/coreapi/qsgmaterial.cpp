@@ -43,6 +43,7 @@
 #include "qsgrenderer_p.h"
 #include "qsgmaterialshader_p.h"
 #include <private/qsgshadersourcebuilder_p.h>
+#include <private/qsgshadercache_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -340,9 +341,6 @@ void QSGMaterialShader::compile()
 {
     Q_ASSERT_X(!m_program.isLinked(), "QSGSMaterialShader::compile()", "Compile called multiple times!");
 
-    program()->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShader());
-    program()->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShader());
-
     char const *const *attr = attributeNames();
 #ifndef QT_NO_DEBUG
     int maxVertexAttribs = 0;
@@ -365,9 +363,18 @@ void QSGMaterialShader::compile()
     }
 #endif
 
+    if (QSGShaderCache::load(program(), vertexShader(), fragmentShader(), attr))
+        return;
+
+    program()->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShader());
+    program()->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShader());
+
+    QSGShaderCache::prepare(program());
     if (!program()->link()) {
         qWarning("QSGMaterialShader: Shader compilation failed:");
         qWarning() << program()->log();
+    } else {
+        QSGShaderCache::store(program(), vertexShader(), fragmentShader(), attr);
     }
 }
 
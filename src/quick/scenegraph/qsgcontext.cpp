@@ -50,6 +50,7 @@
 #include <QtQuick/private/qsgdistancefieldglyphnode_p_p.h>
 #include <QtQuick/private/qsgshareddistancefieldglyphcache_p.h>
 #include <QtQuick/private/qsgatlastexture_p.h>
+#include <QtQuick/private/qsgshadercache_p.h>
 
 #include <QtQuick/private/qsgtexture_p.h>
 #include <QtQuick/private/qquickpixmapcache_p.h>
@@ -93,6 +94,12 @@ DEFINE_BOOL_CONFIG_OPTION(qmlDisableDistanceField, QML_DISABLE_DISTANCEFIELD)
 
 QT_BEGIN_NAMESPACE
 
+// Number of render contexts holding a texture created from a texture factory,
+// so that caches keeping factories alive can account for their GPU memory.
+typedef QHash<QQuickTextureFactory *, int> QSGTextureFactoryUseCounts;
+Q_GLOBAL_STATIC(QSGTextureFactoryUseCounts, qsg_texture_factory_uses)
+Q_GLOBAL_STATIC(QMutex, qsg_texture_factory_uses_mutex)
+
 class QSGContextPrivate : public QObjectPrivate
 {
 public:
@@ -441,6 +448,10 @@ void QSGRenderContext::initialize(QOpenGLContext *context)
     m_gl->setProperty(QSG_RENDERCONTEXT_PROPERTY, QVariant::fromValue(this));
     m_sg->renderContextInitialized(this);
 
+    // Nodes and geometry created on the rendering thread share this context's pool
+    if (!QSGPoolAllocator::current())
+        QSGPoolAllocator::setCurrent(&m_pool);
+
 #ifdef Q_OS_LINUX
     const char *vendor = (const char *) glGetString(GL_VENDOR);
     if (strstr(vendor, "nouveau"))
@@ -463,6 +474,16 @@ void QSGRenderContext::invalidate()
     qDeleteAll(m_texturesToDelete);
     m_texturesToDelete.clear();
 
+    qsg_texture_factory_uses_mutex()->lock();
+    QSGTextureFactoryUseCounts *uses = qsg_texture_factory_uses();
+    for (QHash<QQuickTextureFactory *, QSGTexture *>::const_iterator it = m_textures.constBegin();
+         it != m_textures.constEnd(); ++it) {
+        QSGTextureFactoryUseCounts::iterator use = uses->find(it.key());
+        if (use != uses->end() && --use.value() <= 0)
+            uses->erase(use);
+    }
+    qsg_texture_factory_uses_mutex()->unlock();
+
     qDeleteAll(m_textures.values());
     m_textures.clear();
 
@@ -505,6 +526,12 @@ void QSGRenderContext::invalidate()
     delete m_distanceFieldCacheManager;
     m_distanceFieldCacheManager = 0;
 
+    if (QSGPoolAllocator::current() == &m_pool)
+        QSGPoolAllocator::setCurrent(0);
+    if (qEnvironmentVariableIsSet("QSG_INFO"))
+        m_pool.printStatistics();
+    m_pool.clear();
+
     m_gl->setProperty(QSG_RENDERCONTEXT_PROPERTY, QVariant());
     m_gl = 0;
 
@@ -599,6 +626,10 @@ QSGTexture *QSGRenderContext::textureForFactory(QQuickTextureFactory *factory, Q
         m_textures.insert(factory, texture);
         m_mutex.unlock();
 
+        qsg_texture_factory_uses_mutex()->lock();
+        ++(*qsg_texture_factory_uses())[factory];
+        qsg_texture_factory_uses_mutex()->unlock();
+
         connect(factory, SIGNAL(destroyed(QObject*)), this, SLOT(textureFactoryDestroyed(QObject*)), Qt::DirectConnection);
     }
     return texture;
@@ -606,9 +637,25 @@ QSGTexture *QSGRenderContext::textureForFactory(QQuickTextureFactory *factory, Q
 
 void QSGRenderContext::textureFactoryDestroyed(QObject *o)
 {
+    QQuickTextureFactory *factory = static_cast<QQuickTextureFactory *>(o);
+
     m_mutex.lock();
-    m_texturesToDelete << m_textures.take(static_cast<QQuickTextureFactory *>(o));
+    m_texturesToDelete << m_textures.take(factory);
     m_mutex.unlock();
+
+    qsg_texture_factory_uses_mutex()->lock();
+    qsg_texture_factory_uses()->remove(factory);
+    qsg_texture_factory_uses_mutex()->unlock();
+}
+
+/*!
+    Returns the number of render contexts currently holding a texture
+    created from \a factory.
+ */
+int QSGRenderContext::textureFactoryUseCount(QQuickTextureFactory *factory)
+{
+    QMutexLocker locker(qsg_texture_factory_uses_mutex());
+    return qsg_texture_factory_uses()->value(factory);
 }
 
 /*!
@@ -630,11 +677,20 @@ void QSGRenderContext::compile(QSGMaterialShader *shader, QSGMaterial *material,
                    "QSGRenderContext::compile()",
                    "materials with custom compile step cannot have custom vertex/fragment code");
         QOpenGLShaderProgram *p = shader->program();
-        p->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexCode ? vertexCode : shader->vertexShader());
-        p->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentCode ? fragmentCode : shader->fragmentShader());
+        if (!vertexCode)
+            vertexCode = shader->vertexShader();
+        if (!fragmentCode)
+            fragmentCode = shader->fragmentShader();
+        if (QSGShaderCache::load(p, vertexCode, fragmentCode, shader->attributeNames()))
+            return;
+        p->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexCode);
+        p->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentCode);
+        QSGShaderCache::prepare(p);
         p->link();
         if (!p->isLinked())
             qWarning() << "shader compilation failed:" << endl << p->log();
+        else
+            QSGShaderCache::store(p, vertexCode, fragmentCode, shader->attributeNames());
     } else {
         shader->compile();
     }
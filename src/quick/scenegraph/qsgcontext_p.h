@@ -53,6 +53,7 @@
 
 #include <QtQuick/qsgnode.h>
 #include <QtQuick/private/qsgdepthstencilbuffer_p.h>
+#include <QtQuick/private/qsgpoolallocator_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -101,6 +102,7 @@ public:
 
     virtual QSGDistanceFieldGlyphCache *distanceFieldGlyphCache(const QRawFont &font);
     QSGTexture *textureForFactory(QQuickTextureFactory *factory, QQuickWindow *window);
+    static int textureFactoryUseCount(QQuickTextureFactory *factory);
 
     virtual QSGTexture *createTexture(const QImage &image) const;
     virtual QSGTexture *createTextureNoAtlas(const QImage &image) const;
@@ -136,6 +138,8 @@ protected:
 
     QSet<QFontEngine *> m_fontEnginesToClean;
 
+    QSGPoolAllocator m_pool;
+
     bool m_brokenIBOs;
     bool m_serializedRender;
 };
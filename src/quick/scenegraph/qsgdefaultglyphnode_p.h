@@ -44,12 +44,13 @@
 
 #include <private/qsgadaptationlayer_p.h>
 #include <QtQuick/qsgnode.h>
+#include <QtQuick/private/qsgpoolallocator_p.h>
 
 QT_BEGIN_NAMESPACE
 
 class QGlyphs;
 class QSGTextMaskMaterial;
-class QSGDefaultGlyphNode: public QSGGlyphNode
+class QSGDefaultGlyphNode: public QSGGlyphNode, public QSGPooledAllocation
 {
 public:
     QSGDefaultGlyphNode();
@@ -45,6 +45,7 @@
 
 #include <private/qsgadaptationlayer_p.h>
 #include <QtQuick/qsgtexturematerial.h>
+#include <QtQuick/private/qsgpoolallocator_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -60,7 +61,7 @@ protected:
     virtual QSGMaterialShader *createShader() const;
 };
 
-class Q_QUICK_PRIVATE_EXPORT QSGDefaultImageNode : public QSGImageNode
+class Q_QUICK_PRIVATE_EXPORT QSGDefaultImageNode : public QSGImageNode, public QSGPooledAllocation
 {
 public:
     QSGDefaultImageNode();
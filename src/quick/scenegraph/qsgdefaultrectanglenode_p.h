@@ -46,6 +46,7 @@
 #include <private/qsgadaptationlayer_p.h>
 
 #include <QtQuick/qsgvertexcolormaterial.h>
+#include <QtQuick/private/qsgpoolallocator_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -63,7 +64,7 @@ protected:
     virtual QSGMaterialShader *createShader() const;
 };
 
-class Q_QUICK_PRIVATE_EXPORT QSGDefaultRectangleNode : public QSGRectangleNode
+class Q_QUICK_PRIVATE_EXPORT QSGDefaultRectangleNode : public QSGRectangleNode, public QSGPooledAllocation
 {
 public:
     QSGDefaultRectangleNode();
@@ -44,6 +44,7 @@
 
 #include <private/qsgadaptationlayer_p.h>
 #include <QtQuick/qsgtexture.h>
+#include <QtQuick/private/qsgpoolallocator_p.h>
 
 #include <QtQuick/private/qquicktext_p.h>
 
@@ -52,7 +53,7 @@ QT_BEGIN_NAMESPACE
 class QSGRenderContext;
 class QSGDistanceFieldGlyphCacheManager;
 class QSGDistanceFieldTextMaterial;
-class QSGDistanceFieldGlyphNode: public QSGGlyphNode, public QSGDistanceFieldGlyphConsumer
+class QSGDistanceFieldGlyphNode: public QSGGlyphNode, public QSGDistanceFieldGlyphConsumer, public QSGPooledAllocation
 {
 public:
     QSGDistanceFieldGlyphNode(QSGRenderContext *context);
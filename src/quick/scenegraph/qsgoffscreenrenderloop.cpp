@@ -0,0 +1,405 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgoffscreenrenderloop_p.h"
+
+#include <QtCore/QCoreApplication>
+
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLFramebufferObject>
+#include <QtGui/QOpenGLFunctions>
+#include <QtGui/private/qopenglcontext_p.h>
+
+#include <QtQuick/private/qsgcontext_p.h>
+#include <QtQuick/private/qquickwindow_p.h>
+
+#include <QtQuick/QQuickWindow>
+
+QT_BEGIN_NAMESPACE
+
+/*
+   The offscreen render loop renders all windows into framebuffer objects
+   using a QOffscreenSurface, so it needs neither a visible window nor
+   vsync. Animations are driven by a virtual clock which advances by a
+   fixed step per frame, which makes runs repeatable.
+
+   QSG_OFFSCREEN_FPS selects the virtual frame rate. When it is 0 or not
+   set, frames are rendered back to back as fast as possible, with the
+   animation clock advancing 16 ms per frame.
+ */
+
+static bool qsg_render_timing = !qgetenv("QSG_RENDER_TIMING").isEmpty();
+
+class QSGVirtualAnimationDriver : public QAnimationDriver
+{
+public:
+    QSGVirtualAnimationDriver(qint64 step, QObject *parent)
+        : QAnimationDriver(parent)
+        , m_step(step)
+        , m_time(0)
+    {
+    }
+
+    void advance()
+    {
+        m_time += m_step;
+        QAnimationDriver::advance();
+    }
+
+    qint64 elapsed() const { return m_time; }
+    qint64 step() const { return m_step; }
+
+protected:
+    void start()
+    {
+        m_time = 0;
+        QAnimationDriver::start();
+    }
+
+private:
+    qint64 m_step;
+    qint64 m_time;
+};
+
+QSGOffscreenRenderLoop::QSGOffscreenRenderLoop()
+    : m_gl(0)
+    , m_surface(0)
+    , m_sg(QSGContext::createDefaultContext())
+    , m_updateTimer(0)
+    , m_frameInterval(0)
+{
+    m_rc = m_sg->createRenderContext();
+
+    int fps = qgetenv("QSG_OFFSCREEN_FPS").toInt();
+    if (fps > 0)
+        m_frameInterval = qMax(1, 1000 / fps);
+
+    m_animationDriver = new QSGVirtualAnimationDriver(m_frameInterval > 0 ? m_frameInterval : 16, this);
+    m_animationDriver->install();
+
+    connect(m_animationDriver, SIGNAL(started()), this, SLOT(started()));
+}
+
+QSGOffscreenRenderLoop::~QSGOffscreenRenderLoop()
+{
+    delete m_rc;
+    delete m_sg;
+    delete m_surface;
+}
+
+QAnimationDriver *QSGOffscreenRenderLoop::animationDriver() const
+{
+    return m_animationDriver;
+}
+
+bool QSGOffscreenRenderLoop::interleaveIncubation() const
+{
+    return m_animationDriver->isRunning() && !m_windows.isEmpty();
+}
+
+QSGOffscreenRenderLoop::WindowData *QSGOffscreenRenderLoop::windowData(QQuickWindow *window)
+{
+    for (int i=0; i<m_windows.size(); ++i) {
+        WindowData &wd = m_windows[i];
+        if (wd.window == window)
+            return &wd;
+    }
+    return 0;
+}
+
+void QSGOffscreenRenderLoop::maybePostUpdateTimer()
+{
+    if (!m_updateTimer)
+        m_updateTimer = startTimer(m_frameInterval, Qt::PreciseTimer);
+}
+
+void QSGOffscreenRenderLoop::started()
+{
+    maybePostUpdateTimer();
+}
+
+bool QSGOffscreenRenderLoop::ensureContext(QQuickWindow *window)
+{
+    if (m_gl)
+        return m_gl->makeCurrent(m_surface);
+
+    m_gl = new QOpenGLContext();
+    m_gl->setFormat(window->requestedFormat());
+    if (QOpenGLContextPrivate::globalShareContext())
+        m_gl->setShareContext(QOpenGLContextPrivate::globalShareContext());
+    if (!m_gl->create()) {
+        const bool isEs = m_gl->isOpenGLES();
+        delete m_gl;
+        m_gl = 0;
+        handleContextCreationFailure(window, isEs);
+        return false;
+    }
+
+    if (!m_surface) {
+        m_surface = new QOffscreenSurface();
+        m_surface->setFormat(m_gl->format());
+        m_surface->create();
+    }
+
+    QQuickWindowPrivate::get(window)->fireOpenGLContextCreated(m_gl);
+
+    if (!m_gl->makeCurrent(m_surface))
+        return false;
+    m_rc->initialize(m_gl);
+    return true;
+}
+
+bool QSGOffscreenRenderLoop::ensureRenderTarget(WindowData *wd)
+{
+    QSize size = wd->window->size() * wd->window->devicePixelRatio();
+    if (size.isEmpty())
+        return false;
+    if (wd->fbo && wd->fbo->size() == size)
+        return true;
+
+    delete wd->fbo;
+    wd->fbo = new QOpenGLFramebufferObject(size, QOpenGLFramebufferObject::CombinedDepthStencil);
+    wd->window->setRenderTarget(wd->fbo);
+    return true;
+}
+
+void QSGOffscreenRenderLoop::show(QQuickWindow *window)
+{
+    if (windowData(window) != 0)
+        return;
+
+    if (!ensureContext(window))
+        return;
+
+    WindowData data;
+    data.window = window;
+    data.fbo = 0;
+    data.pendingUpdate = true;
+    m_windows << data;
+
+    maybePostUpdateTimer();
+}
+
+void QSGOffscreenRenderLoop::hide(QQuickWindow *window)
+{
+    WindowData *wd = windowData(window);
+    if (!wd)
+        return;
+
+    QOpenGLFramebufferObject *fbo = wd->fbo;
+    for (int i=0; i<m_windows.size(); ++i) {
+        if (m_windows.at(i).window == window) {
+            m_windows.removeAt(i);
+            break;
+        }
+    }
+
+    if (!m_gl)
+        return;
+
+    QQuickWindowPrivate *cd = QQuickWindowPrivate::get(window);
+    m_gl->makeCurrent(m_surface);
+    cd->fireAboutToStop();
+    cd->cleanupNodesOnShutdown();
+    window->setRenderTarget(0);
+    delete fbo;
+
+    // If this is the last tracked window, check for persistent SG and GL and
+    // potentially clean up.
+    if (m_windows.size() == 0) {
+        if (!cd->persistentSceneGraph) {
+            m_rc->invalidate();
+            QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+            if (!cd->persistentGLContext) {
+                delete m_gl;
+                m_gl = 0;
+            }
+        }
+    }
+}
+
+void QSGOffscreenRenderLoop::windowDestroyed(QQuickWindow *window)
+{
+    hide(window);
+
+    // If this is the last tracked window, clean up SG and GL.
+    if (m_windows.size() == 0) {
+        if (m_gl)
+            m_gl->makeCurrent(m_surface);
+        m_rc->invalidate();
+        QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+        delete m_gl;
+        m_gl = 0;
+    }
+}
+
+void QSGOffscreenRenderLoop::exposureChanged(QQuickWindow *window)
+{
+    // Rendering does not depend on the window being on screen, but an
+    // expose is still a good reason to produce a fresh frame.
+    if (window->isExposed())
+        maybeUpdate(window);
+}
+
+QImage QSGOffscreenRenderLoop::grab(QQuickWindow *window)
+{
+    WindowData *wd = windowData(window);
+    if (!wd || !m_gl || !m_gl->makeCurrent(m_surface) || !ensureRenderTarget(wd))
+        return QImage();
+
+    QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
+    d->polishItems();
+    d->syncSceneGraph();
+    d->renderSceneGraph(window->size());
+
+    return wd->fbo->toImage();
+}
+
+void QSGOffscreenRenderLoop::update(QQuickWindow *window)
+{
+    maybeUpdate(window);
+}
+
+void QSGOffscreenRenderLoop::maybeUpdate(QQuickWindow *window)
+{
+    WindowData *wd = windowData(window);
+    if (!wd)
+        return;
+
+    wd->pendingUpdate = true;
+    maybePostUpdateTimer();
+}
+
+bool QSGOffscreenRenderLoop::event(QEvent *event)
+{
+    if (event->type() == QEvent::Timer
+            && static_cast<QTimerEvent *>(event)->timerId() == m_updateTimer) {
+        killTimer(m_updateTimer);
+        m_updateTimer = 0;
+        render();
+        return true;
+    }
+
+    return QObject::event(event);
+}
+
+/*
+ * Render all windows with pending updates, then advance the virtual
+ * animation clock by one frame.
+ */
+void QSGOffscreenRenderLoop::render()
+{
+    for (int i=0; i<m_windows.size(); ++i) {
+        if (m_windows.at(i).pendingUpdate) {
+            m_windows[i].pendingUpdate = false;
+            renderWindow(m_windows.at(i).window);
+        }
+    }
+
+    if (m_animationDriver->isRunning()) {
+        QElapsedTimer timer;
+        timer.start();
+        m_animationDriver->advance();
+        qint64 animationTime = timer.nsecsElapsed();
+        foreach (const WindowData &wd, m_windows)
+            QQuickWindowPrivate::get(wd.window)->frameTiming.animationTime = animationTime;
+
+        // Animations do not necessarily trigger an update, so keep
+        // producing frames while they run.
+        maybePostUpdateTimer();
+
+        emit timeToIncubate();
+    }
+}
+
+/*
+ * Polish, sync and render one window into its framebuffer object. The
+ * render time includes waiting for the GPU to finish, so the numbers
+ * reflect the actual cost of the frame.
+ */
+bool QSGOffscreenRenderLoop::renderWindow(QQuickWindow *window)
+{
+    WindowData *wd = windowData(window);
+    if (!wd || !window->isVisible() || !m_gl || !m_gl->makeCurrent(m_surface))
+        return false;
+    if (!ensureRenderTarget(wd))
+        return false;
+
+    QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    d->polishItems();
+    qint64 polishTime = timer.nsecsElapsed();
+
+    emit window->afterAnimating();
+
+    d->syncSceneGraph();
+    qint64 syncTime = timer.nsecsElapsed();
+
+    d->renderSceneGraph(window->size());
+    m_gl->functions()->glFinish();
+    qint64 renderTime = timer.nsecsElapsed();
+
+    d->fireFrameSwapped();
+
+    QQuickWindowPrivate::FrameTiming &ft = d->frameTiming;
+    ft.polishTime = polishTime;
+    ft.lockTime = 0;
+    ft.syncTime = syncTime - polishTime;
+    ft.renderTime = renderTime - syncTime;
+    ft.frameDelta = m_animationDriver->step() * 1000000;
+    ++ft.frameCount;
+
+    if (qsg_render_timing) {
+        qDebug("OffscreenRenderLoop: window=%p, frame=%d, polish=%d us, sync=%d us, render=%d us",
+               window,
+               ft.frameCount,
+               int(ft.polishTime / 1000),
+               int(ft.syncTime / 1000),
+               int(ft.renderTime / 1000));
+    }
+
+    return true;
+}
+
+QT_END_NAMESPACE
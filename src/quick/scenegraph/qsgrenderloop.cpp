@@ -42,6 +42,7 @@
 #include "qsgrenderloop_p.h"
 #include "qsgthreadedrenderloop_p.h"
 #include "qsgwindowsrenderloop_p.h"
+#include "qsgoffscreenrenderloop_p.h"
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QTime>
@@ -182,7 +183,8 @@ QSGRenderLoop *QSGRenderLoop::instance()
             enum RenderLoopType {
                 BasicRenderLoop,
                 ThreadedRenderLoop,
-                WindowsRenderLoop
+                WindowsRenderLoop,
+                OffscreenRenderLoop
             };
 
             RenderLoopType loopType = BasicRenderLoop;
@@ -205,6 +207,8 @@ QSGRenderLoop *QSGRenderLoop::instance()
                 loopType = BasicRenderLoop;
             else if (loopName == QByteArrayLiteral("threaded"))
                 loopType = ThreadedRenderLoop;
+            else if (loopName == QByteArrayLiteral("offscreen"))
+                loopType = OffscreenRenderLoop;
 
             switch (loopType) {
             case ThreadedRenderLoop:
@@ -215,6 +219,10 @@ QSGRenderLoop *QSGRenderLoop::instance()
                 if (info) qDebug() << "QSG: windows render loop";
                 s_instance = new QSGWindowsRenderLoop();
                 break;
+            case OffscreenRenderLoop:
+                if (info) qDebug() << "QSG: offscreen render loop";
+                s_instance = new QSGOffscreenRenderLoop();
+                break;
             default:
                 if (info) qDebug() << "QSG: basic render loop";
                 s_instance = new QSGGuiThreadRenderLoop();
@@ -149,6 +149,55 @@ static qint64 renderTime;
 static qint64 sinceLastTime;
 #endif
 
+// Frame pacing: both threads measure their phases against one clock so the
+// GUI thread can predict when the render thread swaps next.
+static bool qsg_frame_pacing = !qgetenv("QSG_FRAME_PACING").isEmpty();
+static QElapsedTimer qsg_pacing_clock;
+
+/*
+   Animation driver used in pacing mode. Instead of the time at which
+   advance() is called, animations see the time at which the frame they
+   produce is expected to be on screen. Time never runs backwards, even
+   if the prediction shrinks.
+ */
+class QSGPacedAnimationDriver : public QAnimationDriver
+{
+public:
+    QSGPacedAnimationDriver(QObject *parent)
+        : QAnimationDriver(parent)
+        , m_lead(0)
+        , m_last(0)
+    {
+    }
+
+    void setLead(qint64 lead) { m_lead = lead; }
+
+    qint64 elapsed() const
+    {
+        if (!m_timer.isValid())
+            return 0;
+        qint64 t = m_timer.elapsed() + m_lead;
+        if (t < m_last)
+            t = m_last;
+        m_last = t;
+        return t;
+    }
+
+protected:
+    void start()
+    {
+        m_timer.start();
+        m_lead = 0;
+        m_last = 0;
+        QAnimationDriver::start();
+    }
+
+private:
+    QElapsedTimer m_timer;
+    qint64 m_lead;
+    mutable qint64 m_last;
+};
+
 extern Q_GUI_EXPORT QImage qt_gl_read_framebuffer(const QSize &size, bool alpha_format, bool include_alpha);
 
 // RL: Render Loop
@@ -367,6 +416,10 @@ public:
     // Local event queue stuff...
     bool stopEventProcessing;
     QSGRenderThreadEventQueue eventQueue;
+
+    // Frame pacing, written by the render thread while holding 'mutex'.
+    // Swap times are on qsg_pacing_clock.
+    QSGFramePacing pacing;
 };
 
 bool QSGRenderThread::event(QEvent *e)
@@ -573,6 +626,9 @@ void QSGRenderThread::syncAndRender()
 #endif
     QElapsedTimer waitTimer;
     waitTimer.start();
+    qint64 pacingSyncTime = 0;
+    qint64 pacingSwapTime = -1;
+    qint64 pacingRenderDuration = 0;
 
     QSG_RT_DEBUG("syncAndRender()");
 
@@ -599,6 +655,8 @@ void QSGRenderThread::syncAndRender()
     if (profileFrames)
         syncTime = threadTimer.nsecsElapsed();
 #endif
+    if (qsg_frame_pacing)
+        pacingSyncTime = waitTimer.nsecsElapsed();
     QSG_RT_DEBUG(" - rendering starting");
 
     QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
@@ -620,6 +678,10 @@ void QSGRenderThread::syncAndRender()
 #endif
         gl->swapBuffers(window);
         d->fireFrameSwapped();
+        if (qsg_frame_pacing) {
+            pacingSwapTime = qsg_pacing_clock.elapsed();
+            pacingRenderDuration = waitTimer.nsecsElapsed() - pacingSyncTime;
+        }
     } else {
         QSG_RT_DEBUG(" - Window not yet ready, skipping render...");
     }
@@ -637,6 +699,9 @@ void QSGRenderThread::syncAndRender()
         exposeCycle = NoExpose;
         waitCondition.wakeOne();
     }
+    // The pacing data is updated here to not take the lock twice per frame.
+    if (pacingSwapTime >= 0)
+        pacing.frameSwapped(pacingSwapTime, pacingRenderDuration, vsyncDelta);
     mutex.unlock();
 
 #ifndef QSG_NO_RENDER_TIMING
@@ -712,6 +777,11 @@ void QSGRenderThread::run()
             sleeping = true;
             processEventsAndWaitForMore();
             sleeping = false;
+            if (qsg_frame_pacing) {
+                mutex.lock();
+                pacing.idle();
+                mutex.unlock();
+            }
         }
     }
 
@@ -734,7 +804,12 @@ QSGThreadedRenderLoop::QSGThreadedRenderLoop()
     qsgrl_timer.start();
 #endif
 
-    m_animation_driver = sg->createAnimationDriver(this);
+    if (qsg_frame_pacing) {
+        qsg_pacing_clock.start();
+        m_animation_driver = new QSGPacedAnimationDriver(this);
+    } else {
+        m_animation_driver = sg->createAnimationDriver(this);
+    }
 
     m_exhaust_delay = get_env_int("QML_EXHAUST_DELAY", 5);
 
@@ -750,11 +825,11 @@ QSGRenderContext *QSGThreadedRenderLoop::createRenderContext(QSGContext *sg) con
     return sg->createRenderContext();
 }
 
-void QSGThreadedRenderLoop::maybePostPolishRequest(Window *w)
+void QSGThreadedRenderLoop::maybePostPolishRequest(Window *w, int delay)
 {
     if (w->timerId == 0) {
         QSG_GUI_DEBUG(w->window, " - posting update");
-        w->timerId = startTimer(m_exhaust_delay, Qt::PreciseTimer);
+        w->timerId = startTimer(delay >= 0 ? delay : m_exhaust_delay, Qt::PreciseTimer);
     }
 }
 
@@ -1136,23 +1211,23 @@ bool QSGThreadedRenderLoop::polishAndSync(Window *w)
     }
 
 
-#ifndef QSG_NO_RENDER_TIMING
     QElapsedTimer timer;
     qint64 polishTime = 0;
     qint64 waitTime = 0;
     qint64 syncTime = 0;
-    bool profileFrames = qsg_render_timing  || QQuickProfiler::enabled;
+#ifndef QSG_NO_RENDER_TIMING
+    bool profileFrames = qsg_render_timing  || QQuickProfiler::enabled || qsg_frame_pacing;
+#else
+    bool profileFrames = qsg_frame_pacing;
+#endif
     if (profileFrames)
         timer.start();
-#endif
 
     QQuickWindowPrivate *d = QQuickWindowPrivate::get(w->window);
     d->polishItems();
 
-#ifndef QSG_NO_RENDER_TIMING
     if (profileFrames)
         polishTime = timer.nsecsElapsed();
-#endif
 
     w->updateDuringSync = false;
 
@@ -1164,34 +1239,60 @@ bool QSGThreadedRenderLoop::polishAndSync(Window *w)
     w->thread->postEvent(new QEvent(WM_RequestSync));
 
     QSG_GUI_DEBUG(w->window, " - wait for sync...");
-#ifndef QSG_NO_RENDER_TIMING
     if (profileFrames)
         waitTime = timer.nsecsElapsed();
-#endif
     w->thread->waitCondition.wait(&w->thread->mutex);
     m_locked = false;
+    QSGFramePacing pacing;
+    if (qsg_frame_pacing)
+        pacing = w->thread->pacing;
     w->thread->mutex.unlock();
     QSG_GUI_DEBUG(w->window, " - unlocked after sync...");
 
-#ifndef QSG_NO_RENDER_TIMING
     if (profileFrames)
         syncTime = timer.nsecsElapsed();
-#endif
 
     killTimer(w->timerId);
     w->timerId = 0;
 
+    // In pacing mode, predict when the render thread swaps the frame it is
+    // rendering now. The animation state computed below is synced right
+    // after that swap and shown one frame later. Instead of the fixed
+    // exhaust delay, the next polish is also scheduled to finish just as
+    // the render thread becomes free, so the GUI thread does not sit
+    // blocked in the sync lock.
+    int polishDelay = -1;
+    if (qsg_frame_pacing) {
+        d->frameTiming.renderTime = pacing.renderDuration;
+        d->frameTiming.frameDelta = pacing.frameDelta;
+        d->frameTiming.frameCount = pacing.frameCount;
+        d->frameTiming.missedFrames = pacing.missedFrames;
+
+        qint64 now = qsg_pacing_clock.elapsed();
+        qreal vsync = qMax<qreal>(1, w->thread->vsyncDelta);
+        qint64 nextSwap = pacing.predictSwap(now, vsync);
+        static_cast<QSGPacedAnimationDriver *>(m_animation_driver)->setLead(qRound64(nextSwap + vsync - now));
+        polishDelay = qBound<qint64>(0, nextSwap - now - polishTime / 1000000 - 1, qCeil(vsync));
+    }
+
     if (m_animation_timer == 0 && m_animation_driver->isRunning()) {
         QSG_GUI_DEBUG(w->window, " - animations advancing");
         m_animation_driver->advance();
         QSG_GUI_DEBUG(w->window, " - animations done");
         // We need to trigger another sync to keep animations running...
-        maybePostPolishRequest(w);
+        maybePostPolishRequest(w, polishDelay);
         emit timeToIncubate();
     } else if (w->updateDuringSync) {
         maybePostPolishRequest(w);
     }
 
+    if (qsg_frame_pacing) {
+        d->frameTiming.polishTime = polishTime;
+        d->frameTiming.lockTime = waitTime - polishTime;
+        d->frameTiming.syncTime = syncTime - waitTime;
+        d->frameTiming.animationTime = timer.nsecsElapsed() - syncTime;
+    }
+
 
 #ifndef QSG_NO_RENDER_TIMING
     if (qsg_render_timing)
@@ -43,6 +43,7 @@
 #define QSGTHREADEDRENDERLOOP_P_H
 
 #include <QtCore/QThread>
+#include <QtCore/qmath.h>
 #include <QtGui/QOpenGLContext>
 #include <private/qsgcontext_p.h>
 
@@ -52,6 +53,58 @@ QT_BEGIN_NAMESPACE
 
 class QSGRenderThread;
 
+/*
+    Swap statistics for frame pacing. Swap times are in ms, durations in ns.
+ */
+class QSGFramePacing
+{
+public:
+    QSGFramePacing()
+        : lastSwapTime(-1)
+        , renderDuration(0)
+        , frameDelta(0)
+        , frameCount(0)
+        , missedFrames(0)
+    {
+    }
+
+    // Records a swap at swapTime, duration being the time spent between the
+    // end of sync and the end of the swap.
+    void frameSwapped(qint64 swapTime, qint64 duration, qreal vsyncDelta)
+    {
+        if (lastSwapTime >= 0) {
+            frameDelta = (swapTime - lastSwapTime) * 1000000;
+            int frames = qRound((swapTime - lastSwapTime) / vsyncDelta);
+            if (frames > 1)
+                missedFrames += frames - 1;
+        }
+        lastSwapTime = swapTime;
+        ++frameCount;
+        // Smooth over a few frames so a single hiccup does not skew the prediction.
+        renderDuration = renderDuration > 0 ? (3 * renderDuration + duration) / 4 : duration;
+    }
+
+    // Idle time is not a missed frame.
+    void idle() { lastSwapTime = -1; }
+
+    // The vsync aligned time of the swap for a frame whose rendering
+    // starts at now. The interval is kept fractional, a 60 Hz display
+    // would otherwise drift by two thirds of a millisecond per frame.
+    qint64 predictSwap(qint64 now, qreal vsyncDelta) const
+    {
+        qint64 nextSwap = now + renderDuration / 1000000;
+        if (lastSwapTime >= 0 && nextSwap > lastSwapTime)
+            nextSwap = lastSwapTime + qRound64(qCeil((nextSwap - lastSwapTime) / vsyncDelta) * vsyncDelta);
+        return nextSwap;
+    }
+
+    qint64 lastSwapTime;
+    qint64 renderDuration;
+    qint64 frameDelta;
+    int frameCount;
+    int missedFrames;
+};
+
 class QSGThreadedRenderLoop : public QSGRenderLoop
 {
     Q_OBJECT
@@ -101,7 +154,7 @@ private:
     void initialize();
 
     void startOrStopAnimationTimer();
-    void maybePostPolishRequest(Window *w);
+    void maybePostPolishRequest(Window *w, int delay = -1);
     void waitForReleaseComplete();
     bool polishAndSync(Window *w);
     void maybeUpdate(Window *window);
@@ -42,7 +42,9 @@ HEADERS += \
     $$PWD/util/qsgtextureprovider.h \
     $$PWD/util/qsgpainternode_p.h \
     $$PWD/util/qsgdistancefieldutil_p.h \
-    $$PWD/util/qsgshadersourcebuilder_p.h
+    $$PWD/util/qsgshadersourcebuilder_p.h \
+    $$PWD/util/qsgshadercache_p.h \
+    $$PWD/util/qsgpoolallocator_p.h
 
 SOURCES += \
     $$PWD/util/qsgareaallocator.cpp \
@@ -58,7 +60,9 @@ SOURCES += \
     $$PWD/util/qsgpainternode.cpp \
     $$PWD/util/qsgdistancefieldutil.cpp \
     $$PWD/util/qsgsimplematerial.cpp \
-    $$PWD/util/qsgshadersourcebuilder.cpp
+    $$PWD/util/qsgshadersourcebuilder.cpp \
+    $$PWD/util/qsgshadercache.cpp \
+    $$PWD/util/qsgpoolallocator.cpp
 
 # QML / Adaptations API
 HEADERS += \
@@ -75,6 +79,7 @@ HEADERS += \
     $$PWD/qsgshareddistancefieldglyphcache_p.h \
     $$PWD/qsgrenderloop_p.h \
     $$PWD/qsgthreadedrenderloop_p.h \
+    $$PWD/qsgoffscreenrenderloop_p.h \
     $$PWD/qsgwindowsrenderloop_p.h
 
 SOURCES += \
@@ -91,6 +96,7 @@ SOURCES += \
     $$PWD/qsgshareddistancefieldglyphcache.cpp \
     $$PWD/qsgrenderloop.cpp \
     $$PWD/qsgthreadedrenderloop.cpp \
+    $$PWD/qsgoffscreenrenderloop.cpp \
     $$PWD/qsgwindowsrenderloop.cpp
 
 RESOURCES += \
@@ -91,7 +91,8 @@ static int qsg_envInt(const char *name, int defaultValue)
 }
 
 Manager::Manager()
-    : m_atlas(0)
+    : m_fallbacks(0)
+    , m_drains(0)
 {
     QOpenGLContext *gl = QOpenGLContext::currentContext();
     Q_ASSERT(gl);
@@ -106,41 +107,119 @@ Manager::Manager()
     m_atlas_size_limit = qsg_envInt("QSG_ATLAS_SIZE_LIMIT", qMax(w, h) / 2);
     m_atlas_size = QSize(w, h);
 
+    m_max_pages = qMax(1, qsg_envInt("QSG_ATLAS_MAX_PAGES", 4));
+    m_fragmentation_threshold = qBound(0, qsg_envInt("QSG_ATLAS_DEFRAG_THRESHOLD", 50), 100) / 100.;
+
     if (qEnvironmentVariableIsSet("QSG_INFO"))
-        qDebug() << "QSG: texture atlas dimensions:" << w << "x" << h;
+        qDebug() << "QSG: texture atlas dimensions:" << w << "x" << h << "pages:" << m_max_pages;
 }
 
 
 Manager::~Manager()
 {
-    Q_ASSERT(m_atlas == 0);
+    Q_ASSERT(m_atlases.isEmpty());
 }
 
 void Manager::invalidate()
 {
-    if (m_atlas) {
-        m_atlas->invalidate();
-        m_atlas->deleteLater();
-        m_atlas = 0;
+    if (!m_atlases.isEmpty() && qEnvironmentVariableIsSet("QSG_INFO"))
+        printStatistics("invalidated");
+
+    foreach (Atlas *atlas, m_atlases) {
+        atlas->invalidate();
+        atlas->deleteLater();
     }
+    m_atlases.clear();
 }
 
+/*
+    Textures already in an atlas are never moved, as nodes bake the
+    normalized sub rect into their vertex data. Instead, a page where an
+    allocation fails even though a large part of it is free stops taking new
+    textures. Images go to the other pages until the fragmented page has
+    drained, after which it is reused from scratch.
+ */
 QSGTexture *Manager::create(const QImage &image)
 {
-    QSGTexture *t = 0;
-    if (image.width() < m_atlas_size_limit && image.height() < m_atlas_size_limit) {
-        if (!m_atlas)
-            m_atlas = new Atlas(m_atlas_size);
-        t = m_atlas->create(image);
+    if (image.width() >= m_atlas_size_limit || image.height() >= m_atlas_size_limit)
+        return 0;
+
+    for (int i = 0; i < m_atlases.size(); ++i) {
+        Atlas *atlas = m_atlases.at(i);
+        if (atlas->isDraining()) {
+            if (!atlas->isEmpty())
+                continue;
+            atlas->setDraining(false);
+            ++m_drains;
+        } else if (i > 0 && atlas->isEmpty()) {
+            // Give the memory of unused extra pages back, they are
+            // reallocated when bound again.
+            atlas->release();
+        }
+
+        if (Texture *t = atlas->create(image))
+            return t;
+
+        if (atlas->fragmentation() > m_fragmentation_threshold) {
+            atlas->setDraining(true);
+            if (qEnvironmentVariableIsSet("QSG_INFO"))
+                printStatistics("page fragmented");
+        }
+    }
+
+    if (m_atlases.size() < m_max_pages) {
+        Atlas *atlas = new Atlas(m_atlas_size);
+        m_atlases << atlas;
+        if (qEnvironmentVariableIsSet("QSG_INFO"))
+            printStatistics("page added");
+        if (Texture *t = atlas->create(image))
+            return t;
+    }
+
+    // Last resort, rather than a standalone texture, use space left in
+    // pages which are draining.
+    foreach (Atlas *atlas, m_atlases) {
+        if (atlas->isDraining()) {
+            if (Texture *t = atlas->create(image))
+                return t;
+        }
     }
-    return t;
+
+    ++m_fallbacks;
+    return 0;
+}
+
+Manager::Statistics Manager::statistics() const
+{
+    Statistics stats;
+    stats.pages = m_atlases.size();
+    foreach (Atlas *atlas, m_atlases) {
+        stats.textures += atlas->textureCount();
+        stats.usedArea += atlas->usedArea();
+        stats.totalArea += qint64(atlas->size().width()) * atlas->size().height();
+    }
+    stats.fallbacks = m_fallbacks;
+    stats.drains = m_drains;
+    return stats;
+}
+
+void Manager::printStatistics(const char *event) const
+{
+    const Statistics stats = statistics();
+    qDebug("QSG: texture atlas %s: %d pages, %d textures, %.1f%% occupied, %d fallbacks, %d drained pages",
+           event, stats.pages, stats.textures,
+           stats.totalArea ? 100. * stats.usedArea / stats.totalArea : 0.,
+           stats.fallbacks, stats.drains);
 }
 
 Atlas::Atlas(const QSize &size)
     : m_allocator(size)
     , m_texture_id(0)
     , m_size(size)
+    , m_texture_count(0)
+    , m_used_area(0)
     , m_allocated(false)
+    , m_draining(false)
 {
 
     m_internalFormat = GL_RGBA;
@@ -198,6 +277,21 @@ void Atlas::invalidate()
     }
 }
 
+void Atlas::release()
+{
+    Q_ASSERT(isEmpty());
+    if (m_allocated) {
+        invalidate();
+        m_allocated = false;
+    }
+}
+
+qreal Atlas::fragmentation() const
+{
+    // The share of the atlas which is free but could not be handed out.
+    return 1 - qreal(m_used_area) / (qreal(m_size.width()) * m_size.height());
+}
+
 Texture *Atlas::create(const QImage &image)
 {
     // No need to lock, as manager already locked it.
@@ -205,6 +299,8 @@ Texture *Atlas::create(const QImage &image)
     if (rect.width() > 0 && rect.height() > 0) {
         Texture *t = new Texture(this, rect, image);
         m_pending_uploads << t;
+        ++m_texture_count;
+        m_used_area += qint64(rect.width()) * rect.height();
         return t;
     }
     return 0;
@@ -419,6 +515,8 @@ void Atlas::remove(Texture *t)
     QRect atlasRect = t->atlasSubRect();
     m_allocator.deallocate(atlasRect);
     m_pending_uploads.removeOne(t);
+    --m_texture_count;
+    m_used_area -= qint64(atlasRect.width()) * atlasRect.height();
 }
 
 
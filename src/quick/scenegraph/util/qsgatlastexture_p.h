@@ -43,6 +43,7 @@
 #define QSGATLASTEXTURE_P_H
 
 #include <QtCore/QSize>
+#include <QtCore/QList>
 
 #include <QtGui/qopengl.h>
 
@@ -69,11 +70,29 @@ public:
     QSGTexture *create(const QImage &image);
     void invalidate();
 
+    struct Statistics {
+        Statistics() : pages(0), textures(0), usedArea(0), totalArea(0), fallbacks(0), drains(0) { }
+        int pages;
+        int textures;
+        qint64 usedArea;
+        qint64 totalArea;
+        int fallbacks;      // images that fit the size limit but got a standalone texture
+        int drains;         // fragmented pages that were emptied and reused
+    };
+    Statistics statistics() const;
+
 private:
-    Atlas *m_atlas;
+    void printStatistics(const char *event) const;
+
+    QList<Atlas *> m_atlases;
 
     QSize m_atlas_size;
     int m_atlas_size_limit;
+    int m_max_pages;
+    qreal m_fragmentation_threshold;
+
+    int m_fallbacks;
+    int m_drains;
 };
 
 class Atlas : public QObject
@@ -92,20 +111,33 @@ public:
 
     Texture *create(const QImage &image);
     void remove(Texture *t);
+    void release();
 
     QSize size() const { return m_size; }
 
+    bool isEmpty() const { return m_texture_count == 0; }
+    int textureCount() const { return m_texture_count; }
+    qint64 usedArea() const { return m_used_area; }
+    qreal fragmentation() const;
+
+    bool isDraining() const { return m_draining; }
+    void setDraining(bool draining) { m_draining = draining; }
+
 private:
     QSGAreaAllocator m_allocator;
     GLuint m_texture_id;
     QSize m_size;
     QList<Texture *> m_pending_uploads;
 
+    int m_texture_count;
+    qint64 m_used_area;
+
     GLuint m_internalFormat;
     GLuint m_externalFormat;
 
     uint m_allocated : 1;
     uint m_use_bgra_fallback: 1;
+    uint m_draining : 1;
 
     uint m_debug_overlay : 1;
 };
@@ -133,6 +165,7 @@ public:
     QSGTexture *removedFromAtlas() const;
 
     const QImage &image() const { return m_image; }
+    Atlas *atlas() const { return m_atlas; }
 
     void bind();
 
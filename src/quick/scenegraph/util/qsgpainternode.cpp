@@ -73,17 +73,58 @@ QSGPainterTexture::QSGPainterTexture()
     m_retain_image = true;
 }
 
+/*
+    The image can be repainted several times before the texture is bound
+    again, so the dirty rects are united until bind() uploads them. A null
+    rect marks the whole image as dirty.
+ */
+void QSGPainterTexture::setDirtyRect(const QRect &rect)
+{
+    m_dirty_rect |= rect.isNull() ? m_image.rect() : rect;
+}
+
+void qsg_textureFormats(GLenum *internalFormat, GLenum *externalFormat);
+void qsg_swizzleBGRAToRGBA(QImage *image);
+
+/*
+    When only part of an image of unchanged size was repainted, just that
+    part is uploaded into the existing texture. Everything else, including
+    the first upload and mipmapped textures, goes through the plain path.
+ */
 void QSGPainterTexture::bind()
 {
-    if (m_dirty_rect.isNull()) {
+    const QRect rect = m_dirty_rect.intersected(m_image.rect());
+    if (!m_dirty_texture || m_dirty_rect.isNull() || m_texture_id == 0
+            || m_uploaded_size != m_image.size() || rect == m_image.rect()
+            || mipmapFiltering() != QSGTexture::None) {
         QSGPlainTexture::bind();
+        m_uploaded_size = m_texture_id ? m_texture_size : QSize();
+        m_dirty_rect = QRect();
         return;
     }
 
-    setImage(m_image);
-    QSGPlainTexture::bind();
-
+    m_dirty_texture = false;
     m_dirty_rect = QRect();
+
+    glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    updateBindOptions(m_dirty_bind_options);
+    m_dirty_bind_options = false;
+
+    if (rect.isEmpty())
+        return;
+
+    QImage tmp = m_image.copy(rect);
+    if (tmp.format() != QImage::Format_RGB32 && tmp.format() != QImage::Format_ARGB32_Premultiplied)
+        tmp = tmp.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    GLenum internalFormat;
+    GLenum externalFormat;
+    qsg_textureFormats(&internalFormat, &externalFormat);
+    if (externalFormat == GL_RGBA)
+        qsg_swizzleBGRAToRGBA(&tmp);
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x(), rect.y(), rect.width(), rect.height(),
+                    externalFormat, GL_UNSIGNED_BYTE, tmp.constBits());
 }
 
 QSGPainterNode::QSGPainterNode(QQuickPaintedItem *item)
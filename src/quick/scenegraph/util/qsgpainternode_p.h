@@ -60,12 +60,13 @@ class Q_QUICK_PRIVATE_EXPORT QSGPainterTexture : public QSGPlainTexture
 public:
     QSGPainterTexture();
 
-    void setDirtyRect(const QRect &rect) { m_dirty_rect = rect; }
+    void setDirtyRect(const QRect &rect);
 
     void bind();
 
 private:
     QRect m_dirty_rect;
+    QSize m_uploaded_size;
 };
 
 class Q_QUICK_PRIVATE_EXPORT QSGPainterNode : public QSGGeometryNode
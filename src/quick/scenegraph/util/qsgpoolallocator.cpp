@@ -0,0 +1,229 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgpoolallocator_p.h"
+
+#include <QtCore/qdebug.h>
+#include <QtCore/qthreadstorage.h>
+
+#include <stdlib.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The pool allocator hands out blocks from a fixed set of size classes:
+    16 byte steps up to 512 bytes, which covers the node types, and four
+    steps per power of two up to 64 KB for vertex and index storage, which
+    keeps the rounding below 25%. Every pooled block of a given class is
+    allocated with the full size of the class, so blocks can be moved
+    freely between pools and the C heap. Callers which record the size
+    class get a block of the exact size when no pool is current, since it
+    could never be reused anyway.
+
+    Each QSGRenderContext owns one pool and makes it current for the
+    rendering thread while it is initialized, and frees its cache when it
+    is invalidated. A pool caches at most MaxCachedBytes over all size
+    classes. Blocks released on a thread without a current pool, or to a
+    pool whose budget is used up, go straight back to the C heap.
+ */
+
+struct QSGPoolAllocatorRef
+{
+    QSGPoolAllocatorRef() : pool(0) { }
+    QSGPoolAllocator *pool;
+};
+
+Q_GLOBAL_STATIC(QThreadStorage<QSGPoolAllocatorRef>, qsg_current_pool_allocator)
+
+QSGPoolAllocator::QSGPoolAllocator()
+    : m_cachedBytes(0)
+    , m_allocations(0)
+    , m_reused(0)
+    , m_recycled(0)
+{
+    for (int i = 0; i < SizeClassCount; ++i) {
+        m_free[i] = 0;
+        m_freeCount[i] = 0;
+    }
+}
+
+QSGPoolAllocator::~QSGPoolAllocator()
+{
+    if (current() == this)
+        setCurrent(0);
+    clear();
+}
+
+int QSGPoolAllocator::sizeClassFor(size_t size)
+{
+    if (size <= 512)
+        return size == 0 ? 0 : int((size + 15) / 16) - 1;
+    if (size > size_t(MaxBlockSize))
+        return -1;
+    int shift = 9;
+    while ((size_t(2) << shift) < size)
+        ++shift;
+    const size_t step = size_t(1) << (shift - 2);
+    return 32 + (shift - 9) * 4 + int((size - (size_t(1) << shift) + step - 1) / step) - 1;
+}
+
+size_t QSGPoolAllocator::blockSize(int sizeClass)
+{
+    Q_ASSERT(sizeClass >= 0 && sizeClass < SizeClassCount);
+    if (sizeClass < 32)
+        return size_t(sizeClass + 1) * 16;
+    const int shift = 9 + (sizeClass - 32) / 4;
+    return (size_t(1) << shift) + size_t((sizeClass - 32) % 4 + 1) * (size_t(1) << (shift - 2));
+}
+
+/*!
+    Allocates a block of at least \a size bytes from the pool which is current
+    for the calling thread, or from the C heap if there is none. The size class
+    of the block is stored in \a sizeClass, or -1 if the block is too large to
+    be pooled or was allocated with its exact size because no pool was current.
+ */
+void *QSGPoolAllocator::allocate(size_t size, int *sizeClass)
+{
+    int c = sizeClassFor(size);
+    QSGPoolAllocator *pool = c < 0 ? 0 : current();
+    if (!pool && sizeClass)
+        c = -1;
+    if (sizeClass)
+        *sizeClass = c;
+
+    void *block = 0;
+    if (c < 0) {
+        block = malloc(size);
+    } else {
+        if (pool) {
+            ++pool->m_allocations;
+            if (FreeBlock *b = pool->m_free[c]) {
+                pool->m_free[c] = b->next;
+                --pool->m_freeCount[c];
+                pool->m_cachedBytes -= blockSize(c);
+                ++pool->m_reused;
+                return b;
+            }
+        }
+        block = malloc(blockSize(c));
+    }
+    Q_CHECK_PTR(block);
+    return block;
+}
+
+/*!
+    Returns \a block, allocated with allocate() in size class \a sizeClass, to
+    the pool which is current for the calling thread. The block is freed if
+    there is no current pool or if caching it would take the pool over its
+    byte budget.
+ */
+void QSGPoolAllocator::release(void *block, int sizeClass)
+{
+    if (!block)
+        return;
+
+    if (sizeClass >= 0) {
+        QSGPoolAllocator *pool = current();
+        const size_t size = blockSize(sizeClass);
+        if (pool && pool->m_cachedBytes + size <= size_t(MaxCachedBytes)) {
+            FreeBlock *b = static_cast<FreeBlock *>(block);
+            b->next = pool->m_free[sizeClass];
+            pool->m_free[sizeClass] = b;
+            ++pool->m_freeCount[sizeClass];
+            pool->m_cachedBytes += size;
+            ++pool->m_recycled;
+            return;
+        }
+    }
+
+    free(block);
+}
+
+QSGPoolAllocator *QSGPoolAllocator::current()
+{
+    QThreadStorage<QSGPoolAllocatorRef> *storage = qsg_current_pool_allocator();
+    if (!storage || !storage->hasLocalData())
+        return 0;
+    return storage->localData().pool;
+}
+
+void QSGPoolAllocator::setCurrent(QSGPoolAllocator *pool)
+{
+    QThreadStorage<QSGPoolAllocatorRef> *storage = qsg_current_pool_allocator();
+    if (!storage || (!pool && !storage->hasLocalData()))
+        return;
+    storage->localData().pool = pool;
+}
+
+/*!
+    Frees all blocks cached in the pool.
+ */
+void QSGPoolAllocator::clear()
+{
+    for (int i = 0; i < SizeClassCount; ++i) {
+        FreeBlock *b = m_free[i];
+        while (b) {
+            FreeBlock *next = b->next;
+            free(b);
+            b = next;
+        }
+        m_free[i] = 0;
+        m_freeCount[i] = 0;
+    }
+    m_cachedBytes = 0;
+}
+
+int QSGPoolAllocator::cachedBlocks() const
+{
+    int blocks = 0;
+    for (int i = 0; i < SizeClassCount; ++i)
+        blocks += m_freeCount[i];
+    return blocks;
+}
+
+void QSGPoolAllocator::printStatistics() const
+{
+    qDebug() << "QSG: node and geometry pool:" << m_allocations << "allocations,"
+             << m_reused << "reused," << m_recycled << "recycled,"
+             << cachedBlocks() << "blocks," << int(cachedBytes() / 1024) << "KB cached";
+}
+
+QT_END_NAMESPACE
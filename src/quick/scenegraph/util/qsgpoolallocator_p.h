@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSGPOOLALLOCATOR_P_H
+#define QSGPOOLALLOCATOR_P_H
+
+#include <private/qtquickglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_QUICK_PRIVATE_EXPORT QSGPoolAllocator
+{
+public:
+    enum {
+        SizeClassCount = 60,
+        MaxBlockSize = 65536,
+        MaxCachedBytes = 1024 * 1024
+    };
+
+    QSGPoolAllocator();
+    ~QSGPoolAllocator();
+
+    static int sizeClassFor(size_t size);
+    static size_t blockSize(int sizeClass);
+
+    static void *allocate(size_t size, int *sizeClass = 0);
+    static void release(void *block, int sizeClass);
+
+    static QSGPoolAllocator *current();
+    static void setCurrent(QSGPoolAllocator *pool);
+
+    void clear();
+
+    quint64 allocations() const { return m_allocations; }
+    quint64 reused() const { return m_reused; }
+    quint64 recycled() const { return m_recycled; }
+    int cachedBlocks() const;
+    size_t cachedBytes() const { return m_cachedBytes; }
+    void printStatistics() const;
+
+private:
+    Q_DISABLE_COPY(QSGPoolAllocator)
+
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    FreeBlock *m_free[SizeClassCount];
+    int m_freeCount[SizeClassCount];
+    size_t m_cachedBytes;
+
+    quint64 m_allocations;
+    quint64 m_reused;
+    quint64 m_recycled;
+};
+
+class QSGPooledAllocation
+{
+public:
+    static void *operator new(size_t size) { return QSGPoolAllocator::allocate(size); }
+    static void operator delete(void *block, size_t size) { QSGPoolAllocator::release(block, QSGPoolAllocator::sizeClassFor(size)); }
+};
+
+template <typename Node>
+class QSGPooledNode : public Node, public QSGPooledAllocation
+{
+};
+
+QT_END_NAMESPACE
+
+#endif // QSGPOOLALLOCATOR_P_H
@@ -0,0 +1,361 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgshadercache_p.h"
+
+#include <QtGui/qopenglcontext.h>
+#include <QtGui/qopenglfunctions.h>
+#include <QtGui/qopenglshaderprogram.h>
+#include <QtGui/private/qopenglcontext_p.h>
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qdebug.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qstandardpaths.h>
+
+QT_BEGIN_NAMESPACE
+
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+
+static const quint32 qsg_shader_cache_magic = 0x51534742; // "QSGB"
+static const quint32 qsg_shader_cache_version = 1;
+
+/*
+    Linked programs are written to disk as driver binaries and loaded again
+    on the next launch, which skips compiling and linking the GLSL sources.
+    Entries are keyed on the GL vendor, renderer and version strings together
+    with the sources and attribute names, so a driver update or a changed
+    shader simply misses. A binary the driver refuses is deleted and the
+    program is built from source as before.
+
+    Setting QT_DISABLE_SHADER_DISK_CACHE turns the cache off, QSG_INFO reports
+    hits and misses.
+ */
+class QSGShaderCacheData
+{
+public:
+    QSGShaderCacheData()
+        : info(qEnvironmentVariableIsSet("QSG_INFO"))
+    {
+        configure(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    }
+
+    void configure(const QString &base)
+    {
+        enabled = !qEnvironmentVariableIsSet("QT_DISABLE_SHADER_DISK_CACHE");
+        path.clear();
+        if (base.isEmpty())
+            enabled = false;
+        else
+            path = base + QLatin1String("/qtshadercache/");
+        if (enabled && !QDir().mkpath(path))
+            enabled = false;
+        hits.store(0);
+        misses.store(0);
+        rejected.store(0);
+        if (info)
+            qDebug() << "QSG: shader cache:" << (enabled ? path : QStringLiteral("disabled"));
+    }
+
+    void report(const char *what, const QByteArray &key)
+    {
+        if (info)
+            qDebug("QSG: shader cache %s %s (hits: %d, misses: %d)", what, key.left(8).constData(),
+                   hits.load(), misses.load());
+    }
+
+    bool enabled;
+    bool info;
+    QString path;
+    QAtomicInt hits;
+    QAtomicInt misses;
+    QAtomicInt rejected;
+};
+
+Q_GLOBAL_STATIC(QSGShaderCacheData, qsg_shader_cache)
+
+/*
+    The entry points are resolved once per share group, the same way
+    QOpenGLFunctions keeps its resolved functions.
+ */
+struct QSGProgramBinaryFunctions : public QOpenGLSharedResource
+{
+    typedef void (QOPENGLF_APIENTRYP GetProgramBinary)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, GLvoid *binary);
+    typedef void (QOPENGLF_APIENTRYP ProgramBinary)(GLuint program, GLenum binaryFormat, const GLvoid *binary, GLint length);
+    typedef void (QOPENGLF_APIENTRYP ProgramParameteri)(GLuint program, GLenum pname, GLint value);
+
+    QSGProgramBinaryFunctions(QOpenGLContext *ctx)
+        : QOpenGLSharedResource(ctx->shareGroup())
+        , getProgramBinary(0)
+        , programBinary(0)
+        , programParameteri(0)
+    {
+        const QSurfaceFormat format = ctx->format();
+        bool supported;
+        if (ctx->isOpenGLES())
+            supported = format.majorVersion() >= 3 || ctx->hasExtension(QByteArrayLiteral("GL_OES_get_program_binary"));
+        else
+            supported = format.version() >= qMakePair(4, 1) || ctx->hasExtension(QByteArrayLiteral("GL_ARB_get_program_binary"));
+        if (!supported)
+            return;
+
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        if (formats <= 0)
+            return;
+
+        getProgramBinary = (GetProgramBinary) ctx->getProcAddress("glGetProgramBinary");
+        programBinary = (ProgramBinary) ctx->getProcAddress("glProgramBinary");
+        if (!getProgramBinary || !programBinary) {
+            getProgramBinary = (GetProgramBinary) ctx->getProcAddress("glGetProgramBinaryOES");
+            programBinary = (ProgramBinary) ctx->getProcAddress("glProgramBinaryOES");
+        }
+        if (!ctx->isOpenGLES())
+            programParameteri = (ProgramParameteri) ctx->getProcAddress("glProgramParameteri");
+    }
+
+    bool isValid() const { return getProgramBinary && programBinary; }
+
+    void invalidateResource()
+    {
+        getProgramBinary = 0;
+        programBinary = 0;
+        programParameteri = 0;
+    }
+
+    void freeResource(QOpenGLContext *) { }
+
+    GetProgramBinary getProgramBinary;
+    ProgramBinary programBinary;
+    ProgramParameteri programParameteri;
+};
+
+Q_GLOBAL_STATIC(QOpenGLMultiGroupSharedResource, qsg_program_binary_functions_resource)
+
+static QSGProgramBinaryFunctions *qsg_programBinaryFunctions()
+{
+    QOpenGLContext *ctx = QOpenGLContext::currentContext();
+    if (!ctx)
+        return 0;
+    QSGProgramBinaryFunctions *functions = qsg_program_binary_functions_resource()->value<QSGProgramBinaryFunctions>(ctx);
+    return functions->isValid() ? functions : 0;
+}
+
+static QByteArray qsg_shaderCacheKey(const char *vertexCode, const char *fragmentCode, char const *const *attributeNames)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const GLenum strings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for (uint i = 0; i < sizeof(strings) / sizeof(strings[0]); ++i) {
+        const char *s = (const char *) glGetString(strings[i]);
+        if (s)
+            hash.addData(s, qstrlen(s) + 1);
+    }
+    hash.addData(vertexCode, qstrlen(vertexCode) + 1);
+    hash.addData(fragmentCode, qstrlen(fragmentCode) + 1);
+    for (int i = 0; attributeNames && attributeNames[i]; ++i)
+        hash.addData(attributeNames[i], qstrlen(attributeNames[i]) + 1);
+    return hash.result().toHex();
+}
+
+/*
+    Links \a program from a cached binary of \a vertexCode and \a fragmentCode,
+    returning false when there is none or the driver rejects it. Attribute
+    locations have to be bound according to \a attributeNames beforehand.
+ */
+bool QSGShaderCache::load(QOpenGLShaderProgram *program,
+                          const char *vertexCode,
+                          const char *fragmentCode,
+                          char const *const *attributeNames)
+{
+    QSGShaderCacheData *cache = qsg_shader_cache();
+    if (!cache || !cache->enabled)
+        return false;
+
+    QSGProgramBinaryFunctions *functions = qsg_programBinaryFunctions();
+    if (!functions)
+        return false;
+
+    const QByteArray key = qsg_shaderCacheKey(vertexCode, fragmentCode, attributeNames);
+    QFile file(cache->path + QLatin1String(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        cache->misses.ref();
+        cache->report("miss", key);
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 format = 0;
+    QByteArray binary;
+    stream >> magic >> version >> format >> binary;
+    file.close();
+
+    GLint linked = 0;
+    if (stream.status() == QDataStream::Ok && magic == qsg_shader_cache_magic
+            && version == qsg_shader_cache_version && !binary.isEmpty()) {
+        const GLuint id = program->programId();
+        functions->programBinary(id, format, binary.constData(), binary.size());
+        QOpenGLContext::currentContext()->functions()->glGetProgramiv(id, GL_LINK_STATUS, &linked);
+    }
+
+    if (!linked) {
+        file.remove();
+        cache->misses.ref();
+        cache->rejected.ref();
+        cache->report("rejected", key);
+        return false;
+    }
+
+    // With no shaders attached, link() only picks up the status of the
+    // program we just populated from the binary.
+    program->link();
+    cache->hits.ref();
+    cache->report("hit", key);
+    return program->isLinked();
+}
+
+/*
+    Asks the driver to keep the binary of \a program retrievable, for
+    store() to be able to read it after linking.
+ */
+void QSGShaderCache::prepare(QOpenGLShaderProgram *program)
+{
+    QSGShaderCacheData *cache = qsg_shader_cache();
+    if (!cache || !cache->enabled)
+        return;
+
+    QSGProgramBinaryFunctions *functions = qsg_programBinaryFunctions();
+    if (functions && functions->programParameteri)
+        functions->programParameteri(program->programId(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+/*
+    Writes the binary of the linked \a program to the cache.
+ */
+void QSGShaderCache::store(QOpenGLShaderProgram *program,
+                           const char *vertexCode,
+                           const char *fragmentCode,
+                           char const *const *attributeNames)
+{
+    QSGShaderCacheData *cache = qsg_shader_cache();
+    if (!cache || !cache->enabled || !program->isLinked())
+        return;
+
+    QSGProgramBinaryFunctions *functions = qsg_programBinaryFunctions();
+    if (!functions)
+        return;
+
+    const GLuint id = program->programId();
+    GLint length = 0;
+    QOpenGLContext::currentContext()->functions()->glGetProgramiv(id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    QByteArray binary(length, Qt::Uninitialized);
+    GLsizei written = 0;
+    GLenum format = 0;
+    functions->getProgramBinary(id, length, &written, &format, binary.data());
+    if (written <= 0)
+        return;
+    binary.resize(written);
+
+    const QByteArray key = qsg_shaderCacheKey(vertexCode, fragmentCode, attributeNames);
+    QSaveFile file(cache->path + QLatin1String(key));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream << qsg_shader_cache_magic << qsg_shader_cache_version << quint32(format) << binary;
+    if (file.commit())
+        cache->report("stored", key);
+}
+
+/*
+    Re-reads QT_DISABLE_SHADER_DISK_CACHE, moves the cache below \a directory
+    and resets the statistics. Meant for autotests, and only safe while
+    nothing is rendering.
+ */
+void QSGShaderCache::configure(const QString &directory)
+{
+    if (QSGShaderCacheData *cache = qsg_shader_cache())
+        cache->configure(directory);
+}
+
+QString QSGShaderCache::directory()
+{
+    QSGShaderCacheData *cache = qsg_shader_cache();
+    return cache && cache->enabled ? cache->path : QString();
+}
+
+int QSGShaderCache::hits()
+{
+    QSGShaderCacheData *cache = qsg_shader_cache();
+    return cache ? cache->hits.load() : 0;
+}
+
+int QSGShaderCache::misses()
+{
+    QSGShaderCacheData *cache = qsg_shader_cache();
+    return cache ? cache->misses.load() : 0;
+}
+
+int QSGShaderCache::rejected()
+{
+    QSGShaderCacheData *cache = qsg_shader_cache();
+    return cache ? cache->rejected.load() : 0;
+}
+
+QT_END_NAMESPACE
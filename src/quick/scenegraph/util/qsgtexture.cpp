@@ -560,6 +560,48 @@ void qsg_swizzleBGRAToRGBA(QImage *image)
     }
 }
 
+/*
+    Picks the GL formats images are uploaded with. When the external format
+    ends up as GL_RGBA, the image data has to be swizzled from BGRA first.
+ */
+void qsg_textureFormats(GLenum *internalFormat, GLenum *externalFormat)
+{
+    *externalFormat = GL_RGBA;
+    *internalFormat = GL_RGBA;
+
+#if defined(Q_OS_ANDROID) && !defined(Q_OS_ANDROID_NO_SDK)
+    QString *deviceName =
+            static_cast<QString *>(QGuiApplication::platformNativeInterface()->nativeResourceForIntegration("AndroidDeviceName"));
+    static bool wrongfullyReportsBgra8888Support = deviceName != 0
+                                                    && (deviceName->compare(QStringLiteral("samsung SM-T211"), Qt::CaseInsensitive) == 0
+                                                        || deviceName->compare(QStringLiteral("samsung SM-T210"), Qt::CaseInsensitive) == 0
+                                                        || deviceName->compare(QStringLiteral("samsung SM-T215"), Qt::CaseInsensitive) == 0);
+#else
+    static bool wrongfullyReportsBgra8888Support = false;
+#endif
+
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (context->hasExtension(QByteArrayLiteral("GL_EXT_bgra"))) {
+        *externalFormat = GL_BGRA;
+#ifdef QT_OPENGL_ES
+        *internalFormat = GL_BGRA;
+#else
+        if (context->isOpenGLES())
+            *internalFormat = GL_BGRA;
+#endif // QT_OPENGL_ES
+    } else if (!wrongfullyReportsBgra8888Support
+               && (context->hasExtension(QByteArrayLiteral("GL_EXT_texture_format_BGRA8888"))
+                   || context->hasExtension(QByteArrayLiteral("GL_IMG_texture_format_BGRA8888")))) {
+        *externalFormat = GL_BGRA;
+        *internalFormat = GL_BGRA;
+#ifdef Q_OS_IOS
+    } else if (context->hasExtension(QByteArrayLiteral("GL_APPLE_texture_format_BGRA8888"))) {
+        *externalFormat = GL_BGRA;
+        *internalFormat = GL_RGBA;
+#endif
+    }
+}
+
 void QSGPlainTexture::setImage(const QImage &image)
 {
     m_image = image;
@@ -669,42 +711,13 @@ void QSGPlainTexture::bind()
 
     updateBindOptions(m_dirty_bind_options);
 
-    GLenum externalFormat = GL_RGBA;
-    GLenum internalFormat = GL_RGBA;
-
-#if defined(Q_OS_ANDROID) && !defined(Q_OS_ANDROID_NO_SDK)
-    QString *deviceName =
-            static_cast<QString *>(QGuiApplication::platformNativeInterface()->nativeResourceForIntegration("AndroidDeviceName"));
-    static bool wrongfullyReportsBgra8888Support = deviceName != 0
-                                                    && (deviceName->compare(QStringLiteral("samsung SM-T211"), Qt::CaseInsensitive) == 0
-                                                        || deviceName->compare(QStringLiteral("samsung SM-T210"), Qt::CaseInsensitive) == 0
-                                                        || deviceName->compare(QStringLiteral("samsung SM-T215"), Qt::CaseInsensitive) == 0);
-#else
-    static bool wrongfullyReportsBgra8888Support = false;
-#endif
+    GLenum externalFormat;
+    GLenum internalFormat;
+    qsg_textureFormats(&internalFormat, &externalFormat);
+    if (externalFormat == GL_RGBA)
+        qsg_swizzleBGRAToRGBA(&tmp);
 
     QOpenGLContext *context = QOpenGLContext::currentContext();
-    if (context->hasExtension(QByteArrayLiteral("GL_EXT_bgra"))) {
-        externalFormat = GL_BGRA;
-#ifdef QT_OPENGL_ES
-        internalFormat = GL_BGRA;
-#else
-        if (context->isOpenGLES())
-            internalFormat = GL_BGRA;
-#endif // QT_OPENGL_ES
-    } else if (!wrongfullyReportsBgra8888Support
-               && (context->hasExtension(QByteArrayLiteral("GL_EXT_texture_format_BGRA8888"))
-                   || context->hasExtension(QByteArrayLiteral("GL_IMG_texture_format_BGRA8888")))) {
-        externalFormat = GL_BGRA;
-        internalFormat = GL_BGRA;
-#ifdef Q_OS_IOS
-    } else if (context->hasExtension(QByteArrayLiteral("GL_APPLE_texture_format_BGRA8888"))) {
-        externalFormat = GL_BGRA;
-        internalFormat = GL_RGBA;
-#endif
-    } else {
-        qsg_swizzleBGRAToRGBA(&tmp);
-    }
 
 #ifndef QSG_NO_RENDER_TIMING
     qint64 swizzleTime = 0;
@@ -570,4 +570,104 @@ QQuickAnimatorJob *QQuickUniformAnimator::createJob() const
     return job;
 }
 
+/*!
+    \qmltype PropertyAnimator
+    \instantiates QQuickPropertyAnimator
+    \inqmlmodule QtQuick
+    \since 5.4
+    \ingroup qtquick-transitions-animations
+    \brief The PropertyAnimator type animates a numeric property of an Item.
+
+    \l{Animator} types are different from normal Animation types. When
+    using an Animator, the animation can be run in the render thread
+    and the property value will jump to the end when the animation is
+    complete.
+
+    The \c width and \c height of a \l Rectangle, as well as its \c radius,
+    are animated directly on the item's scene graph nodes. When the item
+    clips to its bounding rectangle, the clip follows the animated size.
+    Any other real-valued property is supported, but the item only
+    changes visually when the animation completes.
+
+    The value of the QML property is updated after the animation has
+    finished. Children, anchors and bindings that depend on the property
+    will only see the final value.
+
+    \qml
+    Rectangle {
+        id: panel
+        width: 100
+        height: 100
+        color: "steelblue"
+
+        PropertyAnimator {
+            target: panel
+            property: "width"
+            from: 100
+            to: 300
+            duration: 500
+            running: true
+        }
+    }
+    \endqml
+
+    It is also possible to use the \c on keyword to tie the
+    PropertyAnimator directly to a property of an Item instance.
+
+    \qml
+    Rectangle {
+        width: 100
+        height: 100
+        PropertyAnimator on radius { from: 0; to: 50; duration: 500 }
+    }
+    \endqml
+
+    \sa UniformAnimator, NumberAnimation
+ */
+
+QQuickPropertyAnimator::QQuickPropertyAnimator(QObject *parent)
+    : QQuickAnimator(*new QQuickPropertyAnimatorPrivate, parent)
+{
+}
+
+/*!
+   \qmlproperty string QtQuick::PropertyAnimator::property
+   This property holds the name of the property to animate.
+
+   The property must be a real-valued property of the target item.
+ */
+void QQuickPropertyAnimator::setProperty(const QString &property)
+{
+    Q_D(QQuickPropertyAnimator);
+    if (d->property == property)
+        return;
+    d->property = property;
+    Q_EMIT propertyChanged(d->property);
+}
+
+QString QQuickPropertyAnimator::property() const
+{
+    Q_D(const QQuickPropertyAnimator);
+    return d->property;
+}
+
+QString QQuickPropertyAnimator::propertyName() const
+{
+    Q_D(const QQuickPropertyAnimator);
+    if (!d->property.isEmpty())
+        return d->property;
+    return d->defaultProperty.name();
+}
+
+QQuickAnimatorJob *QQuickPropertyAnimator::createJob() const
+{
+    QString p = propertyName();
+    if (p.isEmpty())
+        return 0;
+
+    QQuickPropertyAnimatorJob *job = new QQuickPropertyAnimatorJob();
+    job->setProperty(p.toLatin1());
+    return job;
+}
+
 QT_END_NAMESPACE
@@ -183,6 +183,27 @@ protected:
     QString propertyName() const;
 };
 
+class QQuickPropertyAnimatorPrivate;
+class Q_QUICK_PRIVATE_EXPORT QQuickPropertyAnimator : public QQuickAnimator
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QQuickPropertyAnimator)
+    Q_PROPERTY(QString property READ property WRITE setProperty NOTIFY propertyChanged)
+
+public:
+    QQuickPropertyAnimator(QObject *parent = 0);
+
+    QString property() const;
+    void setProperty(const QString &);
+
+Q_SIGNALS:
+    void propertyChanged(const QString &);
+
+protected:
+    QQuickAnimatorJob *createJob() const;
+    QString propertyName() const;
+};
+
 QT_END_NAMESPACE
 
 QML_DECLARE_TYPE(QQuickAnimator)
@@ -192,5 +213,6 @@ QML_DECLARE_TYPE(QQuickScaleAnimator)
 QML_DECLARE_TYPE(QQuickRotationAnimator)
 QML_DECLARE_TYPE(QQuickOpacityAnimator)
 QML_DECLARE_TYPE(QQuickUniformAnimator)
+QML_DECLARE_TYPE(QQuickPropertyAnimator)
 
 #endif // QQUICKANIMATOR_P_H
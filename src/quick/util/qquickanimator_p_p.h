@@ -92,6 +92,12 @@ public:
     QString uniform;
 };
 
+class QQuickPropertyAnimatorPrivate : public QQuickAnimatorPrivate
+{
+public:
+    QString property;
+};
+
 QT_END_NAMESPACE
 
 #endif // QQUICKANIMATOR_P_P_H
@@ -46,6 +46,9 @@
 #include <private/qquickwindow_p.h>
 #include <private/qquickitem_p.h>
 #include <private/qquickshadereffectnode_p.h>
+#include <private/qquickrectangle_p.h>
+#include <private/qquickclipnode_p.h>
+#include <private/qsgadaptationlayer_p.h>
 
 #include <private/qanimationgroupjob_p.h>
 
@@ -571,4 +574,111 @@ void QQuickUniformAnimatorJob::writeBack()
         m_target->setProperty(m_uniform, value());
 }
 
+/*
+    Only the width, height and radius of a QQuickRectangle are written to
+    its rectangle node on the render thread. For any item, width and height
+    also move the default clip node. Everything else, including the content
+    of non-rectangle items, is only applied on the GUI thread by writeBack()
+    once the animation has finished.
+ */
+QQuickPropertyAnimatorJob::QQuickPropertyAnimatorJob()
+    : m_rectangleNode(0)
+    , m_clipNode(0)
+    , m_width(0)
+    , m_height(0)
+    , m_attribute(NoAttribute)
+{
+}
+
+void QQuickPropertyAnimatorJob::setTarget(QQuickItem *target)
+{
+    m_target = target;
+    m_rectangleNode = 0;
+    m_clipNode = 0;
+}
+
+void QQuickPropertyAnimatorJob::setProperty(const QByteArray &property)
+{
+    m_property = property;
+    if (property == "width")
+        m_attribute = WidthAttribute;
+    else if (property == "height")
+        m_attribute = HeightAttribute;
+    else if (property == "radius")
+        m_attribute = RadiusAttribute;
+    else
+        m_attribute = NoAttribute;
+}
+
+void QQuickPropertyAnimatorJob::nodeWasDestroyed()
+{
+    m_rectangleNode = 0;
+    m_clipNode = 0;
+}
+
+void QQuickPropertyAnimatorJob::afterNodeSync()
+{
+    m_rectangleNode = 0;
+    m_clipNode = 0;
+    if (m_attribute == NoAttribute)
+        return;
+
+    // The GUI thread is blocked while we are here, so reading the item is safe.
+    QQuickItemPrivate *d = QQuickItemPrivate::get(m_target);
+    m_width = m_target->width();
+    m_height = m_target->height();
+
+    if (qobject_cast<QQuickRectangle *>(m_target) != 0)
+        m_rectangleNode = static_cast<QSGRectangleNode *>(d->paintNode);
+    else if (m_attribute == RadiusAttribute)
+        return;
+
+    // Only follow the clip when it is the default one, custom clip rects
+    // are not derived from the item's size.
+    if (m_attribute != RadiusAttribute && d->clipNode()
+            && m_target->clipRect() == QRectF(0, 0, m_width, m_height)) {
+        m_clipNode = d->clipNode();
+    }
+
+    // The sync may have reset the nodes to the item's current values, so
+    // put the animated value back before the frame is rendered.
+    if (m_controller)
+        updateCurrentTime(currentLoopTime());
+}
+
+void QQuickPropertyAnimatorJob::updateCurrentTime(int time)
+{
+    if (!m_controller)
+        return;
+    Q_ASSERT(m_controller->m_window->openglContext()->thread() == QThread::currentThread());
+
+    m_value = m_from + (m_to - m_from) * m_easing.valueForProgress(time / (qreal) m_duration);
+
+    if (m_attribute == RadiusAttribute) {
+        if (m_rectangleNode) {
+            m_rectangleNode->setRadius(m_value);
+            m_rectangleNode->update();
+        }
+        return;
+    }
+
+    QRectF rect(0, 0,
+                m_attribute == WidthAttribute ? qMax<qreal>(0, m_value) : m_width,
+                m_attribute == HeightAttribute ? qMax<qreal>(0, m_value) : m_height);
+    if (m_rectangleNode) {
+        m_rectangleNode->setRect(rect);
+        m_rectangleNode->update();
+    }
+    if (m_clipNode) {
+        m_clipNode->setRect(rect);
+        m_clipNode->update();
+    }
+}
+
+void QQuickPropertyAnimatorJob::writeBack()
+{
+    if (m_target)
+        m_target->setProperty(m_property, value());
+}
+
 QT_END_NAMESPACE
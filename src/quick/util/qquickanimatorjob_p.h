@@ -60,8 +60,10 @@ class QQuickAbstractAnimation;
 class QQuickAnimatorController;
 class QQuickAnimatorProxyJobPrivate;
 class QQuickShaderEffectNode;
+class QQuickDefaultClipNode;
 
 class QSGOpacityNode;
+class QSGRectangleNode;
 
 class Q_QUICK_PRIVATE_EXPORT QQuickAnimatorProxyJob : public QObject, public QAbstractAnimationJob
 {
@@ -132,6 +134,7 @@ public:
     virtual void initialize(QQuickAnimatorController *controller);
     virtual void writeBack() = 0;
     virtual void nodeWasDestroyed() = 0;
+    virtual void afterNodeSync() { }
 
     bool isTransform() const { return m_isTransform; }
     bool isUniform() const { return m_isUniform; }
@@ -288,6 +291,40 @@ private:
     int m_uniformType : 8;
 };
 
+class Q_QUICK_PRIVATE_EXPORT QQuickPropertyAnimatorJob : public QQuickAnimatorJob
+{
+public:
+    enum Attribute {
+        NoAttribute,
+        WidthAttribute,
+        HeightAttribute,
+        RadiusAttribute
+    };
+
+    QQuickPropertyAnimatorJob();
+
+    void setTarget(QQuickItem *target);
+
+    void setProperty(const QByteArray &property);
+    QByteArray property() const { return m_property; }
+
+    void afterNodeSync();
+
+    void updateCurrentTime(int time);
+    void writeBack();
+    void nodeWasDestroyed();
+
+private:
+    QByteArray m_property;
+    QSGRectangleNode *m_rectangleNode;
+    QQuickDefaultClipNode *m_clipNode;
+
+    qreal m_width;
+    qreal m_height;
+
+    Attribute m_attribute;
+};
+
 QT_END_NAMESPACE
 
 #endif // QQUICKANIMATORJOB_P_H
@@ -56,10 +56,15 @@
 #include <QCoreApplication>
 #include <QImageReader>
 #include <QHash>
+#include <QSet>
 #include <QNetworkReply>
 #include <QPixmapCache>
 #include <QFile>
 #include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QElapsedTimer>
+#include <QBasicTimer>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QWaitCondition>
@@ -74,9 +79,11 @@
 #include <private/qquickprofiler_p.h>
 
 #define IMAGEREQUEST_MAX_REQUEST_COUNT       8
+#define IMAGEREQUEST_MAX_DECODE_THREADS      4
 #define IMAGEREQUEST_MAX_REDIRECT_RECURSION 16
 #define CACHE_EXPIRE_TIME 30
 #define CACHE_REMOVAL_FRACTION 4
+#define STATISTICS_UPDATE_INTERVAL 100
 
 QT_BEGIN_NAMESPACE
 
@@ -86,7 +93,16 @@ static bool qsg_leak_check = !qgetenv("QML_LEAK_CHECK").isEmpty();
 #endif
 
 // The cache limit describes the maximum "junk" in the cache.
-static int cache_limit = 2048 * 1024; // 2048 KB cache limit for embedded in qpixmapcache.cpp
+// 2048 KB cache limit for embedded in qpixmapcache.cpp, can be overridden
+// with QML_PIXMAP_CACHE_LIMIT (in KB) or QQuickPixmap::setCacheLimit()
+static int defaultCacheLimit()
+{
+    bool ok = false;
+    const int limit = qgetenv("QML_PIXMAP_CACHE_LIMIT").toInt(&ok);
+    if (ok && limit >= 0)
+        return limit * 1024;
+    return 2048 * 1024;
+}
 
 static inline QString imageProviderId(const QUrl &url)
 {
@@ -139,10 +155,13 @@ public:
 
     QQuickPixmapData *data;
     QQmlEngine *engineForReader; // always access reader inside readerMutex
+    QRect requestRegion;
     QSize requestSize;
     QUrl url;
+    QString localFile;
 
     bool loading;
+    bool visible; // always access inside the reader's mutex
     int redirectCount;
 
     class Event : public QEvent {
@@ -192,8 +211,9 @@ public:
     QQuickPixmapReader(QQmlEngine *eng);
     ~QQuickPixmapReader();
 
-    QQuickPixmapReply *getImage(QQuickPixmapData *);
+    QQuickPixmapReply *getImage(QQuickPixmapData *, bool visible);
     void cancel(QQuickPixmapReply *rep);
+    void setVisible(QQuickPixmapReply *rep, bool visible);
 
     static QQuickPixmapReader *instance(QQmlEngine *engine);
     static QQuickPixmapReader *existingInstance(QQmlEngine *engine);
@@ -203,12 +223,16 @@ protected:
 
 private:
     friend class QQuickPixmapReaderThreadObject;
+    friend class QQuickPixmapDecodeRunnable;
     void processJobs();
     void processJob(QQuickPixmapReply *, const QUrl &, const QSize &);
+    void decodeJob(QQuickPixmapReply *, const QUrl &, const QByteArray &);
     void networkRequestDone(QNetworkReply *);
+    QQuickPixmapReply *takeNextJob();
 
     QList<QQuickPixmapReply*> jobs;
     QList<QQuickPixmapReply*> cancelled;
+    QSet<QQuickPixmapReply*> decoding;
     QQmlEngine *engine;
     QObject *eventLoopQuitHack;
 
@@ -221,6 +245,8 @@ private:
 
     QHash<QNetworkReply*,QQuickPixmapReply*> replies;
 
+    QThreadPool decodePool;
+
     static int replyDownloadProgress;
     static int replyFinished;
     static int downloadProgress;
@@ -230,36 +256,56 @@ public:
     static QMutex readerMutex;
 };
 
+class QQuickPixmapDecodeRunnable : public QRunnable
+{
+public:
+    QQuickPixmapDecodeRunnable(QQuickPixmapReader *reader, QQuickPixmapReply *job,
+                               const QUrl &url, const QByteArray &data = QByteArray())
+        : reader(reader), job(job), url(url), data(data) {}
+
+    void run()
+    {
+        QThread::currentThread()->setPriority(QThread::LowestPriority);
+        reader->decodeJob(job, url, data);
+    }
+
+private:
+    QQuickPixmapReader *reader;
+    QQuickPixmapReply *job;
+    QUrl url;
+    QByteArray data;
+};
+
 class QQuickPixmapData
 {
 public:
-    QQuickPixmapData(QQuickPixmap *pixmap, const QUrl &u, const QSize &s, const QString &e)
+    QQuickPixmapData(QQuickPixmap *pixmap, const QUrl &u, const QRect &rr, const QSize &s, const QString &e)
     : refCount(1), inCache(false), pixmapStatus(QQuickPixmap::Error),
-      url(u), errorString(e), requestSize(s), textureFactory(0), reply(0), prevUnreferenced(0),
-      prevUnreferencedPtr(0), nextUnreferenced(0)
+      url(u), errorString(e), requestRegion(rr), requestSize(s), textureFactory(0), reply(0), frequency(0),
+      storeCost(0), prevUnreferenced(0), prevUnreferencedPtr(0), nextUnreferenced(0)
     {
         declarativePixmaps.insert(pixmap);
     }
 
-    QQuickPixmapData(QQuickPixmap *pixmap, const QUrl &u, const QSize &r)
+    QQuickPixmapData(QQuickPixmap *pixmap, const QUrl &u, const QRect &rr, const QSize &r)
     : refCount(1), inCache(false), pixmapStatus(QQuickPixmap::Loading),
-      url(u), requestSize(r), textureFactory(0), reply(0), prevUnreferenced(0), prevUnreferencedPtr(0),
-      nextUnreferenced(0)
+      url(u), requestRegion(rr), requestSize(r), textureFactory(0), reply(0), frequency(0), storeCost(0),
+      prevUnreferenced(0), prevUnreferencedPtr(0), nextUnreferenced(0)
     {
         declarativePixmaps.insert(pixmap);
     }
 
-    QQuickPixmapData(QQuickPixmap *pixmap, const QUrl &u, QQuickTextureFactory *texture, const QSize &s, const QSize &r)
+    QQuickPixmapData(QQuickPixmap *pixmap, const QUrl &u, QQuickTextureFactory *texture, const QSize &s, const QRect &rr, const QSize &r)
     : refCount(1), inCache(false), pixmapStatus(QQuickPixmap::Ready),
-      url(u), implicitSize(s), requestSize(r), textureFactory(texture), reply(0), prevUnreferenced(0),
-      prevUnreferencedPtr(0), nextUnreferenced(0)
+      url(u), implicitSize(s), requestRegion(rr), requestSize(r), textureFactory(texture), reply(0), frequency(0),
+      storeCost(0), prevUnreferenced(0), prevUnreferencedPtr(0), nextUnreferenced(0)
     {
         declarativePixmaps.insert(pixmap);
     }
 
     QQuickPixmapData(QQuickPixmap *pixmap, QQuickTextureFactory *texture)
     : refCount(1), inCache(false), pixmapStatus(QQuickPixmap::Ready),
-      textureFactory(texture), reply(0), prevUnreferenced(0),
+      textureFactory(texture), reply(0), frequency(0), storeCost(0), prevUnreferenced(0),
       prevUnreferencedPtr(0), nextUnreferenced(0)
     {
         if (texture)
@@ -282,6 +328,7 @@ public:
     void release();
     void addToCache();
     void removeFromCache();
+    void updateReaderPriority();
 
     uint refCount;
 
@@ -291,6 +338,7 @@ public:
     QUrl url;
     QString errorString;
     QSize implicitSize;
+    QRect requestRegion;
     QSize requestSize;
 
     QQuickTextureFactory *textureFactory;
@@ -298,6 +346,9 @@ public:
     QIntrusiveList<QQuickPixmap, &QQuickPixmap::dataListNode> declarativePixmaps;
     QQuickPixmapReply *reply;
 
+    uint frequency;     // cache hits, halved each time the pixmap escapes eviction
+    int storeCost;      // cost accounted by the store while unreferenced
+
     QQuickPixmapData *prevUnreferenced;
     QQuickPixmapData**prevUnreferencedPtr;
     QQuickPixmapData *nextUnreferenced;
@@ -338,12 +389,15 @@ QNetworkAccessManager *QQuickPixmapReader::networkAccessManager()
 }
 
 static bool readImage(const QUrl& url, QIODevice *dev, QImage *image, QString *errorString, QSize *impsize,
-                      const QSize &requestSize)
+                      const QRect &requestRegion, const QSize &requestSize)
 {
     QImageReader imgio(dev);
 
     const bool force_scale = imgio.format() == "svg" || imgio.format() == "svgz";
 
+    // Handlers supporting QImageIOHandler::ScaledSize (e.g. JPEG, using DCT
+    // scaling) decode directly at the reduced size, others decode and scale.
+    bool scaled = false;
     if (requestSize.width() > 0 || requestSize.height() > 0) {
         QSize s = imgio.size();
         qreal ratio = 0.0;
@@ -359,9 +413,19 @@ static bool readImage(const QUrl& url, QIODevice *dev, QImage *image, QString *e
             s.setHeight(qRound(s.height() * ratio));
             s.setWidth(qRound(s.width() * ratio));
             imgio.setScaledSize(s);
+            scaled = true;
         }
     }
 
+    // Only decode the requested part of the image, in the coordinates of the
+    // scaled image if a request size was given.
+    if (requestRegion.isValid()) {
+        if (scaled)
+            imgio.setScaledClipRect(requestRegion);
+        else
+            imgio.setClipRect(requestRegion);
+    }
+
     if (impsize)
         *impsize = imgio.size();
 
@@ -377,9 +441,19 @@ static bool readImage(const QUrl& url, QIODevice *dev, QImage *image, QString *e
     }
 }
 
+static int pixmapDecodeThreadCount()
+{
+    int count = qgetenv("QML_PIXMAP_DECODE_THREADS").toInt();
+    if (count <= 0)
+        count = qBound(1, QThread::idealThreadCount(), IMAGEREQUEST_MAX_DECODE_THREADS);
+    return count;
+}
+
 QQuickPixmapReader::QQuickPixmapReader(QQmlEngine *eng)
 : QThread(eng), engine(eng), threadObject(0), accessManager(0)
 {
+    decodePool.setMaxThreadCount(pixmapDecodeThreadCount());
+
     eventLoopQuitHack = new QObject;
     eventLoopQuitHack->moveToThread(this);
     connect(eventLoopQuitHack, SIGNAL(destroyed(QObject*)), SLOT(quit()), Qt::DirectConnection);
@@ -400,13 +474,19 @@ QQuickPixmapReader::~QQuickPixmapReader()
         delete reply;
     }
     jobs.clear();
-    QList<QQuickPixmapReply*> activeJobs = replies.values();
+    QList<QQuickPixmapReply*> activeJobs = replies.values() + decoding.toList();
     foreach (QQuickPixmapReply *reply, activeJobs) {
         if (reply->loading) {
             cancelled.append(reply);
             reply->data = 0;
         }
     }
+    mutex.unlock();
+
+    // decode workers report back through the thread object, so let them finish first
+    decodePool.waitForDone();
+
+    mutex.lock();
     if (threadObject) threadObject->processJobs();
     mutex.unlock();
 
@@ -438,24 +518,16 @@ void QQuickPixmapReader::networkRequestDone(QNetworkReply *reply)
             }
         }
 
-        QImage image;
-        QQuickPixmapReply::ReadError error = QQuickPixmapReply::NoError;
-        QString errorString;
-        QSize readSize;
+        mutex.lock();
         if (reply->error()) {
-            error = QQuickPixmapReply::Loading;
-            errorString = reply->errorString();
+            // send completion event to the QQuickPixmapReply
+            if (!cancelled.contains(job))
+                job->postReply(QQuickPixmapReply::Loading, reply->errorString(), QSize(), 0);
         } else {
-            QByteArray all = reply->readAll();
-            QBuffer buff(&all);
-            buff.open(QIODevice::ReadOnly);
-            if (!readImage(reply->url(), &buff, &image, &errorString, &readSize, job->requestSize))
-                error = QQuickPixmapReply::Decoding;
-       }
-        // send completion event to the QQuickPixmapReply
-        mutex.lock();
-        if (!cancelled.contains(job))
-            job->postReply(error, errorString, readSize, textureFactoryForImage(image));
+            // decoding happens on the worker pool, the reply is posted from there
+            decoding.insert(job);
+            decodePool.start(new QQuickPixmapDecodeRunnable(this, job, reply->url(), reply->readAll()));
+        }
         mutex.unlock();
     }
     reply->deleteLater();
@@ -490,18 +562,53 @@ void QQuickPixmapReaderThreadObject::networkRequestDone()
     reader->networkRequestDone(reply);
 }
 
+QQuickPixmapReply *QQuickPixmapReader::takeNextJob()
+{
+    // Must be called within mutex locking.
+    // Requests from visible items go first; among requests of the same
+    // priority the most recent one wins.
+    int next = -1;
+    for (int i = jobs.count() - 1; i >= 0; --i) {
+        QQuickPixmapReply *job = jobs.at(i);
+        if (next != -1 && (!job->visible || jobs.at(next)->visible))
+            continue;
+
+        if (!job->localFile.isEmpty()) {
+            if (decoding.count() >= decodePool.maxThreadCount())
+                continue;
+        } else if (job->url.scheme() != QLatin1String("image")) {
+            if (replies.count() >= IMAGEREQUEST_MAX_REQUEST_COUNT)
+                continue;
+        }
+
+        next = i;
+        if (job->visible)
+            break;
+    }
+
+    if (next == -1)
+        return 0;
+
+    QQuickPixmapReply *job = jobs.takeAt(next);
+    Q_QUICK_PROFILE(pixmapCountChanged<QQuickProfiler::PixmapReaderQueueChanged>(job->url, jobs.count()));
+    return job;
+}
+
 void QQuickPixmapReader::processJobs()
 {
     QMutexLocker locker(&mutex);
 
     while (true) {
-        if (cancelled.isEmpty() && (jobs.isEmpty() || replies.count() >= IMAGEREQUEST_MAX_REQUEST_COUNT))
-            return; // Nothing else to do
-
         // Clean cancelled jobs
         if (cancelled.count()) {
+            QList<QQuickPixmapReply*> stillDecoding;
             for (int i = 0; i < cancelled.count(); ++i) {
                 QQuickPixmapReply *job = cancelled.at(i);
+                if (decoding.contains(job)) {
+                    // cleaned up once the decode worker is done with it
+                    stillDecoding.append(job);
+                    continue;
+                }
                 QNetworkReply *reply = replies.key(job, 0);
                 if (reply && reply->isRunning()) {
                     // cancel any jobs already started
@@ -511,16 +618,23 @@ void QQuickPixmapReader::processJobs()
                 // deleteLater, since not owned by this thread
                 job->deleteLater();
             }
-            cancelled.clear();
+            cancelled = stillDecoding;
         }
 
-        if (!jobs.isEmpty() && replies.count() < IMAGEREQUEST_MAX_REQUEST_COUNT) {
-            QQuickPixmapReply *runningJob = jobs.takeLast();
-            runningJob->loading = true;
+        QQuickPixmapReply *runningJob = takeNextJob();
+        if (!runningJob)
+            return; // Nothing else to do
+
+        runningJob->loading = true;
 
-            QUrl url = runningJob->url;
-            Q_QUICK_PROFILE(pixmapStateChanged<QQuickProfiler::PixmapLoadingStarted>(url));
+        QUrl url = runningJob->url;
+        Q_QUICK_PROFILE(pixmapStateChanged<QQuickProfiler::PixmapLoadingStarted>(url));
 
+        if (!runningJob->localFile.isEmpty()) {
+            // Image is local - decode on the worker pool
+            decoding.insert(runningJob);
+            decodePool.start(new QQuickPixmapDecodeRunnable(this, runningJob, url));
+        } else {
             QSize requestSize = runningJob->requestSize;
             locker.unlock();
             processJob(runningJob, url, requestSize);
@@ -529,6 +643,54 @@ void QQuickPixmapReader::processJobs()
     }
 }
 
+void QQuickPixmapReader::decodeJob(QQuickPixmapReply *job, const QUrl &url, const QByteArray &data)
+{
+    // Runs on a thread of the decode pool. The job cannot be deleted while it
+    // is in the decoding set, but it may be cancelled at any time.
+    mutex.lock();
+    const bool wasCancelled = cancelled.contains(job);
+    mutex.unlock();
+
+    QImage image;
+    QQuickPixmapReply::ReadError errorCode = QQuickPixmapReply::NoError;
+    QString errorStr;
+    QSize readSize;
+
+    if (!wasCancelled) {
+        QElapsedTimer decodeTimer;
+        decodeTimer.start();
+        if (data.isNull()) {
+            QFile f(job->localFile);
+            if (f.open(QIODevice::ReadOnly)) {
+                if (!readImage(url, &f, &image, &errorStr, &readSize, job->requestRegion, job->requestSize))
+                    errorCode = QQuickPixmapReply::Loading;
+            } else {
+                errorStr = QQuickPixmap::tr("Cannot open: %1").arg(url.toString());
+                errorCode = QQuickPixmapReply::Loading;
+            }
+        } else {
+            QByteArray all = data;
+            QBuffer buff(&all);
+            buff.open(QIODevice::ReadOnly);
+            if (!readImage(url, &buff, &image, &errorStr, &readSize, job->requestRegion, job->requestSize))
+                errorCode = QQuickPixmapReply::Decoding;
+        }
+        Q_QUICK_PROFILE(pixmapDecodingFinished(url, decodeTimer.nsecsElapsed()));
+    }
+
+    QQuickTextureFactory *factory = textureFactoryForImage(image);
+
+    mutex.lock();
+    decoding.remove(job);
+    if (!cancelled.contains(job))
+        job->postReply(errorCode, errorStr, readSize, factory);
+    else
+        delete factory;
+    // a worker is free again, and the job may be waiting for clean up
+    if (threadObject) threadObject->processJobs();
+    mutex.unlock();
+}
+
 void QQuickPixmapReader::processJob(QQuickPixmapReply *runningJob, const QUrl &url,
                                           const QSize &requestSize)
 {
@@ -592,36 +754,15 @@ void QQuickPixmapReader::processJob(QQuickPixmapReply *runningJob, const QUrl &u
         }
 
     } else {
-        QString lf = QQmlFile::urlToLocalFileOrQrc(url);
-        if (!lf.isEmpty()) {
-            // Image is local - load/decode immediately
-            QImage image;
-            QQuickPixmapReply::ReadError errorCode = QQuickPixmapReply::NoError;
-            QString errorStr;
-            QFile f(lf);
-            QSize readSize;
-            if (f.open(QIODevice::ReadOnly)) {
-                if (!readImage(url, &f, &image, &errorStr, &readSize, requestSize))
-                    errorCode = QQuickPixmapReply::Loading;
-            } else {
-                errorStr = QQuickPixmap::tr("Cannot open: %1").arg(url.toString());
-                errorCode = QQuickPixmapReply::Loading;
-            }
-            mutex.lock();
-            if (!cancelled.contains(runningJob))
-                runningJob->postReply(errorCode, errorStr, readSize, textureFactoryForImage(image));
-            mutex.unlock();
-        } else {
-            // Network resource
-            QNetworkRequest req(url);
-            req.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
-            QNetworkReply *reply = networkAccessManager()->get(req);
+        // Network resource; local files are decoded on the worker pool
+        QNetworkRequest req(url);
+        req.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
+        QNetworkReply *reply = networkAccessManager()->get(req);
 
-            QMetaObject::connect(reply, replyDownloadProgress, runningJob, downloadProgress);
-            QMetaObject::connect(reply, replyFinished, threadObject, threadNetworkRequestDone);
+        QMetaObject::connect(reply, replyDownloadProgress, runningJob, downloadProgress);
+        QMetaObject::connect(reply, replyFinished, threadObject, threadNetworkRequestDone);
 
-            replies.insert(reply, runningJob);
-        }
+        replies.insert(reply, runningJob);
     }
 }
 
@@ -643,12 +784,16 @@ QQuickPixmapReader *QQuickPixmapReader::existingInstance(QQmlEngine *engine)
     return readers.value(engine, 0);
 }
 
-QQuickPixmapReply *QQuickPixmapReader::getImage(QQuickPixmapData *data)
+QQuickPixmapReply *QQuickPixmapReader::getImage(QQuickPixmapData *data, bool visible)
 {
     mutex.lock();
     QQuickPixmapReply *reply = new QQuickPixmapReply(data);
     reply->engineForReader = engine;
+    // Set the priority before the job is queued, so a worker can never pick
+    // it up with the default one.
+    reply->visible = visible;
     jobs.append(reply);
+    Q_QUICK_PROFILE(pixmapCountChanged<QQuickProfiler::PixmapReaderQueueChanged>(reply->url, jobs.count()));
     // XXX
     if (threadObject) threadObject->processJobs();
     mutex.unlock();
@@ -670,6 +815,13 @@ void QQuickPixmapReader::cancel(QQuickPixmapReply *reply)
     mutex.unlock();
 }
 
+void QQuickPixmapReader::setVisible(QQuickPixmapReply *reply, bool visible)
+{
+    mutex.lock();
+    reply->visible = visible;
+    mutex.unlock();
+}
+
 void QQuickPixmapReader::run()
 {
     if (replyDownloadProgress == -1) {
@@ -695,17 +847,18 @@ class QQuickPixmapKey
 {
 public:
     const QUrl *url;
+    const QRect *region;
     const QSize *size;
 };
 
 inline bool operator==(const QQuickPixmapKey &lhs, const QQuickPixmapKey &rhs)
 {
-    return *lhs.size == *rhs.size && *lhs.url == *rhs.url;
+    return *lhs.region == *rhs.region && *lhs.size == *rhs.size && *lhs.url == *rhs.url;
 }
 
 inline uint qHash(const QQuickPixmapKey &key)
 {
-    return qHash(*key.url) ^ key.size->width() ^ key.size->height();
+    return qHash(*key.url) ^ (key.size->width()*7) ^ (key.size->height()*17) ^ (key.region->x()*23) ^ (key.region->y()*29);
 }
 
 class QSGContext;
@@ -722,6 +875,24 @@ public:
 
     void purgeCache();
 
+    void setCacheLimit(int limit);
+    int cacheLimit() const { return m_cacheLimit; }
+
+    void cacheHit(QQuickPixmapData *);
+    void cacheMiss();
+    QQuickPixmapCacheStatistics statistics() const;
+
+    int hits() const { return m_hits; }
+    int misses() const { return m_misses; }
+    int evictions() const { return m_evictions; }
+    int count() const { return m_cache.count(); }
+    int unreferencedCount() const { return m_unreferencedCount; }
+    qint64 unreferencedBytes() const { return m_unreferencedCost; }
+    qint64 notifiedBytes() const { return m_notifiedBytes; }
+
+Q_SIGNALS:
+    void statisticsChanged();
+
 protected:
     virtual void timerEvent(QTimerEvent *);
 
@@ -730,19 +901,36 @@ public:
 
 private:
     void shrinkCache(int remove);
+    void prependUnreferenced(QQuickPixmapData *);
+    void takeLastUnreferenced();
+    qint64 cachedBytes() const;
+    void scheduleStatisticsChanged();
 
     QQuickPixmapData *m_unreferencedPixmaps;
     QQuickPixmapData *m_lastUnreferencedPixmap;
 
     int m_unreferencedCost;
+    int m_unreferencedCount;
+    int m_cacheLimit;
     int m_timerId;
     bool m_destroying;
+
+    int m_hits;
+    int m_misses;
+    int m_evictions;
+
+    // statisticsChanged() is compressed, as it would otherwise be emitted
+    // for every single load. The total size is only computed then, too.
+    QBasicTimer m_statisticsTimer;
+    qint64 m_notifiedBytes;
 };
 Q_GLOBAL_STATIC(QQuickPixmapStore, pixmapStore);
 
 
 QQuickPixmapStore::QQuickPixmapStore()
-    : m_unreferencedPixmaps(0), m_lastUnreferencedPixmap(0), m_unreferencedCost(0), m_timerId(-1), m_destroying(false)
+    : m_unreferencedPixmaps(0), m_lastUnreferencedPixmap(0), m_unreferencedCost(0),
+      m_unreferencedCount(0), m_cacheLimit(defaultCacheLimit()), m_timerId(-1), m_destroying(false),
+      m_hits(0), m_misses(0), m_evictions(0), m_notifiedBytes(0)
 {
 }
 
@@ -785,7 +973,7 @@ QQuickPixmapStore::~QQuickPixmapStore()
 #endif
 }
 
-void QQuickPixmapStore::unreferencePixmap(QQuickPixmapData *data)
+void QQuickPixmapStore::prependUnreferenced(QQuickPixmapData *data)
 {
     Q_ASSERT(data->prevUnreferenced == 0);
     Q_ASSERT(data->prevUnreferencedPtr == 0);
@@ -793,8 +981,6 @@ void QQuickPixmapStore::unreferencePixmap(QQuickPixmapData *data)
 
     data->nextUnreferenced = m_unreferencedPixmaps;
     data->prevUnreferencedPtr = &m_unreferencedPixmaps;
-    if (!m_destroying) // the texture factories may have been cleaned up already.
-        m_unreferencedCost += data->cost();
 
     m_unreferencedPixmaps = data;
     if (m_unreferencedPixmaps->nextUnreferenced) {
@@ -804,11 +990,35 @@ void QQuickPixmapStore::unreferencePixmap(QQuickPixmapData *data)
 
     if (!m_lastUnreferencedPixmap)
         m_lastUnreferencedPixmap = data;
+    ++m_unreferencedCount;
+}
+
+void QQuickPixmapStore::takeLastUnreferenced()
+{
+    QQuickPixmapData *data = m_lastUnreferencedPixmap;
+    Q_ASSERT(data->nextUnreferenced == 0);
+
+    *data->prevUnreferencedPtr = 0;
+    m_lastUnreferencedPixmap = data->prevUnreferenced;
+    data->prevUnreferencedPtr = 0;
+    data->prevUnreferenced = 0;
+    --m_unreferencedCount;
+}
 
-    shrinkCache(-1); // Shrink the cache in case it has become larger than cache_limit
+void QQuickPixmapStore::unreferencePixmap(QQuickPixmapData *data)
+{
+    // the texture factories may have been cleaned up already when destroying.
+    data->storeCost = m_destroying ? 0 : data->cost();
+    m_unreferencedCost += data->storeCost;
+
+    prependUnreferenced(data);
+
+    shrinkCache(-1); // Shrink the cache in case it has become larger than the cache limit
 
     if (m_timerId == -1 && m_unreferencedPixmaps && !m_destroying)
         m_timerId = startTimer(CACHE_EXPIRE_TIME * 1000);
+
+    scheduleStatisticsChanged();
 }
 
 void QQuickPixmapStore::referencePixmap(QQuickPixmapData *data)
@@ -827,31 +1037,48 @@ void QQuickPixmapStore::referencePixmap(QQuickPixmapData *data)
     data->prevUnreferencedPtr = 0;
     data->prevUnreferenced = 0;
 
-    m_unreferencedCost -= data->cost();
+    m_unreferencedCost -= data->storeCost;
+    data->storeCost = 0;
+    --m_unreferencedCount;
 }
 
 void QQuickPixmapStore::shrinkCache(int remove)
 {
-    while ((remove > 0 || m_unreferencedCost > cache_limit) && m_lastUnreferencedPixmap) {
+    bool evicted = false;
+    while ((remove > 0 || m_unreferencedCost > m_cacheLimit) && m_lastUnreferencedPixmap) {
         QQuickPixmapData *data = m_lastUnreferencedPixmap;
-        Q_ASSERT(data->nextUnreferenced == 0);
+        takeLastUnreferenced();
 
-        *data->prevUnreferencedPtr = 0;
-        m_lastUnreferencedPixmap = data->prevUnreferenced;
-        data->prevUnreferencedPtr = 0;
-        data->prevUnreferenced = 0;
+        if (data->frequency > 0 && !m_destroying) {
+            // Least recently used, but frequently reused: give it another round.
+            data->frequency /= 2;
+            prependUnreferenced(data);
+            continue;
+        }
 
         if (!m_destroying) {
-            remove -= data->cost();
-            m_unreferencedCost -= data->cost();
+            remove -= data->storeCost;
+            m_unreferencedCost -= data->storeCost;
+            ++m_evictions;
+            evicted = true;
         }
         data->removeFromCache();
         delete data;
     }
+
+    if (evicted)
+        scheduleStatisticsChanged();
 }
 
-void QQuickPixmapStore::timerEvent(QTimerEvent *)
+void QQuickPixmapStore::timerEvent(QTimerEvent *event)
 {
+    if (event->timerId() == m_statisticsTimer.timerId()) {
+        m_statisticsTimer.stop();
+        m_notifiedBytes = cachedBytes();
+        emit statisticsChanged();
+        return;
+    }
+
     int removalCost = m_unreferencedCost / CACHE_REMOVAL_FRACTION;
 
     shrinkCache(removalCost);
@@ -867,13 +1094,80 @@ void QQuickPixmapStore::purgeCache()
     shrinkCache(m_unreferencedCost);
 }
 
+void QQuickPixmapStore::setCacheLimit(int limit)
+{
+    m_cacheLimit = qMax(0, limit);
+    shrinkCache(-1);
+}
+
+void QQuickPixmapStore::cacheHit(QQuickPixmapData *data)
+{
+    ++m_hits;
+    ++data->frequency;
+    scheduleStatisticsChanged();
+}
+
+void QQuickPixmapStore::cacheMiss()
+{
+    ++m_misses;
+    scheduleStatisticsChanged();
+}
+
+void QQuickPixmapStore::scheduleStatisticsChanged()
+{
+    if (!m_destroying && !m_statisticsTimer.isActive())
+        m_statisticsTimer.start(STATISTICS_UPDATE_INTERVAL, this);
+}
+
+qint64 QQuickPixmapStore::cachedBytes() const
+{
+    // The cost of a pixmap changes as its texture is uploaded to or released
+    // from render contexts, so it cannot be kept as a running total.
+    qint64 bytes = 0;
+    for (QHash<QQuickPixmapKey, QQuickPixmapData *>::const_iterator it = m_cache.constBegin();
+         it != m_cache.constEnd(); ++it)
+        bytes += it.value()->cost();
+    return bytes;
+}
+
+QQuickPixmapCacheStatistics QQuickPixmapStore::statistics() const
+{
+    QQuickPixmapCacheStatistics stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.count = m_cache.count();
+    stats.bytes = cachedBytes();
+    stats.unreferencedCount = m_unreferencedCount;
+    stats.unreferencedBytes = m_unreferencedCost;
+    stats.cacheLimit = m_cacheLimit;
+    return stats;
+}
+
 void QQuickPixmap::purgeCache()
 {
     pixmapStore()->purgeCache();
 }
 
+void QQuickPixmap::setCacheLimit(int bytes)
+{
+    pixmapStore()->setCacheLimit(bytes);
+}
+
+int QQuickPixmap::cacheLimit()
+{
+    return pixmapStore()->cacheLimit();
+}
+
+QQuickPixmapCacheStatistics QQuickPixmap::cacheStatistics()
+{
+    return pixmapStore()->statistics();
+}
+
 QQuickPixmapReply::QQuickPixmapReply(QQuickPixmapData *d)
-: data(d), engineForReader(0), requestSize(d->requestSize), url(d->url), loading(false), redirectCount(0)
+: data(d), engineForReader(0), requestRegion(d->requestRegion), requestSize(d->requestSize), url(d->url),
+  localFile(url.scheme() == QLatin1String("image") ? QString() : QQmlFile::urlToLocalFileOrQrc(url)),
+  loading(false), visible(true), redirectCount(0)
 {
     if (finishedIndex == -1) {
         finishedIndex = QMetaMethod::fromSignal(&QQuickPixmapReply::finished).methodIndex();
@@ -918,9 +1212,15 @@ bool QQuickPixmapReply::event(QEvent *event)
 
 int QQuickPixmapData::cost() const
 {
-    if (textureFactory)
-        return textureFactory->textureByteCount();
-    return 0;
+    if (!textureFactory)
+        return 0;
+
+    // Every render context that uploaded the factory holds a texture of its own.
+    const int bytes = textureFactory->textureByteCount();
+    const int uploads = QSGRenderContext::textureFactoryUseCount(textureFactory);
+    if (qobject_cast<QQuickDefaultTextureFactory *>(textureFactory))
+        return bytes * (1 + uploads); // the image is kept in system memory as well
+    return bytes * qMax(1, uploads);
 }
 
 void QQuickPixmapData::addref()
@@ -963,7 +1263,7 @@ void QQuickPixmapData::release()
 void QQuickPixmapData::addToCache()
 {
     if (!inCache) {
-        QQuickPixmapKey key = { &url, &requestSize };
+        QQuickPixmapKey key = { &url, &requestRegion, &requestSize };
         pixmapStore()->m_cache.insert(key, this);
         inCache = true;
         Q_QUICK_PROFILE(pixmapCountChanged<QQuickProfiler::PixmapCacheCountChanged>(
@@ -974,7 +1274,7 @@ void QQuickPixmapData::addToCache()
 void QQuickPixmapData::removeFromCache()
 {
     if (inCache) {
-        QQuickPixmapKey key = { &url, &requestSize };
+        QQuickPixmapKey key = { &url, &requestRegion, &requestSize };
         Q_QUICK_PROFILE(pixmapCountChanged<QQuickProfiler::PixmapCacheCountChanged>(
                 url, pixmapStore()->m_cache.count()));
         pixmapStore()->m_cache.remove(key);
@@ -982,7 +1282,24 @@ void QQuickPixmapData::removeFromCache()
     }
 }
 
-static QQuickPixmapData* createPixmapDataSync(QQuickPixmap *declarativePixmap, QQmlEngine *engine, const QUrl &url, const QSize &requestSize, bool *ok)
+void QQuickPixmapData::updateReaderPriority()
+{
+    if (!reply)
+        return;
+
+    bool visible = false;
+    for (QQuickPixmap *pixmap = declarativePixmaps.first(); pixmap && !visible;
+         pixmap = declarativePixmaps.next(pixmap))
+        visible = pixmap->visible;
+
+    QQuickPixmapReader::readerMutex.lock();
+    QQuickPixmapReader *reader = QQuickPixmapReader::existingInstance(reply->engineForReader);
+    if (reader)
+        reader->setVisible(reply, visible);
+    QQuickPixmapReader::readerMutex.unlock();
+}
+
+static QQuickPixmapData* createPixmapDataSync(QQuickPixmap *declarativePixmap, QQmlEngine *engine, const QUrl &url, const QRect &requestRegion, const QSize &requestSize, bool *ok)
 {
     if (url.scheme() == QLatin1String("image")) {
         QSize readSize;
@@ -994,14 +1311,14 @@ static QQuickPixmapData* createPixmapDataSync(QQuickPixmap *declarativePixmap, Q
 
         switch (imageType) {
             case QQuickImageProvider::Invalid:
-                return new QQuickPixmapData(declarativePixmap, url, requestSize,
+                return new QQuickPixmapData(declarativePixmap, url, requestRegion, requestSize,
                     QQuickPixmap::tr("Invalid image provider: %1").arg(url.toString()));
             case QQuickImageProvider::Texture:
             {
                 QQuickTextureFactory *texture = provider->requestTexture(imageId(url), &readSize, requestSize);
                 if (texture) {
                     *ok = true;
-                    return new QQuickPixmapData(declarativePixmap, url, texture, readSize, requestSize);
+                    return new QQuickPixmapData(declarativePixmap, url, texture, readSize, requestRegion, requestSize);
                 }
             }
 
@@ -1010,7 +1327,7 @@ static QQuickPixmapData* createPixmapDataSync(QQuickPixmap *declarativePixmap, Q
                 QImage image = provider->requestImage(imageId(url), &readSize, requestSize);
                 if (!image.isNull()) {
                     *ok = true;
-                    return new QQuickPixmapData(declarativePixmap, url, textureFactoryForImage(image), readSize, requestSize);
+                    return new QQuickPixmapData(declarativePixmap, url, textureFactoryForImage(image), readSize, requestRegion, requestSize);
                 }
             }
             case QQuickImageProvider::Pixmap:
@@ -1018,13 +1335,13 @@ static QQuickPixmapData* createPixmapDataSync(QQuickPixmap *declarativePixmap, Q
                 QPixmap pixmap = provider->requestPixmap(imageId(url), &readSize, requestSize);
                 if (!pixmap.isNull()) {
                     *ok = true;
-                    return new QQuickPixmapData(declarativePixmap, url, textureFactoryForImage(pixmap.toImage()), readSize, requestSize);
+                    return new QQuickPixmapData(declarativePixmap, url, textureFactoryForImage(pixmap.toImage()), readSize, requestRegion, requestSize);
                 }
             }
         }
 
         // provider has bad image type, or provider returned null image
-        return new QQuickPixmapData(declarativePixmap, url, requestSize,
+        return new QQuickPixmapData(declarativePixmap, url, requestRegion, requestSize,
             QQuickPixmap::tr("Failed to get image from provider: %1").arg(url.toString()));
     }
 
@@ -1039,38 +1356,39 @@ static QQuickPixmapData* createPixmapDataSync(QQuickPixmap *declarativePixmap, Q
     if (f.open(QIODevice::ReadOnly)) {
         QImage image;
 
-        if (readImage(url, &f, &image, &errorString, &readSize, requestSize)) {
+        if (readImage(url, &f, &image, &errorString, &readSize, requestRegion, requestSize)) {
             *ok = true;
-            return new QQuickPixmapData(declarativePixmap, url, textureFactoryForImage(image), readSize, requestSize);
+            return new QQuickPixmapData(declarativePixmap, url, textureFactoryForImage(image), readSize, requestRegion, requestSize);
         }
         errorString = QQuickPixmap::tr("Invalid image data: %1").arg(url.toString());
 
     } else {
         errorString = QQuickPixmap::tr("Cannot open: %1").arg(url.toString());
     }
-    return new QQuickPixmapData(declarativePixmap, url, requestSize, errorString);
+    return new QQuickPixmapData(declarativePixmap, url, requestRegion, requestSize, errorString);
 }
 
 
 struct QQuickPixmapNull {
     QUrl url;
+    QRect region;
     QSize size;
 };
 Q_GLOBAL_STATIC(QQuickPixmapNull, nullPixmap);
 
 QQuickPixmap::QQuickPixmap()
-: d(0)
+: d(0), visible(true)
 {
 }
 
 QQuickPixmap::QQuickPixmap(QQmlEngine *engine, const QUrl &url)
-: d(0)
+: d(0), visible(true)
 {
     load(engine, url);
 }
 
 QQuickPixmap::QQuickPixmap(QQmlEngine *engine, const QUrl &url, const QSize &size)
-: d(0)
+: d(0), visible(true)
 {
     load(engine, url, size);
 }
@@ -1136,6 +1454,14 @@ const QSize &QQuickPixmap::implicitSize() const
         return nullPixmap()->size;
 }
 
+const QRect &QQuickPixmap::requestRegion() const
+{
+    if (d)
+        return d->requestRegion;
+    else
+        return nullPixmap()->region;
+}
+
 const QSize &QQuickPixmap::requestSize() const
 {
     if (d)
@@ -1207,6 +1533,11 @@ void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QSize &size)
 }
 
 void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QSize &requestSize, QQuickPixmap::Options options)
+{
+    load(engine, url, QRect(), requestSize, options);
+}
+
+void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QRect &requestRegion, const QSize &requestSize, QQuickPixmap::Options options)
 {
     if (d) {
         d->declarativePixmaps.remove(this);
@@ -1214,15 +1545,20 @@ void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QSize &reques
         d = 0;
     }
 
-    QQuickPixmapKey key = { &url, &requestSize };
+    QQuickPixmapKey key = { &url, &requestRegion, &requestSize };
     QQuickPixmapStore *store = pixmapStore();
 
     QHash<QQuickPixmapKey, QQuickPixmapData *>::Iterator iter = store->m_cache.end();
 
     // If Cache is disabled, the pixmap will always be loaded, even if there is an existing
     // cached version.
-    if (options & QQuickPixmap::Cache)
+    if (options & QQuickPixmap::Cache) {
         iter = store->m_cache.find(key);
+        if (iter == store->m_cache.end())
+            store->cacheMiss();
+        else
+            store->cacheHit(*iter);
+    }
 
     if (iter == store->m_cache.end()) {
         if (url.scheme() == QLatin1String("image")) {
@@ -1240,7 +1576,7 @@ void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QSize &reques
         if (!(options & QQuickPixmap::Asynchronous)) {
             bool ok = false;
             Q_QUICK_PROFILE(pixmapStateChanged<QQuickProfiler::PixmapLoadingStarted>(url));
-            d = createPixmapDataSync(this, engine, url, requestSize, &ok);
+            d = createPixmapDataSync(this, engine, url, requestRegion, requestSize, &ok);
             if (ok) {
                 Q_QUICK_PROFILE(pixmapLoadingFinished(url,
                         d->requestSize.width() > 0 ? d->requestSize : d->implicitSize));
@@ -1257,20 +1593,32 @@ void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QSize &reques
         if (!engine)
             return;
 
-        d = new QQuickPixmapData(this, url, requestSize);
+        d = new QQuickPixmapData(this, url, requestRegion, requestSize);
         if (options & QQuickPixmap::Cache)
             d->addToCache();
 
         QQuickPixmapReader::readerMutex.lock();
-        d->reply = QQuickPixmapReader::instance(engine)->getImage(d);
+        d->reply = QQuickPixmapReader::instance(engine)->getImage(d, visible);
         QQuickPixmapReader::readerMutex.unlock();
     } else {
         d = *iter;
         d->addref();
         d->declarativePixmaps.insert(this);
+        if (visible)
+            d->updateReaderPriority();
     }
 }
 
+void QQuickPixmap::setVisible(bool v)
+{
+    if (visible == v)
+        return;
+
+    visible = v;
+    if (d)
+        d->updateReaderPriority();
+}
+
 void QQuickPixmap::clear()
 {
     if (d) {
@@ -1331,6 +1679,136 @@ bool QQuickPixmap::connectDownloadProgress(QObject *object, int method)
     return QMetaObject::connect(d->reply, QQuickPixmapReply::downloadProgressIndex, object, method);
 }
 
+/*!
+    \qmltype PixmapCache
+    \instantiates QQuickPixmapCacheInfo
+    \inqmlmodule QtQuick
+    \since 5.4
+    \brief Provides statistics and settings of the image cache.
+
+    PixmapCache is a singleton giving access to the process-wide cache of
+    images loaded by \l Image, \l BorderImage and other items that cache
+    their sources.
+
+    Images that are no longer used by any item are kept in the cache until
+    their combined size exceeds \l cacheLimit. The size of a cached image
+    includes the textures uploaded from it in every window it was shown in.
+    When the limit is exceeded, the least recently used images are evicted
+    first, but images that were reused often are given another chance.
+
+    \code
+    import QtQuick 2.4
+
+    Text {
+        text: "image cache hits: " + PixmapCache.hits + ", misses: " + PixmapCache.misses
+    }
+    \endcode
+
+    The default cache limit can be set with the \c QML_PIXMAP_CACHE_LIMIT
+    environment variable, in kilobytes.
+*/
+
+QQuickPixmapCacheInfo::QQuickPixmapCacheInfo(QObject *parent)
+    : QObject(parent)
+{
+    connect(pixmapStore(), SIGNAL(statisticsChanged()), this, SIGNAL(statisticsChanged()));
+}
+
+QObject *QQuickPixmapCacheInfo::create(QQmlEngine *, QJSEngine *)
+{
+    return new QQuickPixmapCacheInfo;
+}
+
+/*!
+    \qmlproperty int QtQuick::PixmapCache::cacheLimit
+
+    The number of bytes unused images may occupy before they are evicted
+    from the cache. The default is 2 MB.
+*/
+int QQuickPixmapCacheInfo::cacheLimit() const
+{
+    return pixmapStore()->cacheLimit();
+}
+
+void QQuickPixmapCacheInfo::setCacheLimit(int bytes)
+{
+    if (bytes == pixmapStore()->cacheLimit())
+        return;
+    pixmapStore()->setCacheLimit(bytes);
+    emit cacheLimitChanged();
+}
+
+/*!
+    \qmlproperty int QtQuick::PixmapCache::hits
+    \qmlproperty int QtQuick::PixmapCache::misses
+    \qmlproperty int QtQuick::PixmapCache::evictions
+
+    The number of image loads served from the cache, the number of loads
+    that had to read the image, and the number of unused images removed
+    from the cache to stay within \l cacheLimit.
+*/
+int QQuickPixmapCacheInfo::hits() const
+{
+    return pixmapStore()->hits();
+}
+
+int QQuickPixmapCacheInfo::misses() const
+{
+    return pixmapStore()->misses();
+}
+
+int QQuickPixmapCacheInfo::evictions() const
+{
+    return pixmapStore()->evictions();
+}
+
+/*!
+    \qmlproperty int QtQuick::PixmapCache::count
+    \qmlproperty int QtQuick::PixmapCache::unreferencedCount
+
+    The number of images in the cache, and the number of those that are
+    not used by any item.
+*/
+int QQuickPixmapCacheInfo::count() const
+{
+    return pixmapStore()->count();
+}
+
+int QQuickPixmapCacheInfo::unreferencedCount() const
+{
+    return pixmapStore()->unreferencedCount();
+}
+
+/*!
+    \qmlproperty real QtQuick::PixmapCache::bytes
+    \qmlproperty real QtQuick::PixmapCache::unreferencedBytes
+
+    The memory used by all images in the cache, and by the images that
+    are not used by any item.
+
+    \c bytes is only updated when the statistics change notification is
+    emitted, which happens at most every 100 milliseconds.
+*/
+qint64 QQuickPixmapCacheInfo::bytes() const
+{
+    return pixmapStore()->notifiedBytes();
+}
+
+qint64 QQuickPixmapCacheInfo::unreferencedBytes() const
+{
+    return pixmapStore()->unreferencedBytes();
+}
+
+/*!
+    \qmlmethod QtQuick::PixmapCache::purge()
+
+    Removes all images that are not used by any item from the cache.
+*/
+void QQuickPixmapCacheInfo::purge()
+{
+    pixmapStore()->purgeCache();
+}
+
 QT_END_NAMESPACE
 
 #include <qquickpixmapcache.moc>
@@ -54,9 +54,26 @@
 QT_BEGIN_NAMESPACE
 
 class QQmlEngine;
+class QJSEngine;
 class QQuickPixmapData;
 class QQuickTextureFactory;
 
+struct QQuickPixmapCacheStatistics
+{
+    QQuickPixmapCacheStatistics()
+        : hits(0), misses(0), evictions(0), count(0), unreferencedCount(0),
+          bytes(0), unreferencedBytes(0), cacheLimit(0) {}
+
+    int hits;
+    int misses;
+    int evictions;
+    int count;              // pixmaps in the cache, referenced or not
+    int unreferencedCount;  // pixmaps kept only by the cache
+    qint64 bytes;           // system and texture memory of all cached pixmaps
+    qint64 unreferencedBytes;
+    int cacheLimit;
+};
+
 class QQuickDefaultTextureFactory : public QQuickTextureFactory
 {
     Q_OBJECT
@@ -97,6 +114,7 @@ public:
     QString error() const;
     const QUrl &url() const;
     const QSize &implicitSize() const;
+    const QRect &requestRegion() const;
     const QSize &requestSize() const;
     QImage image() const;
     void setImage(const QImage &);
@@ -111,26 +129,69 @@ public:
     void load(QQmlEngine *, const QUrl &, QQuickPixmap::Options options);
     void load(QQmlEngine *, const QUrl &, const QSize &);
     void load(QQmlEngine *, const QUrl &, const QSize &, QQuickPixmap::Options options);
+    void load(QQmlEngine *, const QUrl &, const QRect &requestRegion, const QSize &requestSize, QQuickPixmap::Options options);
 
     void clear();
     void clear(QObject *);
 
+    // Hint for the reader: pending loads of visible pixmaps are served first.
+    void setVisible(bool);
+
     bool connectFinished(QObject *, const char *);
     bool connectFinished(QObject *, int);
     bool connectDownloadProgress(QObject *, const char *);
     bool connectDownloadProgress(QObject *, int);
 
     static void purgeCache();
+    static void setCacheLimit(int bytes);
+    static int cacheLimit();
+    static QQuickPixmapCacheStatistics cacheStatistics();
 
 private:
     Q_DISABLE_COPY(QQuickPixmap)
     QQuickPixmapData *d;
     QIntrusiveListNode dataListNode;
+    bool visible;
     friend class QQuickPixmapData;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(QQuickPixmap::Options)
 
+class Q_QUICK_PRIVATE_EXPORT QQuickPixmapCacheInfo : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int cacheLimit READ cacheLimit WRITE setCacheLimit NOTIFY cacheLimitChanged)
+    Q_PROPERTY(int hits READ hits NOTIFY statisticsChanged)
+    Q_PROPERTY(int misses READ misses NOTIFY statisticsChanged)
+    Q_PROPERTY(int evictions READ evictions NOTIFY statisticsChanged)
+    Q_PROPERTY(int count READ count NOTIFY statisticsChanged)
+    Q_PROPERTY(int unreferencedCount READ unreferencedCount NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 bytes READ bytes NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 unreferencedBytes READ unreferencedBytes NOTIFY statisticsChanged)
+
+public:
+    QQuickPixmapCacheInfo(QObject *parent = 0);
+
+    int cacheLimit() const;
+    void setCacheLimit(int bytes);
+
+    int hits() const;
+    int misses() const;
+    int evictions() const;
+    int count() const;
+    int unreferencedCount() const;
+    qint64 bytes() const;
+    qint64 unreferencedBytes() const;
+
+    Q_INVOKABLE void purge();
+
+    static QObject *create(QQmlEngine *, QJSEngine *);
+
+Q_SIGNALS:
+    void cacheLimitChanged();
+    void statisticsChanged();
+};
+
 QT_END_NAMESPACE
 
 #endif // QQUICKPIXMAPCACHE_H
@@ -80,6 +80,9 @@ void QQuickProfilerData::toByteArrays(QList<QByteArray> &messages) const
                     case QQuickProfiler::PixmapSizeKnown: ds << x << y; break;
                     case QQuickProfiler::PixmapReferenceCountChanged: ds << count; break;
                     case QQuickProfiler::PixmapCacheCountChanged: ds << count; break;
+                    case QQuickProfiler::PixmapReaderQueueChanged: ds << count; break;
+                    // PixmapDecodingFinished: decode time in microseconds
+                    case QQuickProfiler::PixmapDecodingFinished: ds << count; break;
                     default: break;
                 }
                 break;
@@ -200,6 +200,13 @@ public:
                 1 << PixmapCacheEvent, 1 << CountType, url, 0, 0, 0, count));
     }
 
+    static void pixmapDecodingFinished(const QUrl &url, qint64 decodeTime)
+    {
+        s_instance->processMessage(QQuickProfilerData(s_instance->timestamp(),
+                1 << PixmapCacheEvent, 1 << PixmapDecodingFinished, url, 0, 0, 0,
+                int(decodeTime / 1000)));
+    }
+
     static void registerAnimationCallback();
 
     qint64 timestamp() { return m_timer.nsecsElapsed(); }
@@ -54,6 +54,7 @@
 #include "qquicksystempalette_p.h"
 #include "qquicktransition_p.h"
 #include "qquickanimator_p.h"
+#include "qquickpixmapcache_p.h"
 #include <qqmlinfo.h>
 #include <private/qqmltypenotavailable_p.h>
 #include <private/qquickanimationcontroller_p.h>
@@ -99,6 +100,9 @@ void QQuickUtilModule::defineModule()
     qmlRegisterType<QQuickRotationAnimator>("QtQuick", 2, 2, "RotationAnimator");
     qmlRegisterType<QQuickOpacityAnimator>("QtQuick", 2, 2, "OpacityAnimator");
     qmlRegisterType<QQuickUniformAnimator>("QtQuick", 2, 2, "UniformAnimator");
+    qmlRegisterType<QQuickPropertyAnimator>("QtQuick", 2, 4, "PropertyAnimator");
+
+    qmlRegisterSingletonType<QQuickPixmapCacheInfo>("QtQuick", 2, 4, "PixmapCache", QQuickPixmapCacheInfo::create);
 
     qmlRegisterType<QQuickStateOperation>();
 
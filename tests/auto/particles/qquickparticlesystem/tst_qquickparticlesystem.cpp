@@ -55,8 +55,19 @@ public:
 private slots:
     void initTestCase();
     void test_basic();
+    void test_concurrentAffectors();
+    void test_dataWheel();
+    void test_indexSet();
 };
 
+static QList<QQuickParticleData*> expired(QQuickParticleDataWheel &wheel, int time)
+{
+    QList<QQuickParticleData*> list;
+    for (QQuickParticleData* d = wheel.takeExpired(time); d; d = d->recyclerNext)
+        list << d;
+    return list;
+}
+
 void tst_qquickparticlesystem::initTestCase()
 {
     QQmlDataTest::initTestCase();
@@ -92,6 +103,165 @@ void tst_qquickparticlesystem::test_basic()
     QVERIFY(extremelyFuzzyCompare(stillAlive, 500, 5));//Small simulation variance is permissible.
 }
 
+void tst_qquickparticlesystem::test_concurrentAffectors()
+{
+    QQuickView* view = createView(testFileUrl("affectors.qml"), 600);
+    QQuickParticleSystem* system = view->rootObject()->findChild<QQuickParticleSystem*>("system");
+    ensureAnimTime(600, system->m_animation);
+    system->pause();
+
+    QList<QQuickParticleData*> particles;
+    QList<QQuickParticleData*> initial;
+    foreach (QQuickParticleGroupData* gd, system->groupData) {
+        foreach (QQuickParticleData *d, gd->data) {
+            if (d->t == -1)
+                continue; //Particle data unused
+            particles << d;
+            initial << new QQuickParticleData(system);
+            initial.last()->clone(*d);
+        }
+    }
+    QVERIFY(particles.count() > 1000);
+
+    // Both affectors go to the pool, however few particles there are
+    system->concurrentAffectorThreshold = 0;
+    system->runAffectors(0.1);
+    QList<QQuickParticleData*> concurrent;
+    for (int i = 0; i < particles.count(); ++i) {
+        concurrent << new QQuickParticleData(system);
+        concurrent.last()->clone(*particles.at(i));
+        particles.at(i)->clone(*initial.at(i));
+    }
+
+    system->concurrentAffectorThreshold = INT_MAX;
+    system->runAffectors(0.1);
+    bool moved = false;
+    for (int i = 0; i < particles.count(); ++i) {
+        QQuickParticleData *d = particles.at(i);
+        QQuickParticleData *c = concurrent.at(i);
+        QCOMPARE(c->x, d->x);
+        QCOMPARE(c->y, d->y);
+        QCOMPARE(c->vx, d->vx);
+        QCOMPARE(c->vy, d->vy);
+        QCOMPARE(c->ax, d->ax);
+        QCOMPARE(c->ay, d->ay);
+        QCOMPARE(c->t, d->t);
+        moved = moved || d->vx != initial.at(i)->vx || d->ax != initial.at(i)->ax;
+    }
+    QVERIFY(moved);
+
+    qDeleteAll(initial);
+    qDeleteAll(concurrent);
+    delete view;
+}
+
+void tst_qquickparticlesystem::test_dataWheel()
+{
+    QQuickParticleDataWheel wheel;
+    QQuickParticleData a(0), b(0), c(0), d(0);
+    const int turn = QQuickParticleDataWheel::slotCount * QQuickParticleDataWheel::slotDuration;
+
+    //Deadlines more than one turn ahead stay put when the wheel passes their slot
+    wheel.insertTimed(&a, turn + 1000);
+    wheel.insertTimed(&b, 2 * turn + 1000);
+    for (int time = 0; time < turn + 1000; time += QQuickParticleDataWheel::slotDuration)
+        QVERIFY(expired(wheel, time).isEmpty());
+    QCOMPARE(expired(wheel, turn + 1000), QList<QQuickParticleData*>() << &a);
+    QVERIFY(!wheel.contains(&a));
+    QCOMPARE(a.recyclerSlot, -1);
+    QVERIFY(wheel.contains(&b));
+    QVERIFY(expired(wheel, 2 * turn).isEmpty());
+    QCOMPARE(expired(wheel, 2 * turn + 1000), QList<QQuickParticleData*>() << &b);
+
+    //Inserting again moves the particle, leaving nothing behind
+    wheel.insertTimed(&c, 2 * turn + 1100);
+    wheel.insertTimed(&c, 2 * turn + 1500);
+    wheel.insertTimed(&c, 2 * turn + 1500);
+    QVERIFY(expired(wheel, 2 * turn + 1200).isEmpty());
+    QCOMPARE(expired(wheel, 2 * turn + 1500), QList<QQuickParticleData*>() << &c);
+    QVERIFY(expired(wheel, 3 * turn + 2000).isEmpty());
+
+    wheel.insertTimed(&c, 3 * turn + 2100);
+    wheel.remove(&c);
+    QVERIFY(!wheel.contains(&c));
+    QVERIFY(expired(wheel, 3 * turn + 2200).isEmpty());
+
+    //Time going backwards, as after a restart
+    wheel.insertTimed(&a, 50);
+    wheel.insertTimed(&b, 5000);
+    QCOMPARE(expired(wheel, 60), QList<QQuickParticleData*>() << &a);
+    QVERIFY(expired(wheel, 4000).isEmpty());
+    QCOMPARE(expired(wheel, 5000), QList<QQuickParticleData*>() << &b);
+
+    //And after a reset
+    wheel.insertTimed(&a, 9000);
+    wheel.insertTimed(&d, 200);
+    wheel.clear();
+    QVERIFY(!wheel.contains(&a));
+    QVERIFY(!wheel.contains(&d));
+    QCOMPARE(d.recyclerSlot, -1);
+    wheel.insertTimed(&c, 300);
+    wheel.insertTimed(&d, 300);
+    QVERIFY(expired(wheel, 100).isEmpty());
+    QList<QQuickParticleData*> both = expired(wheel, 300);
+    QCOMPARE(both.count(), 2);
+    QVERIFY(both.contains(&c) && both.contains(&d));
+}
+
+void tst_qquickparticlesystem::test_indexSet()
+{
+    QQuickParticleIndexSet set;
+    QVERIFY(set.isEmpty());
+    QCOMPARE(set.takeFirst(), -1);
+
+    //Bits on either side of the word boundaries
+    const int indexes[] = { 127, 64, 63, 0, 32, 31 };
+    for (int i = 0; i < 6; i++)
+        set.insert(indexes[i]);
+    set.insert(64);
+    QCOMPARE(set.count(), 6);
+    for (int i = 0; i < 6; i++)
+        QVERIFY(set.contains(indexes[i]));
+    QVERIFY(!set.contains(30));
+    QVERIFY(!set.contains(33));
+    QVERIFY(!set.contains(62));
+    QVERIFY(!set.contains(65));
+    QVERIFY(!set.contains(126));
+    QVERIFY(!set.contains(128));
+    QVERIFY(!set.contains(1000));
+
+    set.remove(64);
+    set.remove(64);
+    set.remove(1000);
+    QCOMPARE(set.count(), 5);
+    QVERIFY(!set.contains(64));
+    QVERIFY(set.contains(63));
+
+    //Indexes are handed out lowest first
+    QCOMPARE(set.takeFirst(), 0);
+    QCOMPARE(set.takeFirst(), 31);
+    QCOMPARE(set.takeFirst(), 32);
+    QCOMPARE(set.takeFirst(), 63);
+    QVERIFY(!set.contains(63));
+
+    //Returning an index below the last one taken
+    set.insert(64);
+    set.insert(5);
+    QCOMPARE(set.takeFirst(), 5);
+    QCOMPARE(set.takeFirst(), 64);
+    QCOMPARE(set.takeFirst(), 127);
+    QCOMPARE(set.takeFirst(), -1);
+    QVERIFY(set.isEmpty());
+
+    set.insert(63);
+    set.insert(127);
+    set.clear();
+    QVERIFY(set.isEmpty());
+    QVERIFY(!set.contains(63));
+    set.insert(127);
+    QCOMPARE(set.takeFirst(), 127);
+}
+
 QTEST_MAIN(tst_qquickparticlesystem);
 
 #include "tst_qquickparticlesystem.moc"
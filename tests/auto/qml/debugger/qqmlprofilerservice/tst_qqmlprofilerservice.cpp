@@ -112,6 +112,8 @@ public:
         PixmapLoadingStarted,
         PixmapLoadingFinished,
         PixmapLoadingError,
+        PixmapReaderQueueChanged,
+        PixmapDecodingFinished,
 
         MaximumPixmapEventType
     };
@@ -273,6 +275,10 @@ void QQmlProfilerClient::messageReceived(const QByteArray &message)
             stream >> data.animationcount;
         if (data.detailType == QQmlProfilerClient::PixmapCacheCountChanged)
             stream >> data.animationcount;
+        if (data.detailType == QQmlProfilerClient::PixmapReaderQueueChanged)
+            stream >> data.animationcount;
+        if (data.detailType == QQmlProfilerClient::PixmapDecodingFinished)
+            stream >> data.animationcount;
         break;
     }
     case QQmlProfilerClient::SceneGraphFrame: {
@@ -135,6 +135,10 @@ private slots:
     void reentrancy_objectCreation();
     void jsIncDecNonObjectProperty();
     void JSONparse();
+    void JSONparseFastPaths_data();
+    void JSONparseFastPaths();
+    void JSONstringify_data();
+    void JSONstringify();
 
     void qRegExpInport_data();
     void qRegExpInport();
@@ -151,6 +155,7 @@ private slots:
 
     void regexpLastMatch();
     void indexedAccesses();
+    void typedArrays();
 
     void prototypeChainGc();
     void prototypeChainGc_QTBUG38299();
@@ -2729,6 +2734,139 @@ void tst_QJSEngine::JSONparse()
     QVERIFY(ret.isObject());
 }
 
+void tst_QJSEngine::JSONparseFastPaths_data()
+{
+    QTest::addColumn<QString>("json");
+    QTest::addColumn<QString>("expression");
+    QTest::addColumn<QString>("expected");
+
+    // Objects in an array are parsed with the keys of the previous one as a hint
+    QTest::newRow("keys in another order")
+            << "[{\"a\":1,\"b\":2},{\"b\":3,\"a\":4},{\"a\":5,\"c\":6}]"
+            << "v.map(function(o) { return Object.keys(o).map(function(k) { return k + o[k]; }).join(); }).join('|')"
+            << "a1,b2|b3,a4|a5,c6";
+    QTest::newRow("fewer and more keys")
+            << "[{\"a\":1,\"b\":2},{\"a\":3},{\"a\":4,\"b\":5,\"c\":6}]"
+            << "v.map(function(o) { return Object.keys(o).map(function(k) { return k + o[k]; }).join(); }).join('|')"
+            << "a1,b2|a3|a4,b5,c6";
+    QTest::newRow("key prefixes")
+            << "[{\"ab\":1},{\"a\":2},{\"abc\":3}]"
+            << "v.map(function(o) { return Object.keys(o).map(function(k) { return k + o[k]; }).join(); }).join('|')"
+            << "ab1|a2|abc3";
+    QTest::newRow("escaped keys")
+            << "[{\"a\\\"b\":1,\"c\":2},{\"a\\\"b\":3,\"c\\\\d\":4},{\"\\u0061\\\"b\":5}]"
+            << "v.map(function(o) { return Object.keys(o).map(function(k) { return k + o[k]; }).join(); }).join('|')"
+            << "a\"b1,c2|a\"b3,c\\d4|a\"b5";
+    QTest::newRow("index keys")
+            << "[{\"1\":1,\"x\":2},{\"1\":3,\"x\":4}]"
+            << "v[1][1] + ',' + v[1].x"
+            << "3,4";
+
+    // Strings are scanned in runs of eight characters
+    const QString pair = QString::fromUtf8("\xF0\x9F\x98\x80");
+    QTest::newRow("escaped surrogate pair")
+            << "\"\\uD83D\\uDE00\"" << "v" << pair;
+    QTest::newRow("surrogate pair")
+            << QString("\"" + pair + "\"") << "v" << pair;
+    QTest::newRow("surrogate pair across runs")
+            << QString("\"aaaaaaa" + pair + "bbbbbbbb\"") << "v" << QString("aaaaaaa" + pair + "bbbbbbbb");
+    const int positions[] = { 6, 7, 8, 9, 15, 16, 17 };
+    for (uint i = 0; i < sizeof(positions) / sizeof(positions[0]); ++i) {
+        const int pos = positions[i];
+        const QString head(pos, QLatin1Char('x'));
+        const QString tail(10, QLatin1Char('y'));
+        QTest::newRow(qPrintable(QString("quote at %1").arg(pos)))
+                << QString("\"" + head + "\\\"" + tail + "\"") << "v" << QString(head + "\"" + tail);
+        QTest::newRow(qPrintable(QString("backslash at %1").arg(pos)))
+                << QString("\"" + head + "\\\\" + tail + "\"") << "v" << QString(head + "\\" + tail);
+        QTest::newRow(qPrintable(QString("end at %1").arg(pos)))
+                << QString("[\"" + head + "\",1]") << "v[0] + v[1]" << QString(head + "1");
+    }
+
+    // Raw control characters are not allowed in strings
+    QTest::newRow("control character") << "\"a\x01" "b\"" << "" << "";
+    QTest::newRow("tab after a run") << "\"aaaaaaaa\tb\"" << "" << "";
+    QTest::newRow("newline after an escape") << "\"a\\nb\nc\"" << "" << "";
+    QTest::newRow("control character in key") << "{\"a\x1f\":1}" << "" << "";
+    QTest::newRow("control character in hinted key")
+            << "[{\"ab\":1},{\"a\tb\":2}]" << "" << "";
+
+    // Integers of up to seven digits are converted directly
+    QTest::newRow("negative") << "-5" << "v" << "-5";
+    QTest::newRow("zero") << "[0,-0]" << "1 / v[0] + ',' + 1 / v[1]" << "Infinity,-Infinity";
+    QTest::newRow("negative zero fraction") << "-0.0" << "1 / v" << "-Infinity";
+    QTest::newRow("7 digits") << "[1234567,-9999999]" << "v.join()" << "1234567,-9999999";
+    QTest::newRow("8 digits") << "[12345678,-99999999]" << "v.join()" << "12345678,-99999999";
+    QTest::newRow("9 digits") << "[123456789,-987654321]" << "v.join()" << "123456789,-987654321";
+    QTest::newRow("10 digits")
+            << "[2147483647,2147483648,-2147483648,-2147483649,9999999999]" << "v.join()"
+            << "2147483647,2147483648,-2147483648,-2147483649,9999999999";
+    QTest::newRow("fraction and exponent")
+            << "[-1.5,1e3,12E+2,1.25e-2,-2.5E-1]" << "v.join()" << "-1.5,1000,1200,0.0125,-0.25";
+    QTest::newRow("leading zero") << "01" << "" << "";
+}
+
+void tst_QJSEngine::JSONparseFastPaths()
+{
+    QFETCH(QString, json);
+    QFETCH(QString, expression);
+    QFETCH(QString, expected);
+
+    QJSEngine eng;
+    eng.globalObject().setProperty("json", json);
+    QJSValue ret = eng.evaluate("var v = JSON.parse(json);" + expression);
+    if (expression.isEmpty()) {
+        QVERIFY(ret.isError());
+        return;
+    }
+    QVERIFY2(!ret.isError(), qPrintable(ret.toString()));
+    QCOMPARE(ret.toString(), expected);
+}
+
+void tst_QJSEngine::JSONstringify_data()
+{
+    QTest::addColumn<QString>("code");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("plain") << "JSON.stringify({a: 1, b: 'x', c: [true, null]})"
+                           << "{\"a\":1,\"b\":\"x\",\"c\":[true,null]}";
+    QTest::newRow("replacer deletes sibling")
+            << "var o = {a: 1, b: 2, c: 3};"
+               "JSON.stringify(o, function(k, v) { if (k === 'a') delete this.b; return v; })"
+            << "{\"a\":1,\"c\":3}";
+    QTest::newRow("toJSON deletes sibling")
+            << "var o = {a: {toJSON: function() { delete o.b; return 1; }}, b: 2, c: 3};"
+               "JSON.stringify(o)"
+            << "{\"a\":1,\"c\":3}";
+    QTest::newRow("toJSON changes sibling")
+            << "var o = {a: {toJSON: function() { o.b = 'x'; return 1; }}, b: 2, c: 3};"
+               "JSON.stringify(o)"
+            << "{\"a\":1,\"b\":\"x\",\"c\":3}";
+    QTest::newRow("toJSON adds sibling")
+            << "var o = {a: {toJSON: function() { o.d = 4; return 1; }}, b: 2, c: 3};"
+               "JSON.stringify(o)"
+            << "{\"a\":1,\"b\":2,\"c\":3}";
+    QTest::newRow("toJSON deletes and adds sibling")
+            << "var o = {a: {toJSON: function() { delete o.b; o.d = 4; o.b = 5; return 1; }}, b: 2, c: 3};"
+               "JSON.stringify(o)"
+            << "{\"a\":1,\"b\":5,\"c\":3}";
+    QTest::newRow("same shape, different members")
+            << "var l = [{a: 1, b: 2}, {a: {toJSON: function() { delete l[2].b; return 3; }}, b: 4}, {a: 5, b: 6}];"
+               "JSON.stringify(l)"
+            << "[{\"a\":1,\"b\":2},{\"a\":3,\"b\":4},{\"a\":5}]";
+}
+
+void tst_QJSEngine::JSONstringify()
+{
+    QFETCH(QString, code);
+    QFETCH(QString, expected);
+
+    QJSEngine eng;
+    QJSValue ret = eng.evaluate(code);
+    QVERIFY(!ret.isError());
+    QCOMPARE(ret.toString(), expected);
+}
+
 static QRegExp minimal(QRegExp r) { r.setMinimal(true); return r; }
 
 void tst_QJSEngine::qRegExpInport_data()
@@ -2999,6 +3137,35 @@ void tst_QJSEngine::indexedAccesses()
     QVERIFY(v.isUndefined());
 }
 
+void tst_QJSEngine::typedArrays()
+{
+    QJSEngine engine;
+    QJSValue v = engine.evaluate("var a = new Float32Array(4); a[1] = 0.5; a[4] = 1; a.length + a[1]");
+    QCOMPARE(v.toNumber(), 4.5);
+    v = engine.evaluate("a[4]");
+    QVERIFY(v.isUndefined());
+
+    v = engine.evaluate("var b = new Uint8ClampedArray([-5, 300, 1.5, 2.5]); Array.prototype.join.call(b, ',')");
+    QCOMPARE(v.toString(), QString("0,255,2,2"));
+
+    v = engine.evaluate("var buf = new ArrayBuffer(8); var i32 = new Int32Array(buf); var u8 = new Uint8Array(buf, 4);"
+                        "i32[1] = -1; u8[0] + u8.length + buf.byteLength");
+    QCOMPARE(v.toInt(), 255 + 4 + 8);
+
+    v = engine.evaluate("var view = new DataView(buf); view.setUint16(0, 0x1234); view.getUint16(0, true)");
+    QCOMPARE(v.toInt(), 0x3412);
+
+    v = engine.evaluate("var s = new Int16Array([1, 2, 3, 4]).subarray(1, 3); s.length * 10 + s[1]");
+    QCOMPARE(v.toInt(), 23);
+
+    v = engine.evaluate("new Int8Array(-1)");
+    QVERIFY(v.isError());
+    v = engine.evaluate("new Int32Array(new ArrayBuffer(8), 1)");
+    QVERIFY(v.isError());
+    v = engine.evaluate("Uint8Array(4)");
+    QVERIFY(v.isError());
+}
+
 void tst_QJSEngine::prototypeChainGc()
 {
     QJSEngine engine;
@@ -133,6 +133,7 @@ private slots:
     void datetime();
     void datetime_data();
     void about_to_be_signals();
+    void bulk_signals();
 };
 
 bool tst_qqmllistmodel::compareVariantList(const QVariantList &testList, QVariant object)
@@ -537,6 +538,26 @@ void tst_qqmllistmodel::dynamic_data()
         QTest::newRow("move3c") << "{append({'foo':123});append({'foo':456});append({'foo':789});move(1,0,-1);count}" << 3 << "<Unknown File>: QML ListModel: move: out of range" << dr;
         QTest::newRow("move3d") << "{append({'foo':123});append({'foo':456});append({'foo':789});move(0,3,1);count}" << 3 << "<Unknown File>: QML ListModel: move: out of range" << dr;
 
+        QTest::newRow("appendRows1") << "{appendRows([{'foo':123},{'foo':456},{'foo':789}]);get(2).foo}" << 789 << "" << dr;
+        QTest::newRow("appendRows2") << "{appendRows({'foo':[1,2,3],'bar':['a','b','c']});count}" << 3 << "" << dr;
+        QTest::newRow("appendRows3") << "{appendRows({'foo':[1,2,3],'bar':['a','b','c']});get(1).foo}" << 2 << "" << dr;
+        QTest::newRow("appendRows4") << "{appendRows({'foo':[1,2,3],'bar':['a']});get(2).foo}" << 3 << "" << dr;
+        QTest::newRow("appendRows5") << "{append({'foo':1});appendRows({'foo':[2,3]});get(2).foo}" << 3 << "" << dr;
+        QTest::newRow("appendRows6") << "{appendRows(123);count}" << 0 << "<Unknown File>: QML ListModel: appendRows: value is not an array or an object of arrays" << dr;
+
+        QTest::newRow("setRange1") << "{appendRows({'foo':[1,2,3]});setRange(1,[{'foo':20},{'foo':30}]);get(1).foo+get(2).foo}" << 50 << "" << dr;
+        QTest::newRow("setRange2") << "{appendRows({'foo':[1,2,3]});setRange(2,[{'foo':20},{'foo':30}]);get(2).foo}" << 3 << "<Unknown File>: QML ListModel: setRange: indices [2 - 4] out of range [0 - 3]" << dr;
+
+        QTest::newRow("sortByRole1") << "{appendRows({'foo':[3,1,2]});sortByRole('foo');get(0).foo}" << 1 << "" << dr;
+        QTest::newRow("sortByRole2") << "{appendRows({'foo':[3,1,2]});sortByRole('foo', Qt.DescendingOrder);get(2).foo}" << 1 << "" << dr;
+        QTest::newRow("sortByRole3") << "{appendRows({'foo':[1,1,0],'bar':[1,2,3]});sortByRole('foo');get(2).bar}" << 2 << "" << dr;
+        QTest::newRow("sortByRole4") << "{appendRows({'foo':['b','c','a'],'bar':[1,2,3]});sortByRole('foo');get(0).bar}" << 3 << "" << dr;
+        QTest::newRow("sortByRole5") << "{append({'foo':1});sortByRole('bar');count}" << 1 << "<Unknown File>: QML ListModel: sortByRole: role bar does not exist" << dr;
+
+        QTest::newRow("filter1") << "{appendRows({'foo':[1,2,3,4]});filter('foo',function(v){return v % 2 == 0});count}" << 2 << "" << dr;
+        QTest::newRow("filter2") << "{appendRows({'foo':[1,2,3,4]});filter('foo',function(v){return v % 2 == 0});get(1).foo}" << 4 << "" << dr;
+        QTest::newRow("filter3") << "{appendRows({'foo':[1,2]});filter('foo',1);count}" << 2 << "<Unknown File>: QML ListModel: filter: predicate is not a function" << dr;
+
         QTest::newRow("large1") << "{append({'a':1,'b':2,'c':3,'d':4,'e':5,'f':6,'g':7,'h':8});get(0).h}" << 8 << "" << dr;
 
         QTest::newRow("datatypes1") << "{append({'a':1});append({'a':'string'});}" << 0 << "<Unknown File>: Can't assign to existing role 'a' of different type [String -> Number]" << dr;
@@ -1394,6 +1415,47 @@ private:
     QAbstractItemModel *model;
 };
 
+void tst_qqmllistmodel::bulk_signals()
+{
+    QQmlEngine engine;
+    QQmlListModel model;
+    QQmlEngine::setContextForObject(&model,engine.rootContext());
+
+    RowTester tester(&model);
+    QSignalSpy spyChanged(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    QSignalSpy spyLayout(&model, SIGNAL(layoutChanged()));
+    QSignalSpy spyReset(&model, SIGNAL(modelReset()));
+
+    QQmlExpression e1(engine.rootContext(), &model, "{appendRows({'value':[3,1,2,5,4]})}");
+    e1.evaluate();
+
+    QCOMPARE(tester.rowsInsertedCalls, 1);
+    QCOMPARE(tester.rowsInsertedCount, 5);
+
+    QQmlExpression e2(engine.rootContext(), &model, "{setRange(1,[{'value':6},{'value':7},{'value':8}])}");
+    e2.evaluate();
+
+    QCOMPARE(spyChanged.count(), 1);
+    QCOMPARE(spyChanged.at(0).at(0).value<QModelIndex>().row(), 1);
+    QCOMPARE(spyChanged.at(0).at(1).value<QModelIndex>().row(), 3);
+
+    QPersistentModelIndex second(model.index(1, 0, QModelIndex()));
+    QQmlExpression e3(engine.rootContext(), &model, "{sortByRole('value')}");
+    e3.evaluate();
+
+    QCOMPARE(spyLayout.count(), 1);
+    QCOMPARE(tester.rowsMovedCalls, 0);
+    QCOMPARE(model.data(0, 0), QVariant(3.0));
+    QCOMPARE(second.row(), 2);
+
+    QQmlExpression e4(engine.rootContext(), &model, "{filter('value',function(v){return v > 5})}");
+    e4.evaluate();
+
+    QCOMPARE(spyReset.count(), 1);
+    QCOMPARE(tester.rowsRemovedCalls, 0);
+    QCOMPARE(model.count(), 3);
+}
+
 void tst_qqmllistmodel::about_to_be_signals()
 {
     QQmlEngine engine;
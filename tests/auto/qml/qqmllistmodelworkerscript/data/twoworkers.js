@@ -0,0 +1,8 @@
+WorkerScript.onMessage = function(msg) {
+    var received = msg.model !== undefined
+    if (received) {
+        msg.model.append({'value': msg.value})
+        msg.model.sync()
+    }
+    WorkerScript.sendMessage({'received': received})
+}
@@ -0,0 +1,32 @@
+import QtQuick 2.0
+
+Item {
+    id: item
+    property variant model
+    property bool done: false
+    property bool firstReceived: false
+    property bool secondReceived: false
+
+    function start() {
+        done = false
+        first.sendMessage({'model': model, 'value': 1})
+    }
+
+    WorkerScript {
+        id: first
+        source: "twoworkers.js"
+        onMessage: {
+            item.firstReceived = messageObject.received
+            second.sendMessage({'model': item.model, 'value': 2})
+        }
+    }
+
+    WorkerScript {
+        id: second
+        source: "twoworkers.js"
+        onMessage: {
+            item.secondReceived = messageObject.received
+            item.done = true
+        }
+    }
+}
@@ -115,8 +115,12 @@ private slots:
     void worker_remove_element();
     void worker_remove_list_data();
     void worker_remove_list();
+    void worker_delta_sync_data();
+    void worker_delta_sync();
     void dynamic_role_data();
     void dynamic_role();
+    void shared_model_data();
+    void shared_model();
 };
 
 bool tst_qqmllistmodelworkerscript::compareVariantList(const QVariantList &testList, QVariant object)
@@ -808,6 +812,63 @@ void tst_qqmllistmodelworkerscript::worker_remove_list()
     qApp->processEvents();
 }
 
+void tst_qqmllistmodelworkerscript::worker_delta_sync_data()
+{
+    worker_sync_data();
+}
+
+void tst_qqmllistmodelworkerscript::worker_delta_sync()
+{
+    QFETCH(bool, dynamicRoles);
+
+    // Static role models sync only the changed elements, dynamic role models
+    // copy the whole model; both must end up in the same state
+
+    QQmlListModel model;
+    model.setDynamicRoles(dynamicRoles);
+    QQmlEngine eng;
+    QQmlComponent component(&eng, testFileUrl("model.qml"));
+    QQuickItem *item = createWorkerTest(&eng, &component, &model);
+    QVERIFY(item != 0);
+
+    QVariantList operations;
+    operations << "appendRows({'value':[0,1,2,3,4],'name':['a','b','c','d','e']})";
+    QVERIFY(QMetaObject::invokeMethod(item, "evalExpressionViaWorker", Q_ARG(QVariant, operations)));
+    waitForWorker(item);
+
+    QCOMPARE(model.count(), 5);
+    int valueRole = roleFromName(&model, "value");
+    int nameRole = roleFromName(&model, "name");
+    QCOMPARE(model.data(4, valueRole).toInt(), 4);
+    QCOMPARE(model.data(4, nameRole).toString(), QString("e"));
+
+    QSignalSpy spyInserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy spyRemoved(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+    QSignalSpy spyMoved(&model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)));
+    QSignalSpy spyChanged(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+
+    operations.clear();
+    operations << "setProperty(1,'value',10)" << "remove(0)" << "move(0,2,1)" << "insert(1,{'value':20,'name':'x'})";
+    QVERIFY(QMetaObject::invokeMethod(item, "evalExpressionViaWorker", Q_ARG(QVariant, operations)));
+    waitForWorker(item);
+
+    QCOMPARE(spyChanged.count(), 1);
+    QCOMPARE(spyRemoved.count(), 1);
+    QCOMPARE(spyMoved.count(), 1);
+    QCOMPARE(spyInserted.count(), 1);
+
+    const int values[] = { 2, 20, 3, 10, 4 };
+    const char *names[] = { "c", "x", "d", "b", "e" };
+    QCOMPARE(model.count(), 5);
+    for (int i = 0; i < 5; ++i) {
+        QCOMPARE(model.data(i, valueRole).toInt(), values[i]);
+        QCOMPARE(model.data(i, nameRole).toString(), QString(names[i]));
+    }
+
+    delete item;
+    qApp->processEvents();
+}
+
 void tst_qqmllistmodelworkerscript::dynamic_role_data()
 {
     QTest::addColumn<QString>("preamble");
@@ -854,6 +915,47 @@ void tst_qqmllistmodelworkerscript::dynamic_role()
     qApp->processEvents();
 }
 
+void tst_qqmllistmodelworkerscript::shared_model_data()
+{
+    QTest::addColumn<QByteArray>("threads");
+    QTest::addColumn<bool>("secondReceived");
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("one thread") << QByteArray("1") << true << 2;
+    QTest::newRow("two threads") << QByteArray("2") << false << 1;
+}
+
+void tst_qqmllistmodelworkerscript::shared_model()
+{
+    QFETCH(QByteArray, threads);
+    QFETCH(bool, secondReceived);
+    QFETCH(int, count);
+
+    // The two worker scripts are put on separate threads if allowed to.
+    qputenv("QML_WORKERSCRIPT_THREADS", threads);
+
+    QQmlListModel model;
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("twoworkers.qml"));
+    QQuickItem *item = createWorkerTest(&engine, &component, &model);
+    qunsetenv("QML_WORKERSCRIPT_THREADS");
+    QVERIFY(item != 0);
+
+    if (!secondReceived)
+        QTest::ignoreMessage(QtWarningMsg, "ListModel: a model can only be shared by WorkerScripts running on the same thread");
+
+    QVERIFY(QMetaObject::invokeMethod(item, "start"));
+    waitForWorker(item);
+
+    QCOMPARE(item->property("firstReceived").toBool(), true);
+    QCOMPARE(item->property("secondReceived").toBool(), secondReceived);
+    QCOMPARE(model.count(), count);
+    QCOMPARE(model.data(0, roleFromName(&model, "value")).toInt(), 1);
+
+    delete item;
+    qApp->processEvents();
+}
+
 QTEST_MAIN(tst_qqmllistmodelworkerscript)
 
 #include "tst_qqmllistmodelworkerscript.moc"
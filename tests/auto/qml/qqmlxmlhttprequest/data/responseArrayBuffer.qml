@@ -0,0 +1,49 @@
+import QtQuick 2.0
+
+QtObject {
+    property string url
+    property string expectedText
+
+    property bool unsent: false
+    property bool loading: false
+    property bool byteLength: false
+    property bool contents: false
+    property bool sameObject: false
+    property bool reset: false
+
+    property bool dataOK: false
+
+    Component.onCompleted: {
+        var x = new XMLHttpRequest;
+        x.responseType = "arraybuffer";
+
+        unsent = (x.response === null);
+
+        x.open("GET", url);
+        x.setRequestHeader("Accept-Language", "en-US");
+
+        x.onreadystatechange = function() {
+            if (x.readyState == XMLHttpRequest.LOADING) {
+                loading = (x.response === null);
+            } else if (x.readyState == XMLHttpRequest.DONE) {
+                var buffer = x.response;
+                byteLength = (buffer.byteLength == expectedText.length);
+
+                var bytes = new Uint8Array(buffer);
+                var text = "";
+                for (var i = 0; i < bytes.length; ++i)
+                    text += String.fromCharCode(bytes[i]);
+                contents = (text == expectedText);
+
+                sameObject = (x.response === x.response) && (x.response === buffer);
+
+                x.open("GET", url);
+                reset = (x.response === null);
+
+                dataOK = true;
+            }
+        }
+
+        x.send()
+    }
+}
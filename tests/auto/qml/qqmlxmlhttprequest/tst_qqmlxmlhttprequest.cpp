@@ -98,6 +98,7 @@ private slots:
     void statusText_data();
     void responseText();
     void responseText_data();
+    void responseArrayBuffer();
     void responseXML_invalid();
     void invalidMethodUsage();
     void redirects();
@@ -869,6 +870,31 @@ void tst_qqmlxmlhttprequest::responseText_data()
     QTest::newRow("Bad Request") << testFileUrl("status.400.reply") << testFileUrl("testdocument.html") << "QML Rocks!\n";
 }
 
+void tst_qqmlxmlhttprequest::responseArrayBuffer()
+{
+    TestHTTPServer server(SERVER_PORT);
+    QVERIFY(server.isValid());
+    QVERIFY(server.wait(testFileUrl("status.expect"),
+                        testFileUrl("status.200.reply"),
+                        testFileUrl("testdocument.html")));
+
+    QQmlComponent component(&engine, testFileUrl("responseArrayBuffer.qml"));
+    QScopedPointer<QObject> object(component.beginCreate(engine.rootContext()));
+    QVERIFY(!object.isNull());
+    object->setProperty("url", "http://127.0.0.1:14445/testdocument.html");
+    object->setProperty("expectedText", "QML Rocks!\n");
+    component.completeCreate();
+
+    QTRY_VERIFY(object->property("dataOK").toBool() == true);
+
+    QCOMPARE(object->property("unsent").toBool(), true);
+    QCOMPARE(object->property("loading").toBool(), true);
+    QCOMPARE(object->property("byteLength").toBool(), true);
+    QCOMPARE(object->property("contents").toBool(), true);
+    QCOMPARE(object->property("sameObject").toBool(), true);
+    QCOMPARE(object->property("reset").toBool(), true);
+}
+
 void tst_qqmlxmlhttprequest::nonUtf8()
 {
     QFETCH(QString, fileName);
@@ -39,6 +39,7 @@
 **
 ****************************************************************************/
 #include <qtest.h>
+#include <QtTest/QSignalSpy>
 #include <QtCore/qdebug.h>
 #include <QtCore/qtimer.h>
 #include <QtCore/qdir.h>
@@ -72,6 +73,7 @@ private slots:
     void script_var();
     void script_global();
     void stressDispose();
+    void statistics();
 
 private:
     void waitForEchoMessage(QQuickWorkerScript *worker) {
@@ -138,7 +140,11 @@ void tst_QQuickWorkerScript::messaging_data()
     QTest::newRow("int") << qVariantFromValue(1001);
     QTest::newRow("real") << qVariantFromValue(10334.375);
     QTest::newRow("string") << qVariantFromValue(QString("More cheeeese, Gromit!"));
+    QTest::newRow("long string") << qVariantFromValue(QString(1000, QLatin1Char('x')));
     QTest::newRow("variant list") << qVariantFromValue((QVariantList() << "a" << "b" << "c"));
+    QTest::newRow("int list") << qVariantFromValue((QVariantList() << 1 << -2 << 3));
+    QTest::newRow("real list") << qVariantFromValue((QVariantList() << 0.5 << 2.5 << -3.25));
+    QTest::newRow("mixed list") << qVariantFromValue((QVariantList() << 1 << QString(200, QLatin1Char('y')) << 2.5));
     QTest::newRow("date time") << qVariantFromValue(QDateTime::currentDateTime());
 #ifndef QT_NO_REGEXP
     // Qt Script's QScriptValue -> QRegExp uses RegExp2 pattern syntax
@@ -364,6 +370,25 @@ void tst_QQuickWorkerScript::script_global()
     }
 }
 
+void tst_QQuickWorkerScript::statistics()
+{
+    QQmlComponent component(&m_engine, testFileUrl("worker.qml"));
+    QQuickWorkerScript *worker = qobject_cast<QQuickWorkerScript*>(component.create());
+    QVERIFY(worker != 0);
+    QCOMPARE(worker->pendingMessages(), 0);
+
+    QSignalSpy spy(worker, SIGNAL(statisticsChanged()));
+    QVERIFY(QMetaObject::invokeMethod(worker, "testSend", Q_ARG(QVariant, QVariant(42))));
+    QVERIFY(spy.count() >= 1);
+    waitForEchoMessage(worker);
+
+    QCOMPARE(worker->pendingMessages(), 0);
+    QVERIFY(worker->busyTime() > 0);
+
+    qApp->processEvents();
+    delete worker;
+}
+
 // Rapidly create and destroy worker scripts to test resources are being disposed
 // in the correct isolate
 void tst_QQuickWorkerScript::stressDispose()
@@ -43,6 +43,8 @@
 #include <QtTest/QtTest>
 
 #include <QtQuick/qsggeometry.h>
+#include <QtQuick/qsgnode.h>
+#include <QtQuick/private/qsgpoolallocator_p.h>
 
 class GeometryTest : public QObject
 {
@@ -54,6 +56,7 @@ private Q_SLOTS:
     void testPoint2D();
     void testTexturedPoint2D();
     void testCustomGeometry();
+    void testPooledStorage();
 
 private:
 };
@@ -175,6 +178,95 @@ void GeometryTest::testCustomGeometry()
 
 }
 
+class ReleaseThread : public QThread
+{
+public:
+    ReleaseThread(void *block, int sizeClass)
+        : block(block), sizeClass(sizeClass), hadPool(true) { }
+
+    void run()
+    {
+        hadPool = QSGPoolAllocator::current() != 0;
+        QSGPoolAllocator::release(block, sizeClass);
+    }
+
+    void *block;
+    int sizeClass;
+    bool hadPool;
+};
+
+void GeometryTest::testPooledStorage()
+{
+    QCOMPARE(QSGPoolAllocator::sizeClassFor(1), 0);
+    QCOMPARE(QSGPoolAllocator::sizeClassFor(512), 31);
+    QCOMPARE(QSGPoolAllocator::sizeClassFor(513), 32);
+    QCOMPARE(QSGPoolAllocator::sizeClassFor(QSGPoolAllocator::MaxBlockSize), QSGPoolAllocator::SizeClassCount - 1);
+    QCOMPARE(QSGPoolAllocator::sizeClassFor(QSGPoolAllocator::MaxBlockSize + 1), -1);
+    for (int i = 0; i < QSGPoolAllocator::SizeClassCount; ++i)
+        QCOMPARE(QSGPoolAllocator::sizeClassFor(QSGPoolAllocator::blockSize(i)), i);
+
+    QSGPoolAllocator pool;
+    QSGPoolAllocator::setCurrent(&pool);
+
+    QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 100, 60);
+    void *data = geometry->vertexData();
+    delete geometry;
+
+    // Storage of a similar size is reused from the pool...
+    geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 98, 60);
+    QVERIFY(geometry->vertexData() == data);
+
+    QCOMPARE(pool.reused(), quint64(1));
+    delete geometry;
+
+    // Pooled nodes reuse the block of a deleted node of the same type
+    QSGPooledNode<QSGTransformNode> *node = new QSGPooledNode<QSGTransformNode>;
+    delete node;
+    const quint64 recycled = pool.recycled();
+    QSGPooledNode<QSGTransformNode> *other = new QSGPooledNode<QSGTransformNode>;
+    QVERIFY(other == node);
+    QCOMPARE(pool.reused(), quint64(2));
+    delete other;
+    QCOMPARE(pool.recycled(), recycled + 1);
+    QCOMPARE(pool.allocations(), quint64(4));
+
+    // A block released on a thread without a pool goes back to the heap
+    int sizeClass;
+    void *block = QSGPoolAllocator::allocate(40000, &sizeClass);
+    QCOMPARE(sizeClass, QSGPoolAllocator::sizeClassFor(40000));
+    const int cachedBlocks = pool.cachedBlocks();
+    ReleaseThread thread(block, sizeClass);
+    thread.start();
+    QVERIFY(thread.wait());
+    QVERIFY(!thread.hadPool);
+    QCOMPARE(pool.cachedBlocks(), cachedBlocks);
+    QCOMPARE(pool.recycled(), recycled + 1);
+
+    QVERIFY(pool.cachedBlocks() > 0);
+    QVERIFY(pool.cachedBytes() > 0);
+
+    // The cache of all size classes together stays within the budget
+    QVector<void *> blocks;
+    for (int i = 0; i < 40; ++i)
+        blocks << QSGPoolAllocator::allocate(QSGPoolAllocator::MaxBlockSize, &sizeClass);
+    for (int i = 0; i < blocks.size(); ++i)
+        QSGPoolAllocator::release(blocks.at(i), sizeClass);
+    QVERIFY(pool.cachedBytes() <= size_t(QSGPoolAllocator::MaxCachedBytes));
+    QVERIFY(pool.cachedBytes() > size_t(QSGPoolAllocator::MaxCachedBytes - QSGPoolAllocator::MaxBlockSize));
+
+    pool.clear();
+    QCOMPARE(pool.cachedBlocks(), 0);
+    QCOMPARE(pool.cachedBytes(), size_t(0));
+
+    QSGPoolAllocator::setCurrent(0);
+    QVERIFY(!QSGPoolAllocator::current());
+
+    // Without a pool, storage whose size class is recorded is not rounded up
+    block = QSGPoolAllocator::allocate(40000, &sizeClass);
+    QCOMPARE(sizeClass, -1);
+    QSGPoolAllocator::release(block, sizeClass);
+}
+
 
 QTEST_MAIN(GeometryTest);
 
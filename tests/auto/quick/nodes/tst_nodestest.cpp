@@ -44,12 +44,14 @@
 
 #include <QtGui/QOffscreenSurface>
 #include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFramebufferObject>
 
 #include <QtQuick/qsgnode.h>
 #include <QtQuick/private/qsgbatchrenderer_p.h>
 #include <QtQuick/private/qsgnodeupdater_p.h>
 #include <QtQuick/private/qsgrenderloop_p.h>
 #include <QtQuick/private/qsgcontext_p.h>
+#include <QtQuick/private/qsgatlastexture_p.h>
 
 #include <QtQuick/qsgsimplerectnode.h>
 
@@ -74,6 +76,12 @@ private Q_SLOTS:
 
     void isBlockedCheck();
 
+    // Texture atlas
+    void atlasPages();
+
+    // Batch renderer
+    void renderListMaintenance();
+
 private:
     QOffscreenSurface *surface;
     QOpenGLContext *context;
@@ -259,6 +267,189 @@ void NodesTest::isBlockedCheck()
     QVERIFY(!updater.isNodeBlocked(node, &root));
 }
 
+void NodesTest::atlasPages()
+{
+    // Two pages with room for a few 100x100 images each.
+    qputenv("QSG_ATLAS_WIDTH", "256");
+    qputenv("QSG_ATLAS_HEIGHT", "256");
+    qputenv("QSG_ATLAS_MAX_PAGES", "2");
+    QSGAtlasTexture::Manager *manager = new QSGAtlasTexture::Manager();
+    qunsetenv("QSG_ATLAS_WIDTH");
+    qunsetenv("QSG_ATLAS_HEIGHT");
+    qunsetenv("QSG_ATLAS_MAX_PAGES");
+
+    QSGAtlasTexture::Manager::Statistics stats = manager->statistics();
+    QCOMPARE(stats.pages, 0);
+    QCOMPARE(stats.textures, 0);
+
+    QImage image(100, 100, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::red);
+    const qint64 paddedArea = 102 * 102;
+
+    // Too large for the atlas
+    QVERIFY(!manager->create(QImage(200, 50, QImage::Format_ARGB32_Premultiplied)));
+    QCOMPARE(manager->statistics().fallbacks, 0);
+
+    // Fill the first page, a second one is added once it is full.
+    QList<QSGAtlasTexture::Texture *> textures;
+    QSGAtlasTexture::Atlas *firstPage = 0;
+    QSGAtlasTexture::Atlas *secondPage = 0;
+    for (int i = 0; i < 20 && !secondPage; ++i) {
+        QSGAtlasTexture::Texture *t = static_cast<QSGAtlasTexture::Texture *>(manager->create(image));
+        QVERIFY(t);
+        textures << t;
+        if (!firstPage)
+            firstPage = t->atlas();
+        else if (t->atlas() != firstPage)
+            secondPage = t->atlas();
+    }
+    QVERIFY(secondPage);
+    const int texturesPerPage = textures.size() - 1;
+    QVERIFY(texturesPerPage > 1);
+
+    stats = manager->statistics();
+    QCOMPARE(stats.pages, 2);
+    QCOMPARE(stats.textures, textures.size());
+    QCOMPARE(stats.usedArea, textures.size() * paddedArea);
+    QCOMPARE(stats.totalArea, qint64(2 * 256 * 256));
+    QCOMPARE(stats.fallbacks, 0);
+
+    // Fill the second page. With both pages full, the image is not put in
+    // the atlas and counts as a fallback.
+    for (int i = 1; i < texturesPerPage; ++i) {
+        QSGAtlasTexture::Texture *t = static_cast<QSGAtlasTexture::Texture *>(manager->create(image));
+        QVERIFY(t);
+        QCOMPARE(t->atlas(), secondPage);
+        textures << t;
+    }
+    QVERIFY(!manager->create(image));
+
+    stats = manager->statistics();
+    QCOMPARE(stats.pages, 2);
+    QCOMPARE(stats.textures, 2 * texturesPerPage);
+    QCOMPARE(stats.usedArea, 2 * texturesPerPage * paddedArea);
+    QCOMPARE(stats.fallbacks, 1);
+    QCOMPARE(stats.drains, 0);
+
+    // Space given back on the first page is used again.
+    delete textures.takeFirst();
+    QCOMPARE(manager->statistics().textures, 2 * texturesPerPage - 1);
+    QSGAtlasTexture::Texture *t = static_cast<QSGAtlasTexture::Texture *>(manager->create(image));
+    QVERIFY(t);
+    QCOMPARE(t->atlas(), firstPage);
+    textures << t;
+
+    qDeleteAll(textures);
+    stats = manager->statistics();
+    QCOMPARE(stats.pages, 2);
+    QCOMPARE(stats.textures, 0);
+    QCOMPARE(stats.usedArea, qint64(0));
+    QCOMPARE(stats.fallbacks, 1);
+
+    manager->invalidate();
+    QCOMPARE(manager->statistics().pages, 0);
+    delete manager;
+}
+
+class FboBindable : public QSGBindable
+{
+public:
+    FboBindable(QOpenGLFramebufferObject *fbo) : m_fbo(fbo) { }
+    void bind() const { m_fbo->bind(); }
+private:
+    QOpenGLFramebufferObject *m_fbo;
+};
+
+static QImage renderToImage(QSGBatchRenderer::Renderer *renderer, QOpenGLFramebufferObject *fbo)
+{
+    renderer->renderScene(FboBindable(fbo));
+    return fbo->toImage();
+}
+
+void NodesTest::renderListMaintenance()
+{
+    QSGGeometry clipGeometry(QSGGeometry::defaultAttributes_Point2D(), 4);
+    QSGGeometry::updateRectGeometry(&clipGeometry, QRectF(0, 0, 100, 100));
+
+    QSGRootNode root;
+    QSGClipNode *clip = new QSGClipNode();
+    clip->setGeometry(&clipGeometry);
+    clip->setIsRectangular(true);
+    clip->setClipRect(QRectF(0, 0, 100, 100));
+    root.appendChildNode(clip);
+
+    // Overlapping strips, each one drawn on top of the one before it. The
+    // clip node is a batch root with two spare render orders.
+    const QColor colors[] = { Qt::red, Qt::green, Qt::blue, Qt::cyan,
+                              Qt::magenta, Qt::yellow, Qt::darkRed, Qt::darkGreen };
+    QSGSimpleRectNode *strips[8];
+    for (int i = 0; i < 8; ++i) {
+        strips[i] = new QSGSimpleRectNode(QRectF(i * 10, 0, 20, 100), colors[i]);
+        clip->appendChildNode(strips[i]);
+    }
+
+    QOpenGLFramebufferObject fbo(100, 100, QOpenGLFramebufferObject::CombinedDepthStencil);
+    QSGBatchRenderer::Renderer renderer(renderContext);
+    renderer.setRootNode(&root);
+    renderer.setDeviceRect(QSize(100, 100));
+    renderer.setViewportRect(QSize(100, 100));
+    renderer.setProjectionMatrixToRect(QRectF(0, 0, 100, 100));
+
+    QImage image = renderToImage(&renderer, &fbo);
+    QCOMPARE(renderer.renderListStatistics().fullBuilds, 1);
+    for (int i = 0; i < 8; ++i)
+        QCOMPARE(image.pixel(i * 10 + 5, 50), colors[i].rgb());
+
+    // A node inserted among its siblings goes straight into the render
+    // lists, between the strips it is inserted between.
+    QSGSimpleRectNode *inserted = new QSGSimpleRectNode(QRectF(25, 0, 10, 100), Qt::white);
+    clip->insertChildNodeAfter(inserted, strips[2]);
+    image = renderToImage(&renderer, &fbo);
+    QCOMPARE(renderer.renderListStatistics().insertedSubtrees, 1);
+    QCOMPARE(renderer.renderListStatistics().partialBuilds, 0);
+    QCOMPARE(renderer.renderListStatistics().fullBuilds, 0);
+    QCOMPARE(image.pixel(27, 50), QColor(Qt::white).rgb());
+    QCOMPARE(image.pixel(33, 50), colors[3].rgb());
+    QCOMPARE(image.pixel(22, 50), colors[2].rgb());
+    QCOMPARE(image.pixel(85, 50), colors[7].rgb());
+
+    // Removing a node does not rebuild the render lists.
+    clip->removeChildNode(strips[5]);
+    delete strips[5];
+    image = renderToImage(&renderer, &fbo);
+    QCOMPARE(renderer.renderListStatistics().insertedSubtrees, 0);
+    QCOMPARE(renderer.renderListStatistics().partialBuilds, 0);
+    QCOMPARE(renderer.renderListStatistics().fullBuilds, 0);
+    QCOMPARE(image.pixel(55, 50), colors[4].rgb());
+    QCOMPARE(image.pixel(65, 50), colors[6].rgb());
+
+    // The removed strip's order is free again, but not at the end of the
+    // root, so a subtree of two nodes makes the root rebuild its lists.
+    QSGNode *group = new QSGNode();
+    group->appendChildNode(new QSGSimpleRectNode(QRectF(61, 0, 6, 100), Qt::darkBlue));
+    group->appendChildNode(new QSGSimpleRectNode(QRectF(64, 0, 6, 100), Qt::darkCyan));
+    clip->insertChildNodeAfter(group, strips[6]);
+    image = renderToImage(&renderer, &fbo);
+    QCOMPARE(renderer.renderListStatistics().insertedSubtrees, 0);
+    QCOMPARE(renderer.renderListStatistics().partialBuilds, 1);
+    QCOMPARE(renderer.renderListStatistics().fullBuilds, 0);
+    QCOMPARE(image.pixel(62, 50), QColor(Qt::darkBlue).rgb());
+    QCOMPARE(image.pixel(68, 50), QColor(Qt::darkCyan).rgb());
+    QCOMPARE(image.pixel(75, 50), colors[7].rgb());
+    QCOMPARE(image.pixel(27, 50), QColor(Qt::white).rgb());
+
+    // With no render orders left, the lists are built from scratch.
+    clip->appendChildNode(new QSGSimpleRectNode(QRectF(0, 0, 5, 100), Qt::darkMagenta));
+    image = renderToImage(&renderer, &fbo);
+    QCOMPARE(renderer.renderListStatistics().insertedSubtrees, 0);
+    QCOMPARE(renderer.renderListStatistics().partialBuilds, 0);
+    QCOMPARE(renderer.renderListStatistics().fullBuilds, 1);
+    QCOMPARE(image.pixel(2, 50), QColor(Qt::darkMagenta).rgb());
+    QCOMPARE(image.pixel(7, 50), colors[0].rgb());
+    QCOMPARE(image.pixel(68, 50), QColor(Qt::darkCyan).rgb());
+    QCOMPARE(image.pixel(85, 50), colors[7].rgb());
+}
+
 QTEST_MAIN(NodesTest);
 
 #include "tst_nodestest.moc"
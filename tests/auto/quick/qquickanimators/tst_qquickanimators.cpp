@@ -43,6 +43,8 @@
 
 #include <QtQuick>
 #include <private/qquickanimator_p.h>
+#include <private/qquickitem_p.h>
+#include <private/qquickclipnode_p.h>
 
 #include <QtQml>
 
@@ -53,6 +55,30 @@ class tst_Animators: public QObject
 private slots:
     void testMultiWinAnimator_data();
     void testMultiWinAnimator();
+    void testPropertyAnimatorOnRenderThread();
+};
+
+class ClipWidthRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    ClipWidthRecorder(QQuickItem *item) : m_item(item), m_width(-1) {}
+
+    qreal width() { QMutexLocker locker(&m_mutex); return m_width; }
+
+public slots:
+    // Called on the render thread after each frame
+    void record() {
+        QQuickDefaultClipNode *clip = QQuickItemPrivate::get(m_item)->clipNode();
+        QMutexLocker locker(&m_mutex);
+        if (clip)
+            m_width = clip->rect().width();
+    }
+
+private:
+    QQuickItem *m_item;
+    QMutex m_mutex;
+    qreal m_width;
 };
 
 void tst_Animators::testMultiWinAnimator_data()
@@ -107,6 +133,41 @@ void tst_Animators::testMultiWinAnimator()
     QVERIFY(true);
 }
 
+void tst_Animators::testPropertyAnimatorOnRenderThread()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, "data/windowWithPropertyAnimator.qml");
+    QScopedPointer<QQuickWindow> window(qobject_cast<QQuickWindow *>(component.create()));
+    QVERIFY(window);
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    if (window->openglContext()->thread() == QGuiApplication::instance()->thread())
+        QSKIP("Only the threaded render loop runs animators while the GUI thread is blocked");
+
+    QQuickItem *box = window->property("box").value<QQuickItem *>();
+    QObject *animation = window->property("animation").value<QObject *>();
+    QVERIFY(box);
+    QVERIFY(animation);
+
+    ClipWidthRecorder recorder(box);
+    connect(window.data(), SIGNAL(afterRendering()), &recorder, SLOT(record()), Qt::DirectConnection);
+
+    animation->setProperty("running", true);
+    QTRY_VERIFY(recorder.width() > 20);
+    const qreal startWidth = recorder.width();
+
+    // Block the GUI thread, the clip node should keep growing while the
+    // item's width stays at its initial value until the animation ends.
+    QTest::qSleep(500);
+
+    QVERIFY(recorder.width() > startWidth);
+    QVERIFY(recorder.width() < 180);
+    QCOMPARE(box->width(), qreal(20));
+
+    QTRY_COMPARE(box->width(), qreal(180));
+    disconnect(window.data(), SIGNAL(afterRendering()), &recorder, SLOT(record()));
+}
+
 #include "tst_qquickanimators.moc"
 
 QTEST_MAIN(tst_Animators)
@@ -204,6 +204,29 @@ CanvasTestCase {
        tryCompare(c, "paintedCount", 2);
        c.destroy();
   }
+   function test_markDirty(row) {
+       var c = createCanvasObject(row);
+       verify(c);
+       var ctx = c.getContext("2d");
+       tryCompare(c, "availableChangedCount", 1);
+       tryCompare(c, "paintedCount", 1);
+       var count = c.paintCount;
+
+       ctx.fillStyle = "red";
+       ctx.fillRect(0, 0, c.width, c.height);
+       c.requestPaint();
+       tryCompare(c, "paintCount", count + 1);
+
+       // only the marked area is repainted
+       ctx.fillStyle = "blue";
+       ctx.fillRect(0, 0, c.width, c.height);
+       c.markDirty(Qt.rect(0, 0, 10, 10));
+       tryCompare(c, "paintCount", count + 2);
+       comparePixel(ctx, 5, 5, 0, 0, 255, 255);
+       comparePixel(ctx, 50, 50, 255, 0, 0, 255);
+       c.destroy();
+  }
+
    function test_loadImage(row) {
        var c = createCanvasObject(row);
        verify(c);
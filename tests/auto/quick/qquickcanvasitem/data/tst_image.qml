@@ -715,4 +715,42 @@ CanvasTestCase {
        comparePixel(ctx, 25,25, 255,0,0,255, 2);
        comparePixel(ctx, 75,25, 255,0,0,255, 2);
    }
+   function test_concurrentTiles(row) {
+       // Tiles of an image canvas are rasterized in parallel, each
+       // replaying the same loaded image.
+       var canvas = createCanvasObject(row);
+       canvas.canvasSize = Qt.size(200, 200);
+       canvas.tileSize = Qt.size(25, 25);
+       var ctx = canvas.getContext('2d');
+       loadImages(canvas);
+       ctx.reset();
+       ctx.fillStyle = '#f00';
+       ctx.fillRect(0, 0, 100, 100);
+       ctx.drawImage('green.png', 0, 0, 100, 100);
+       for (var x = 5; x < 100; x += 25) {
+           for (var y = 5; y < 100; y += 25)
+               comparePixel(ctx, x, y, 0,255,0,255,2);
+       }
+       comparePixel(ctx, 99,99, 0,255,0,255,2);
+       canvas.destroy()
+   }
+   function test_concurrentBands(row) {
+       // A large image canvas is split into bands of rows rasterized in
+       // parallel, the image spans all of them.
+       var canvas = createCanvasObject(row);
+       canvas.width = 600;
+       canvas.height = 600;
+       var ctx = canvas.getContext('2d');
+       loadImages(canvas);
+       ctx.reset();
+       ctx.fillStyle = '#f00';
+       ctx.fillRect(0, 0, 600, 600);
+       ctx.drawImage('green.png', 0, 0, 600, 600);
+       for (var y = 0; y < 600; y += 37) {
+           comparePixel(ctx, 0, y, 0,255,0,255,2);
+           comparePixel(ctx, 599, y, 0,255,0,255,2);
+       }
+       comparePixel(ctx, 300,599, 0,255,0,255,2);
+       canvas.destroy()
+   }
 }
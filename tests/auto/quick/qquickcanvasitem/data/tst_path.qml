@@ -1465,4 +1465,45 @@ CanvasTestCase {
            comparePixel(ctx, 50,25, 0,255,0,255);
            canvas.destroy()
        }
+       function test_strokeAndClipTiles(row) {
+           // Tiles of an image canvas are rasterized in parallel, each
+           // replaying the same strokes and clips.
+           var canvas = createCanvasObject(row);
+           canvas.canvasSize = Qt.size(200, 200);
+           canvas.tileSize = Qt.size(25, 25);
+           var ctx = canvas.getContext('2d');
+           ctx.reset();
+           ctx.fillStyle = '#f00';
+           ctx.fillRect(0, 0, 100, 100);
+           ctx.strokeStyle = '#0f0';
+           ctx.lineWidth = 3;
+           for (var i = 0; i < 100; i++) {
+               ctx.save();
+               ctx.beginPath();
+               ctx.rect(0, i, 100, 1);
+               ctx.clip();
+               ctx.beginPath();
+               ctx.moveTo(0, i + 0.5);
+               ctx.lineTo(50, i + 0.5);
+               ctx.lineTo(100, i + 0.5);
+               ctx.stroke();
+               ctx.restore();
+           }
+           // Clipped away everywhere
+           ctx.beginPath();
+           ctx.rect(0, 0, 0, 0);
+           ctx.clip();
+           ctx.strokeStyle = '#f00';
+           ctx.beginPath();
+           ctx.moveTo(0, 50);
+           ctx.lineTo(100, 50);
+           ctx.stroke();
+           for (var x = 5; x < 100; x += 25) {
+               for (var y = 5; y < 100; y += 25)
+                   comparePixel(ctx, x, y, 0,255,0,255);
+           }
+           comparePixel(ctx, 99, 99, 0,255,0,255);
+           comparePixel(ctx, 50, 50, 0,255,0,255);
+           canvas.destroy()
+       }
 }
@@ -0,0 +1,25 @@
+import QtQuick 2.0
+
+Grid {
+    id: grid
+    columns: 8
+    property bool flipped: false
+
+    Repeater {
+        model: 32
+
+        Flipable {
+            id: flipable
+            width: 20; height: 20
+
+            front: Rectangle { color: "red"; anchors.fill: flipable }
+            back: Rectangle { color: "blue"; anchors.fill: flipable }
+
+            transform: Rotation {
+                origin.x: 10
+                axis.x: 0; axis.y: 1; axis.z: 0
+                angle: grid.flipped ? 180 : 0
+            }
+        }
+    }
+}
@@ -43,6 +43,7 @@
 #include <QtQml/qqmlcomponent.h>
 #include <QtQuick/qquickview.h>
 #include <private/qquickflipable_p.h>
+#include <private/qquickwindow_p.h>
 #include <private/qqmlvaluetype_p.h>
 #include <QFontMetrics>
 #include <QtQuick/private/qquickrectangle_p.h>
@@ -59,6 +60,7 @@ private slots:
     void checkFrontAndBack();
     void setFrontAndBack();
     void flipFlipable();
+    void concurrentPolish();
 
     // below here task issues
     void QTBUG_9161_crash();
@@ -124,6 +126,40 @@ void tst_qquickflipable::flipFlipable()
     delete obj;
 }
 
+void tst_qquickflipable::concurrentPolish()
+{
+    QQuickView window;
+    window.setSource(testFileUrl("flipable-grid.qml"));
+    QQuickItem *root = window.rootObject();
+    QVERIFY(root != 0);
+
+    QList<QQuickFlipable *> flipables;
+    foreach (QQuickItem *child, root->childItems()) {
+        if (QQuickFlipable *flipable = qobject_cast<QQuickFlipable *>(child))
+            flipables << flipable;
+    }
+    QCOMPARE(flipables.count(), 32);
+    QQuickWindowPrivate::get(&window)->polishItems();
+
+    // The sides are worked out on the polish workers, check what was
+    // committed before side() gets a chance to compute it again.
+    root->setProperty("flipped", true);
+    QQuickWindowPrivate::get(&window)->polishItems();
+    foreach (QQuickFlipable *flipable, flipables) {
+        QCOMPARE(flipable->front()->opacity(), qreal(0));
+        QCOMPARE(flipable->back()->opacity(), qreal(1));
+        QCOMPARE(flipable->side(), QQuickFlipable::Back);
+    }
+
+    root->setProperty("flipped", false);
+    QQuickWindowPrivate::get(&window)->polishItems();
+    foreach (QQuickFlipable *flipable, flipables) {
+        QCOMPARE(flipable->front()->opacity(), qreal(1));
+        QCOMPARE(flipable->back()->opacity(), qreal(0));
+        QCOMPARE(flipable->side(), QQuickFlipable::Front);
+    }
+}
+
 void tst_qquickflipable::QTBUG_9161_crash()
 {
     QQuickView *window = new QQuickView;
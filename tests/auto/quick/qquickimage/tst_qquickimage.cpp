@@ -106,6 +106,8 @@ private slots:
     void sourceSizeChanges();
     void correctStatus();
     void highdpi();
+    void sourceClipRect_data();
+    void sourceClipRect();
 
 private:
     QQmlEngine engine;
@@ -976,6 +978,63 @@ void tst_qquickimage::highdpi()
     delete obj;
 }
 
+void tst_qquickimage::sourceClipRect_data()
+{
+    QTest::addColumn<QRectF>("sourceClipRect");
+    QTest::addColumn<QSize>("sourceSize");
+    QTest::addColumn<QSize>("implicitSize");
+    QTest::addColumn<QSize>("referenceSize");
+
+    QTest::newRow("unclipped") << QRectF() << QSize() << QSize(300, 300) << QSize(300, 300);
+    QTest::newRow("clipped") << QRectF(10, 20, 100, 50) << QSize() << QSize(100, 50) << QSize(300, 300);
+    QTest::newRow("clipped and scaled") << QRectF(0, 0, 50, 50) << QSize(150, 150) << QSize(50, 50) << QSize(150, 150);
+    // the rectangle is in the coordinates of the scaled down image
+    QTest::newRow("clipped and scaled, offset") << QRectF(100, 80, 50, 40) << QSize(150, 150) << QSize(50, 40) << QSize(150, 150);
+    QTest::newRow("clipped and scaled by width") << QRectF(20, 30, 60, 70) << QSize(100, 0) << QSize(60, 70) << QSize(100, 100);
+    // images are not scaled up, so the rectangle stays in source coordinates
+    QTest::newRow("clipped, larger source size") << QRectF(200, 150, 100, 100) << QSize(600, 600) << QSize(100, 100) << QSize(300, 300);
+}
+
+void tst_qquickimage::sourceClipRect()
+{
+    QFETCH(QRectF, sourceClipRect);
+    QFETCH(QSize, sourceSize);
+    QFETCH(QSize, implicitSize);
+    QFETCH(QSize, referenceSize);
+
+    QQmlComponent component(&engine);
+    component.setData("import QtQuick 2.4\nImage { }", QUrl::fromLocalFile(""));
+    QScopedPointer<QQuickImage> image(qobject_cast<QQuickImage*>(component.create()));
+    QVERIFY(image);
+
+    QSignalSpy spy(image.data(), SIGNAL(sourceClipRectChanged()));
+    image->setSourceClipRect(sourceClipRect);
+    QCOMPARE(spy.count(), sourceClipRect.isNull() ? 0 : 1);
+    QCOMPARE(image->sourceClipRect(), sourceClipRect);
+
+    if (sourceSize.isValid())
+        image->setSourceSize(sourceSize);
+    image->setSource(testFileUrl("heart.png"));
+
+    QTRY_COMPARE(image->status(), QQuickImageBase::Ready);
+    QCOMPARE(image->implicitWidth(), qreal(implicitSize.width()));
+    QCOMPARE(image->implicitHeight(), qreal(implicitSize.height()));
+    QCOMPARE(image->image().size(), implicitSize);
+
+    // the loaded region matches the same part of the unclipped image
+    QScopedPointer<QQuickImage> reference(qobject_cast<QQuickImage*>(component.create()));
+    QVERIFY(reference);
+    if (sourceSize.isValid())
+        reference->setSourceSize(sourceSize);
+    reference->setSource(testFileUrl("heart.png"));
+    QTRY_COMPARE(reference->status(), QQuickImageBase::Ready);
+    QCOMPARE(reference->image().size(), referenceSize);
+
+    const QRect region = sourceClipRect.isValid() ? sourceClipRect.toRect() : QRect(QPoint(), referenceSize);
+    QCOMPARE(image->image().convertToFormat(QImage::Format_ARGB32),
+             reference->image().copy(region).convertToFormat(QImage::Format_ARGB32));
+}
+
 QTEST_MAIN(tst_qquickimage)
 
 #include "tst_qquickimage.moc"
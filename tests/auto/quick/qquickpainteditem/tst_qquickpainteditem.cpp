@@ -62,6 +62,7 @@ private slots:
     void contentsBoundingRect();
     void fillColor();
     void renderTarget();
+    void accumulatedDirtyRect();
 
 private:
     QQuickWindow window;
@@ -95,6 +96,26 @@ public:
     QRectF clipRect;
 };
 
+class ColorPaintedItem : public QQuickPaintedItem
+{
+    Q_OBJECT
+public:
+    ColorPaintedItem(QQuickItem *parent = 0)
+        : QQuickPaintedItem(parent)
+        , paintRequests(0)
+    {
+    }
+
+    void paint(QPainter *painter)
+    {
+        ++paintRequests;
+        painter->fillRect(boundingRect(), color);
+    }
+
+    QColor color;
+    int paintRequests;
+};
+
 static bool hasDirtyContentFlag(QQuickItem *item) {
     return QQuickItemPrivate::get(item)->dirtyAttributes & QQuickItemPrivate::Content; }
 static void clearDirtyContentFlag(QQuickItem *item) {
@@ -486,6 +507,34 @@ void tst_QQuickPaintedItem::renderTarget()
     QCOMPARE(spy.count(), 2);
 }
 
+void tst_QQuickPaintedItem::accumulatedDirtyRect()
+{
+    ColorPaintedItem item;
+    item.setSize(QSizeF(100, 100));
+    item.color = Qt::red;
+    item.setParentItem(window.contentItem());
+
+    item.update();
+    QTRY_COMPARE(item.paintRequests, 1);
+
+    // While the item is transparent its node is painted but never drawn,
+    // so both updates reach the texture before it is bound again.
+    item.setOpacity(0);
+    item.color = Qt::blue;
+    item.update(QRect(0, 0, 50, 50));
+    QTRY_COMPARE(item.paintRequests, 2);
+    item.update(QRect(50, 50, 50, 50));
+    QTRY_COMPARE(item.paintRequests, 3);
+    QTRY_COMPARE(hasDirtyContentFlag(&item), false);
+
+    item.setOpacity(1);
+    QImage content = window.grabWindow();
+    QCOMPARE(content.pixel(10, 10), QColor(Qt::blue).rgb());
+    QCOMPARE(content.pixel(90, 90), QColor(Qt::blue).rgb());
+    QCOMPARE(content.pixel(90, 10), QColor(Qt::red).rgb());
+    QCOMPARE(content.pixel(10, 90), QColor(Qt::red).rgb());
+}
+
 QTEST_MAIN(tst_QQuickPaintedItem)
 
 #include "tst_qquickpainteditem.moc"
@@ -75,6 +75,9 @@ private slots:
 #endif
     void lockingCrash();
     void uncached();
+    void cacheStatistics();
+    void cacheInfoNotification();
+    void visibleFirst();
 #if PIXMAP_DATA_LEAK_TEST
     void dataLeak();
 #endif
@@ -473,6 +476,158 @@ void tst_qquickpixmapcache::uncached()
     }
 }
 
+class BlockingImageProvider : public QQuickImageProvider
+{
+public:
+    BlockingImageProvider()
+        : QQuickImageProvider(Image, ForceAsynchronousImageLoading) {}
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &)
+    {
+        if (id == QLatin1String("gate")) {
+            entered.release();
+            proceed.acquire();
+        }
+        mutex.lock();
+        requests << id;
+        mutex.unlock();
+
+        QImage image(10, 10, QImage::Format_RGB32);
+        image.fill(qRgb(255, 0, 0));
+        *size = image.size();
+        return image;
+    }
+
+    QStringList takeRequests()
+    {
+        QMutexLocker locker(&mutex);
+        QStringList list = requests;
+        requests.clear();
+        return list;
+    }
+
+    QSemaphore entered;
+    QSemaphore proceed;
+
+private:
+    QMutex mutex;
+    QStringList requests;
+};
+
+void tst_qquickpixmapcache::visibleFirst()
+{
+    QQmlEngine engine;
+    BlockingImageProvider *provider = new BlockingImageProvider;
+    engine.addImageProvider(QLatin1String("blocking"), provider);
+
+    const QQuickPixmap::Options options = QQuickPixmap::Asynchronous | QQuickPixmap::Cache;
+
+    // Keep the reader busy until all other requests are queued
+    QQuickPixmap gate;
+    gate.load(&engine, QUrl("image://blocking/gate"), options);
+    QVERIFY(provider->entered.tryAcquire(1, 5000));
+
+    // Hidden pixmaps are queued with the lower priority right away, so the
+    // visible one queued after it is still served first.
+    QQuickPixmap hidden;
+    hidden.setVisible(false);
+    hidden.load(&engine, QUrl("image://blocking/hidden"), options);
+
+    QQuickPixmap visible;
+    visible.load(&engine, QUrl("image://blocking/visible"), options);
+
+    // A request released while still pending never reaches the provider
+    QQuickPixmap cancelled;
+    cancelled.load(&engine, QUrl("image://blocking/cancelled"), options);
+    QVERIFY(cancelled.isLoading());
+    cancelled.clear();
+
+    provider->proceed.release();
+
+    QTRY_VERIFY(gate.isReady());
+    QTRY_VERIFY(visible.isReady());
+    QTRY_VERIFY(hidden.isReady());
+
+    QCOMPARE(provider->takeRequests(), QStringList() << "gate" << "visible" << "hidden");
+}
+
+void tst_qquickpixmapcache::cacheStatistics()
+{
+    QQmlEngine engine;
+    engine.addImageProvider(QLatin1String("mypixmaps"), new MyPixmapProvider);
+
+    QQuickPixmap::purgeCache();
+    const int oldLimit = QQuickPixmap::cacheLimit();
+    // room for three unused 800x600 pixmaps
+    QQuickPixmap::setCacheLimit(3 * 800 * 600 * 4);
+    QCOMPARE(QQuickPixmap::cacheLimit(), 3 * 800 * 600 * 4);
+
+    const QQuickPixmapCacheStatistics before = QQuickPixmap::cacheStatistics();
+    QCOMPARE(before.unreferencedCount, 0);
+
+    for (int ii = 0; ii < 5; ++ii) {
+        QQuickPixmap p(&engine, QUrl("image://mypixmaps/stats" + QString::number(ii)));
+        QVERIFY(p.isReady());
+    }
+
+    QQuickPixmapCacheStatistics stats = QQuickPixmap::cacheStatistics();
+    QCOMPARE(stats.misses - before.misses, 5);
+    QCOMPARE(stats.hits - before.hits, 0);
+    QCOMPARE(stats.evictions - before.evictions, 2);
+    QCOMPARE(stats.unreferencedCount, 3);
+    QCOMPARE(stats.unreferencedBytes, qint64(3 * 800 * 600 * 4));
+    QVERIFY(stats.bytes >= stats.unreferencedBytes);
+
+    {
+        QQuickPixmap p(&engine, QUrl("image://mypixmaps/stats4"));
+        QVERIFY(p.isReady());
+        stats = QQuickPixmap::cacheStatistics();
+        QCOMPARE(stats.hits - before.hits, 1);
+        QCOMPARE(stats.unreferencedCount, 2);
+    }
+
+    QQuickPixmap::setCacheLimit(oldLimit);
+    QQuickPixmap::purgeCache();
+    QCOMPARE(QQuickPixmap::cacheStatistics().unreferencedCount, 0);
+}
+
+void tst_qquickpixmapcache::cacheInfoNotification()
+{
+    QQmlEngine engine;
+    engine.addImageProvider(QLatin1String("mypixmaps"), new MyPixmapProvider);
+
+    QQuickPixmap::purgeCache();
+    QQuickPixmapCacheInfo info;
+    QSignalSpy spy(&info, SIGNAL(statisticsChanged()));
+
+    const int hitsBefore = info.hits();
+    {
+        QQuickPixmap p(&engine, QUrl("image://mypixmaps/notify"));
+        QVERIFY(p.isReady());
+        for (int ii = 0; ii < 100; ++ii) {
+            QQuickPixmap q(&engine, QUrl("image://mypixmaps/notify"));
+            QVERIFY(q.isReady());
+        }
+    }
+
+    // The counters are current right away, the notification is compressed.
+    QCOMPARE(info.hits() - hitsBefore, 100);
+    QCOMPARE(spy.count(), 0);
+    QTRY_COMPARE(spy.count(), 1);
+    QTest::qWait(200);
+    QCOMPARE(spy.count(), 1);
+
+    const QQuickPixmapCacheStatistics stats = QQuickPixmap::cacheStatistics();
+    QCOMPARE(info.hits(), stats.hits);
+    QCOMPARE(info.misses(), stats.misses);
+    QCOMPARE(info.evictions(), stats.evictions);
+    QCOMPARE(info.count(), stats.count);
+    QCOMPARE(info.unreferencedCount(), stats.unreferencedCount);
+    QCOMPARE(info.unreferencedBytes(), stats.unreferencedBytes);
+    QCOMPARE(info.bytes(), stats.bytes);
+
+    QQuickPixmap::purgeCache();
+}
 
 #if PIXMAP_DATA_LEAK_TEST
 // This test should not be enabled by default as it
@@ -53,6 +53,7 @@
 #include <QSignalSpy>
 #include <qpa/qwindowsysteminterface.h>
 #include <private/qquickwindow_p.h>
+#include <private/qquickitem_p.h>
 #include <private/qguiapplication_p.h>
 
 struct TouchEventData {
@@ -362,6 +363,8 @@ private slots:
 
     void contentItemSize();
 
+    void concurrentPolish();
+
 private:
     QTouchDevice *touchDevice;
     QTouchDevice *touchDeviceWithVelocity;
@@ -1851,6 +1854,61 @@ void tst_qquickwindow::contentItemSize()
     QCOMPARE(QSizeF(rect->width(), rect->height()), size);
 }
 
+class ConcurrentPolishItemPrivate : public QQuickItemPrivate
+{
+public:
+    ConcurrentPolishItemPrivate() : thread(0), result(0) { hasConcurrentPolish = true; }
+
+    void concurrentPolish()
+    {
+        thread = QThread::currentThread();
+        int r = 0;
+        for (int i = 0; i < 1000; ++i)
+            r += i;
+        result = r;
+    }
+
+    QThread *thread;
+    int result;
+};
+
+class ConcurrentPolishItem : public QQuickItem
+{
+public:
+    ConcurrentPolishItem(QQuickItem *parent)
+        : QQuickItem(*new ConcurrentPolishItemPrivate, parent), polishThread(0), committed(0) {}
+
+    void updatePolish()
+    {
+        ConcurrentPolishItemPrivate *d = static_cast<ConcurrentPolishItemPrivate *>(QQuickItemPrivate::get(this));
+        polishThread = QThread::currentThread();
+        committed = d->result;
+    }
+
+    QThread *polishThread;
+    int committed;
+};
+
+void tst_qquickwindow::concurrentPolish()
+{
+    QQuickWindow window;
+
+    QList<ConcurrentPolishItem *> items;
+    for (int i = 0; i < 64; ++i) {
+        items << new ConcurrentPolishItem(window.contentItem());
+        items.last()->polish();
+    }
+
+    QQuickWindowPrivate::get(&window)->polishItems();
+
+    foreach (ConcurrentPolishItem *item, items) {
+        ConcurrentPolishItemPrivate *d = static_cast<ConcurrentPolishItemPrivate *>(QQuickItemPrivate::get(item));
+        QVERIFY(d->thread != 0);
+        QCOMPARE(item->polishThread, QThread::currentThread());
+        QCOMPARE(item->committed, 499500);
+    }
+}
+
 QTEST_MAIN(tst_qquickwindow)
 
 #include "tst_qquickwindow.moc"
@@ -0,0 +1,8 @@
+CONFIG += testcase
+TARGET = tst_qsgoffscreenrenderloop
+SOURCES += tst_qsgoffscreenrenderloop.cpp
+
+macx:CONFIG -= app_bundle
+
+QT += core-private gui-private qml-private quick-private testlib
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
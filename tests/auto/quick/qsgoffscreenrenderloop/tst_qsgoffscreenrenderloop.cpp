@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtQml/QQmlEngine>
+#include <QtQml/QQmlComponent>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/private/qquickwindow_p.h>
+#include <QtQuick/private/qsgrenderloop_p.h>
+
+class FrameCounter : public QObject
+{
+    Q_OBJECT
+public:
+    FrameCounter(QQuickWindow *window) : frames(0)
+    {
+        connect(window, SIGNAL(frameSwapped()), this, SLOT(frameSwapped()), Qt::DirectConnection);
+    }
+
+    int frames;
+
+public slots:
+    void frameSwapped() { ++frames; }
+};
+
+class tst_QSGOffscreenRenderLoop : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void twoWindows();
+};
+
+void tst_QSGOffscreenRenderLoop::initTestCase()
+{
+    QVERIFY(QSGRenderLoop::instance()->inherits("QSGOffscreenRenderLoop"));
+}
+
+void tst_QSGOffscreenRenderLoop::twoWindows()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData("import QtQuick 2.0\n"
+                      "Rectangle {\n"
+                      "    width: 50; height: 50; color: 'red'\n"
+                      "    property alias running: animation.running\n"
+                      "    RotationAnimation on rotation {\n"
+                      "        id: animation; from: 0; to: 360; duration: 1000\n"
+                      "        loops: Animation.Infinite\n"
+                      "    }\n"
+                      "}\n", QUrl());
+
+    QQuickWindow windows[2];
+    QScopedPointer<FrameCounter> counters[2];
+    QScopedPointer<QQuickItem> items[2];
+    for (int i = 0; i < 2; ++i) {
+        items[i].reset(qobject_cast<QQuickItem *>(component.create()));
+        QVERIFY(items[i]);
+        items[i]->setParentItem(windows[i].contentItem());
+        counters[i].reset(new FrameCounter(&windows[i]));
+        windows[i].resize(100, 100);
+        windows[i].show();
+    }
+
+    // Both windows get a frame for every step of the animation.
+    QTRY_VERIFY(counters[0]->frames >= 10 && counters[1]->frames >= 10);
+    QVERIFY(qAbs(counters[0]->frames - counters[1]->frames) <= 1);
+
+    // Once nothing changes, no more frames are rendered.
+    items[0]->setProperty("running", false);
+    items[1]->setProperty("running", false);
+    QTest::qWait(100);
+    const int frames[2] = { counters[0]->frames, counters[1]->frames };
+    QTest::qWait(100);
+    QCOMPARE(counters[0]->frames, frames[0]);
+    QCOMPARE(counters[1]->frames, frames[1]);
+
+    // An update of one window renders only that window.
+    windows[1].update();
+    QTRY_COMPARE(counters[1]->frames, frames[1] + 1);
+    QTest::qWait(50);
+    QCOMPARE(counters[0]->frames, frames[0]);
+    QCOMPARE(counters[1]->frames, frames[1] + 1);
+
+    for (int i = 0; i < 2; ++i)
+        QCOMPARE(QQuickWindowPrivate::get(&windows[i])->frameTiming.frameCount, counters[i]->frames);
+}
+
+int main(int argc, char **argv)
+{
+    // The render loop is chosen once, when the first window is created.
+    qputenv("QSG_RENDER_LOOP", "offscreen");
+    QGuiApplication app(argc, argv);
+    tst_QSGOffscreenRenderLoop tc;
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_qsgoffscreenrenderloop.moc"
@@ -71,6 +71,7 @@ QUICKTESTS =  \
     qquickview \
     qquickcanvasitem \
     qquickscreen \
+    qsgoffscreenrenderloop \
     touchmouse \
     dialogs \
 
@@ -0,0 +1,79 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.2
+
+/*
+    This test verifies that items which are fully covered by an opaque
+    rectangle are skipped without affecting the output and that they
+    are rendered again once they are no longer covered.
+
+    #samples: 8
+                 PixelPos     R    G    B    Error-tolerance
+    #base:        10  10     0.0  0.0  1.0       0.05
+    #base:        40  40     0.0  0.0  1.0       0.05
+    #base:        10 165     1.0  0.0  0.0       0.05
+    #base:       150 155     1.0  0.0  0.0       0.05
+    #final:       10  10     1.0  0.0  0.0       0.05
+    #final:       40  40     0.5  0.5  0.0       0.05
+    #final:      150  10     0.0  0.0  1.0       0.05
+    #final:      150 165     1.0  0.0  0.0       0.05
+*/
+
+RenderTestBase {
+    Rectangle { color: "#ff0000"; x: 0;  y: 0;   width: 100; height: 100; }
+    Rectangle { color: "#00ff00"; x: 20; y: 20;  width: 40;  height: 40; opacity: 0.5 }
+    Rectangle { color: "#ff0000"; x: 0;  y: 150; width: 200; height: 20; }
+
+    Rectangle {
+        id: cover
+        color: "#0000ff"
+        x: 0
+        y: 0
+        width: 120
+        height: 160
+    }
+
+    onEnterFinalStage: {
+        cover.x = 120;
+        finalStageComplete = true;
+    }
+}
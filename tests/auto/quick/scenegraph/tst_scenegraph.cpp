@@ -44,6 +44,8 @@
 #include <QtQuick>
 
 #include <private/qopenglcontext_p.h>
+#include <private/qsgthreadedrenderloop_p.h>
+#include <private/qsgshadercache_p.h>
 
 
 #include <QtQml>
@@ -60,6 +62,10 @@ private slots:
     void render();
 
     void hideWithOtherContext();
+
+    void framePacing();
+
+    void shaderDiskCache();
 };
 
 template <typename T> class ScopedList : public QList<T> {
@@ -330,6 +336,7 @@ void tst_SceneGraph::render_data()
           << "data/render_ImageFiltering.qml"
           << "data/render_bug37422.qml"
           << "data/render_OpacityThroughBatchRoot.qml"
+          << "data/render_Occlusion.qml"
         ;
 
     QRegExp sampleCount("#samples: *(\\d+)");
@@ -440,6 +447,125 @@ void tst_SceneGraph::hideWithOtherContext()
     QVERIFY(!renderingOnMainThread || QOpenGLContext::currentContext() != &context);
 }
 
+void tst_SceneGraph::framePacing()
+{
+    QSGFramePacing pacing;
+    QCOMPARE(pacing.frameCount, 0);
+
+    // Swap times in ms, render durations in ns, a vsync interval of 16 ms.
+    pacing.frameSwapped(100, 5000000, 16);
+    QCOMPARE(pacing.frameCount, 1);
+    QCOMPARE(pacing.frameDelta, qint64(0));
+    QCOMPARE(pacing.renderDuration, qint64(5000000));
+
+    pacing.frameSwapped(116, 9000000, 16);
+    QCOMPARE(pacing.frameCount, 2);
+    QCOMPARE(pacing.frameDelta, qint64(16000000));
+    QCOMPARE(pacing.missedFrames, 0);
+    QCOMPARE(pacing.renderDuration, qint64(6000000)); // smoothed
+
+    // Two vsync intervals without a swap
+    pacing.frameSwapped(164, 6000000, 16);
+    QCOMPARE(pacing.frameDelta, qint64(48000000));
+    QCOMPARE(pacing.missedFrames, 2);
+
+    // Time spent idle does not count as missed frames
+    pacing.idle();
+    QCOMPARE(pacing.predictSwap(500, 16), qint64(506));
+    pacing.frameSwapped(1000, 6000000, 16);
+    QCOMPARE(pacing.frameCount, 4);
+    QCOMPARE(pacing.missedFrames, 2);
+    QCOMPARE(pacing.frameDelta, qint64(48000000));
+
+    // The predicted swap is on the next vsync after rendering is done.
+    QCOMPARE(pacing.predictSwap(1005, 16), qint64(1016));
+    QCOMPARE(pacing.predictSwap(1020, 16), qint64(1032));
+
+    // A 60 Hz display, swaps land on the nearest millisecond.
+    const qreal vsync = 1000 / 60.0;
+    QSGFramePacing display;
+    for (int i = 0; i <= 600; ++i) {
+        qint64 swap = 1000 + qRound64(i * vsync);
+        if (i > 0)
+            QVERIFY(qAbs(display.predictSwap(swap - 4, vsync) - swap) <= 1);
+        display.frameSwapped(swap, 1000000, vsync);
+    }
+    QCOMPARE(display.frameCount, 601);
+    QCOMPARE(display.missedFrames, 0);
+
+    // Predictions many frames past the last swap do not drift.
+    const qint64 lastSwap = display.lastSwapTime;
+    for (int k = 1; k <= 600; ++k) {
+        qint64 swap = lastSwap + qRound64(k * vsync);
+        QCOMPARE(display.predictSwap(swap - 3, vsync), swap);
+    }
+}
+
+void tst_SceneGraph::shaderDiskCache()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString defaultLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+
+    qunsetenv("QT_DISABLE_SHADER_DISK_CACHE");
+    QSGShaderCache::configure(tmp.path());
+    QVERIFY(!QSGShaderCache::directory().isEmpty());
+    QDir dir(QSGShaderCache::directory());
+
+    // The first run builds every program from source and stores it.
+    const QImage reference = showAndGrab("simple.qml", 200, 200);
+    const QStringList entries = dir.entryList(QDir::Files);
+    if (entries.isEmpty()) {
+        QSGShaderCache::configure(defaultLocation);
+        QSKIP("Program binaries are not supported");
+    }
+    QCOMPARE(QSGShaderCache::hits(), 0);
+    const int misses = QSGShaderCache::misses();
+    QVERIFY(misses >= entries.size());
+
+    // The second run links all of them from the stored binaries.
+    QImage content = showAndGrab("simple.qml", 200, 200);
+    QCOMPARE(QSGShaderCache::hits(), entries.size());
+    QCOMPARE(QSGShaderCache::misses(), misses);
+    QCOMPARE(QSGShaderCache::rejected(), 0);
+    QVERIFY(compareImages(content, reference));
+
+    // Corrupt entries are rejected, removed and the programs are built
+    // from source and stored again.
+    foreach (const QString &entry, entries) {
+        QFile file(dir.filePath(entry));
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write("corrupt");
+    }
+    content = showAndGrab("simple.qml", 200, 200);
+    QCOMPARE(QSGShaderCache::rejected(), entries.size());
+    QCOMPARE(QSGShaderCache::hits(), entries.size());
+    QVERIFY(compareImages(content, reference));
+    foreach (const QString &entry, entries) {
+        QFile file(dir.filePath(entry));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QVERIFY(file.readAll() != QByteArray("corrupt"));
+    }
+
+    content = showAndGrab("simple.qml", 200, 200);
+    QCOMPARE(QSGShaderCache::hits(), 2 * entries.size());
+    QCOMPARE(QSGShaderCache::rejected(), entries.size());
+
+    // QT_DISABLE_SHADER_DISK_CACHE turns the cache off altogether.
+    foreach (const QString &entry, entries)
+        QVERIFY(dir.remove(entry));
+    qputenv("QT_DISABLE_SHADER_DISK_CACHE", "1");
+    QSGShaderCache::configure(tmp.path());
+    QVERIFY(QSGShaderCache::directory().isEmpty());
+    content = showAndGrab("simple.qml", 200, 200);
+    QCOMPARE(QSGShaderCache::hits(), 0);
+    QCOMPARE(QSGShaderCache::misses(), 0);
+    QVERIFY(dir.entryList(QDir::Files).isEmpty());
+    QVERIFY(compareImages(content, reference));
+
+    qunsetenv("QT_DISABLE_SHADER_DISK_CACHE");
+    QSGShaderCache::configure(defaultLocation);
+}
 
 #include "tst_scenegraph.moc"
 
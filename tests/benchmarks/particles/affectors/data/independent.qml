@@ -0,0 +1,99 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtQuick.Particles 2.0
+
+Rectangle {
+    color: "black"
+    width: 320
+    height: 320
+
+    ParticleSystem {
+        id: sys
+        objectName: "system"
+        anchors.fill: parent
+        running: false //Benchmark will manage it
+
+        ImageParticle {
+            groups: ["A", "B", "C", "D"]
+            source: "../../shared/star.png"
+        }
+
+        Repeater {
+            model: ["A", "B", "C", "D"]
+            Emitter {
+                id: emitter
+                system: sys
+                group: modelData
+                width: 320
+                height: 320
+                enabled: false
+                size: 32
+                emitRate: 5000
+                lifeSpan: Emitter.InfiniteLife
+                maximumEmitted: 5000
+                velocity: PointDirection { xVariance: 50; yVariance: 50 }
+                Component.onCompleted: emitter.burst(5000);
+            }
+        }
+
+        //Each affector owns its groups, so they can run in parallel
+        Gravity {
+            groups: ["A"]
+            magnitude: 100
+        }
+        Gravity {
+            groups: ["B"]
+            angle: 270
+            magnitude: 100
+        }
+        Friction {
+            groups: ["C"]
+            factor: 0.5
+        }
+        Friction {
+            groups: ["D"]
+            factor: 0.5
+            threshold: 10
+        }
+    }
+}
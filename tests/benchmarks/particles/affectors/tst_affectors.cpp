@@ -55,6 +55,9 @@ private slots:
     void test_basic_data();
     void test_filtered();
     void test_filtered_data();
+    void test_builtin();
+    void test_builtin_data();
+    void test_independent();
 };
 
 tst_affectors::tst_affectors()
@@ -159,6 +162,83 @@ void tst_affectors::test_filtered()
     delete view;
 }
 
+void tst_affectors::test_builtin_data()
+{
+    QTest::addColumn<QString> ("affector");
+    QTest::addColumn<int> ("dt");
+    QTest::newRow("gravity 16ms") << "gravity" << 16;
+    QTest::newRow("gravity 100ms") << "gravity" << 100;
+    QTest::newRow("friction 16ms") << "friction" << 16;
+    QTest::newRow("friction 100ms") << "friction" << 100;
+    QTest::newRow("wander 16ms") << "wander" << 16;
+    QTest::newRow("wander 100ms") << "wander" << 100;
+}
+
+void tst_affectors::test_builtin()
+{
+    QFETCH(QString, affector);
+    QFETCH(int, dt);
+    QQuickView* view = createView(QCoreApplication::applicationDirPath() + "/data/" + affector + ".qml");
+    QQuickParticleSystem* system = view->rootObject()->findChild<QQuickParticleSystem*>("system");
+    //Pretend we're running, but we manually advance the simulation
+    system->m_running = true;
+    system->m_animation = 0;
+    system->reset();
+
+    int curTime = 1;
+    system->updateCurrentTime(curTime);//Fixed point and get init out of the way - including emission
+
+    QBENCHMARK {
+        curTime += dt;
+        system->updateCurrentTime(curTime);
+    }
+
+    int stillAlive = 0;
+    QVERIFY(extremelyFuzzyCompare(system->groupData[0]->size(), 20000, 10));//Small simulation variance is permissible.
+    foreach (QQuickParticleData *d, system->groupData[0]->data) {
+        if (d->t == -1)
+            continue; //Particle data unused
+
+        if (d->stillAlive())
+            stillAlive++;
+        QVERIFY(!qIsNaN(d->x) && !qIsNaN(d->y));
+        QVERIFY(!qIsNaN(d->vx) && !qIsNaN(d->vy));
+    }
+    QVERIFY(extremelyFuzzyCompare(stillAlive, 20000, 10));//Small simulation variance is permissible.
+    delete view;
+}
+
+void tst_affectors::test_independent()
+{
+    QQuickView* view = createView(QCoreApplication::applicationDirPath() + "/data/independent.qml");
+    QQuickParticleSystem* system = view->rootObject()->findChild<QQuickParticleSystem*>("system");
+    //Pretend we're running, but we manually advance the simulation
+    system->m_running = true;
+    system->m_animation = 0;
+    system->reset();
+
+    int curTime = 1;
+    system->updateCurrentTime(curTime);//Fixed point and get init out of the way - including emission
+
+    QBENCHMARK {
+        curTime += 16;
+        system->updateCurrentTime(curTime);
+    }
+
+    foreach (QQuickParticleGroupData *gd, system->groupData) {
+        if (gd->name().isEmpty())
+            continue;
+        QVERIFY(extremelyFuzzyCompare(gd->size(), 5000, 10));//Small simulation variance is permissible.
+        foreach (QQuickParticleData *d, gd->data) {
+            if (d->t == -1)
+                continue; //Particle data unused
+            QVERIFY(!qIsNaN(d->x) && !qIsNaN(d->y));
+            QVERIFY(!qIsNaN(d->vx) && !qIsNaN(d->vy));
+        }
+    }
+    delete view;
+}
+
 QTEST_MAIN(tst_affectors);
 
 #include "tst_affectors.moc"
@@ -53,6 +53,8 @@ public:
 private slots:
     void test_basic();
     void test_basic_data();
+    void test_rate();
+    void test_rate_data();
 };
 
 tst_emission::tst_emission()
@@ -113,6 +115,48 @@ void tst_emission::test_basic()
     delete view;
 }
 
+void tst_emission::test_rate_data()
+{
+    QTest::addColumn<int> ("rate");
+    QTest::newRow("1000/s") << 1000;
+    QTest::newRow("10000/s") << 10000;
+    QTest::newRow("50000/s") << 50000;
+}
+
+void tst_emission::test_rate()
+{
+    QFETCH(int, rate);
+    QQuickView* view = createView(QCoreApplication::applicationDirPath() + "/data/rate.qml");
+    QQuickParticleSystem* system = view->rootObject()->findChild<QQuickParticleSystem*>("system");
+    QObject* emitter = view->rootObject()->findChild<QObject*>("emitter");
+    emitter->setProperty("emitRate", rate);
+    //Pretend we're running, but we manually advance the simulation
+    system->m_running = true;
+    system->m_animation = 0;
+    system->reset();
+
+    int curTime = 1;
+    while (curTime < 1000) {//Warm up until emission and expiry balance out
+        curTime += 16;
+        system->updateCurrentTime(curTime);
+    }
+
+    QBENCHMARK {
+        curTime += 16;
+        system->updateCurrentTime(curTime);
+    }
+
+    int stillAlive = 0;
+    foreach (QQuickParticleData *d, system->groupData[0]->data) {
+        if (d->t != -1 && d->stillAlive())
+            stillAlive++;
+    }
+    //At most 350ms worth of particles can be alive at once
+    QVERIFY(stillAlive > 0);
+    QVERIFY(stillAlive <= rate * 350 / 1000 + rate / 60 + 10);
+    delete view;
+}
+
 QTEST_MAIN(tst_emission);
 
 #include "tst_emission.moc"
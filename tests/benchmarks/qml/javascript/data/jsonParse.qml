@@ -0,0 +1,24 @@
+// Benchmarks JSON.parse of an array of records with repeating keys, the
+// typical shape of a REST payload.
+
+import QtQuick 2.0
+
+QtObject {
+    id: root
+
+    property string text
+
+    Component.onCompleted: {
+        var records = []
+        for (var ii = 0; ii < 20000; ++ii) {
+            records.push({ "id": ii, "name": "record " + ii, "value": ii * 0.5,
+                           "enabled": ii % 2 == 0, "tags": ["a", "b", "c"],
+                           "description": "A somewhat longer string value, to have some text to scan" })
+        }
+        text = JSON.stringify(records)
+    }
+
+    function runtest() {
+        JSON.parse(text)
+    }
+}
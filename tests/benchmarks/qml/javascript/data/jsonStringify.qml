@@ -0,0 +1,24 @@
+// Benchmarks JSON.stringify of an array of records sharing the same shape,
+// the typical shape of a REST payload.
+
+import QtQuick 2.0
+
+QtObject {
+    id: root
+
+    property var records
+
+    Component.onCompleted: {
+        var list = []
+        for (var ii = 0; ii < 20000; ++ii) {
+            list.push({ "id": ii, "name": "record " + ii, "value": ii * 0.5,
+                        "enabled": ii % 2 == 0, "tags": ["a", "b", "c"],
+                        "description": "A somewhat longer string value, with a \"quote\" to escape" })
+        }
+        records = list
+    }
+
+    function runtest() {
+        JSON.stringify(records)
+    }
+}
@@ -11,6 +11,7 @@ SUBDIRS += \
            qqmlmetaproperty \
            script \
            qmltime \
+           qquickworkerscript \
            js \
            qquickwindow
 
@@ -42,7 +42,10 @@
 #include <qtest.h>
 #include <QQmlEngine>
 #include <QQmlComponent>
+#include <QTemporaryDir>
+#include <QPainter>
 #include <private/qquickimage_p.h>
+#include <private/qquickpixmapcache_p.h>
 
 class tst_qmlgraphicsimage : public QObject
 {
@@ -51,14 +54,40 @@ public:
     tst_qmlgraphicsimage() {}
 
 private slots:
+    void initTestCase();
     void qmlgraphicsimage();
     void qmlgraphicsimage_file();
     void qmlgraphicsimage_url();
+    void largeImage_data();
+    void largeImage();
 
 private:
     QQmlEngine engine;
+    QTemporaryDir tempDir;
+    QUrl largeImageUrl;
 };
 
+void tst_qmlgraphicsimage::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+
+    // A photo sized image with some detail, so the decoder has real work to do
+    QImage large(6000, 4000, QImage::Format_RGB32);
+    QPainter p(&large);
+    QLinearGradient gradient(0, 0, large.width(), large.height());
+    gradient.setColorAt(0, Qt::darkBlue);
+    gradient.setColorAt(0.5, Qt::yellow);
+    gradient.setColorAt(1, Qt::darkRed);
+    p.fillRect(large.rect(), gradient);
+    for (int i = 0; i < large.width(); i += 40)
+        p.drawLine(i, 0, large.width() - i, large.height());
+    p.end();
+
+    const QString fileName = tempDir.path() + QLatin1String("/large.jpg");
+    QVERIFY(large.save(fileName, "JPEG"));
+    largeImageUrl = QUrl::fromLocalFile(fileName);
+}
+
 void tst_qmlgraphicsimage::qmlgraphicsimage()
 {
     int x = 0;
@@ -103,6 +132,30 @@ void tst_qmlgraphicsimage::qmlgraphicsimage_url()
     }
 }
 
+void tst_qmlgraphicsimage::largeImage_data()
+{
+    QTest::addColumn<QSize>("requestSize");
+    QTest::addColumn<QRect>("requestRegion");
+
+    QTest::newRow("full") << QSize() << QRect();
+    QTest::newRow("scaled 200x150") << QSize(200, 150) << QRect();
+    QTest::newRow("scaled 1500x1000") << QSize(1500, 1000) << QRect();
+    QTest::newRow("region 512x512") << QSize() << QRect(2000, 2000, 512, 512);
+    QTest::newRow("scaled region") << QSize(1500, 1000) << QRect(500, 500, 256, 256);
+}
+
+void tst_qmlgraphicsimage::largeImage()
+{
+    QFETCH(QSize, requestSize);
+    QFETCH(QRect, requestRegion);
+
+    QBENCHMARK {
+        QQuickPixmap pixmap;
+        pixmap.load(&engine, largeImageUrl, requestRegion, requestSize, QQuickPixmap::Options());
+        QVERIFY(pixmap.isReady());
+    }
+}
+
 QTEST_MAIN(tst_qmlgraphicsimage)
 
 #include "tst_qqmlimage.moc"
@@ -0,0 +1,41 @@
+import QtQuick 2.0
+
+WorkerScript {
+    id: worker
+
+    property var payload
+    property int received: 0
+
+    source: "echo.js"
+
+    function createPayload(type, size) {
+        var i
+        var result
+        if (type === "string") {
+            result = new Array(size + 1).join("x")
+        } else if (type === "int") {
+            result = []
+            for (i = 0; i < size; ++i)
+                result.push(i)
+        } else if (type === "real") {
+            result = []
+            for (i = 0; i < size; ++i)
+                result.push(i + 0.5)
+        } else if (type === "strings") {
+            result = []
+            for (i = 0; i < size; ++i)
+                result.push("line " + i + " of a parsed log file, long enough to be worth sharing")
+        } else if (type === "objects") {
+            result = []
+            for (i = 0; i < size; ++i)
+                result.push({ "index": i, "value": i * 0.25, "name": "item" + i })
+        }
+        payload = result
+    }
+
+    function send() {
+        worker.sendMessage(payload)
+    }
+
+    onMessage: ++received
+}
@@ -0,0 +1,12 @@
+CONFIG += testcase
+TEMPLATE = app
+TARGET = tst_qquickworkerscript
+QT += qml testlib
+macx:CONFIG -= app_bundle
+CONFIG += release
+
+SOURCES += tst_qquickworkerscript.cpp
+
+DEFINES += SRCDIR=\\\"$$PWD\\\"
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
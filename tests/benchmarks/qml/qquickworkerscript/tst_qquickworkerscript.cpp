@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QQmlEngine>
+#include <QQmlComponent>
+
+class tst_QQuickWorkerScript : public QObject
+{
+    Q_OBJECT
+public:
+    tst_QQuickWorkerScript() {}
+
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+
+private:
+    QQmlEngine engine;
+};
+
+void tst_QQuickWorkerScript::roundTrip_data()
+{
+    QTest::addColumn<QString>("type");
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("string 1M") << "string" << 1024 * 1024;
+    QTest::newRow("int array 100k") << "int" << 100000;
+    QTest::newRow("real array 100k") << "real" << 100000;
+    QTest::newRow("string array 10k") << "strings" << 10000;
+    QTest::newRow("object array 10k") << "objects" << 10000;
+}
+
+// Sends the payload to a worker which echoes it back, so every iteration
+// serializes and deserializes it twice.
+void tst_QQuickWorkerScript::roundTrip()
+{
+    QFETCH(QString, type);
+    QFETCH(int, size);
+
+    QQmlComponent component(&engine, QUrl::fromLocalFile(SRCDIR "/data/worker.qml"));
+    QObject *worker = component.create();
+    QVERIFY2(worker, qPrintable(component.errorString()));
+
+    QVERIFY(QMetaObject::invokeMethod(worker, "createPayload", Q_ARG(QVariant, type), Q_ARG(QVariant, size)));
+
+    int expected = 0;
+    QBENCHMARK {
+        QVERIFY(QMetaObject::invokeMethod(worker, "send"));
+        ++expected;
+        QTRY_COMPARE(worker->property("received").toInt(), expected);
+    }
+
+    delete worker;
+}
+
+QTEST_MAIN(tst_QQuickWorkerScript)
+
+#include "tst_qquickworkerscript.moc"
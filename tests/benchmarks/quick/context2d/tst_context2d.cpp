@@ -0,0 +1,195 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+
+#include <qtest.h>
+#include <QtTest/QtTest>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+#include <QtCore/QThreadPool>
+#include <private/qquickcontext2dcommandbuffer_p.h>
+
+class tst_context2d : public QObject
+{
+    Q_OBJECT
+public:
+    tst_context2d();
+
+private slots:
+    void test_record();
+    void test_record_data();
+    void test_replay();
+    void test_replay_data();
+    void test_replayBands();
+    void test_replayBands_data();
+
+private:
+    void record(QQuickContext2DCommandBuffer *buffer, int count);
+};
+
+tst_context2d::tst_context2d()
+{
+}
+
+// Roughly what a live chart issues per frame: style changes, rectangles
+// and a path for every data point.
+void tst_context2d::record(QQuickContext2DCommandBuffer *buffer, int count)
+{
+    QPainterPath path;
+    path.moveTo(0, 0);
+    path.lineTo(10, 10);
+
+    for (int i = 0; i < count; i += 4) {
+        qreal x = i % 500;
+        qreal y = (i / 500) % 500;
+        buffer->setFillStyle(QColor::fromRgb(i & 0xff, 0x80, 0x40));
+        buffer->fillRect(QRectF(x, y, 4, 4));
+        buffer->strokeRect(QRectF(x, y, 6, 6));
+        buffer->stroke(path);
+    }
+}
+
+void tst_context2d::test_record_data()
+{
+    QTest::addColumn<int> ("count");
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("50000") << 50000;
+}
+
+void tst_context2d::test_record()
+{
+    QFETCH(int, count);
+
+    QBENCHMARK {
+        QQuickContext2DCommandBuffer *buffer = QQuickContext2DCommandBuffer::create();
+        record(buffer, count);
+        QQuickContext2DCommandBuffer::release(buffer);
+    }
+}
+
+void tst_context2d::test_replay_data()
+{
+    test_record_data();
+}
+
+void tst_context2d::test_replay()
+{
+    QFETCH(int, count);
+
+    QQuickContext2DCommandBuffer *buffer = QQuickContext2DCommandBuffer::create();
+    record(buffer, count);
+    QCOMPARE(buffer->size(), count);
+
+    QImage image(512, 512, QImage::Format_ARGB32_Premultiplied);
+    QBENCHMARK {
+        QQuickContext2D::State state;
+        QPainter p(&image);
+        buffer->replay(&p, state);
+    }
+
+    QQuickContext2DCommandBuffer::release(buffer);
+}
+
+class BandRunnable : public QRunnable
+{
+public:
+    BandRunnable(const QQuickContext2DCommandBuffer *buffer, QImage *image, int top, int bottom)
+        : buffer(buffer)
+        , band(image->bits() + top * image->bytesPerLine(), image->width(), bottom - top,
+               image->bytesPerLine(), image->format())
+        , top(top)
+    {
+    }
+
+    void run()
+    {
+        QQuickContext2D::State state;
+        QPainter p(&band);
+        p.translate(0, -top);
+        buffer->replay(&p, state);
+    }
+
+private:
+    const QQuickContext2DCommandBuffer *buffer;
+    QImage band;
+    int top;
+};
+
+void tst_context2d::test_replayBands_data()
+{
+    QTest::addColumn<int> ("bands");
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    QTest::newRow("4") << 4;
+    QTest::newRow("8") << 8;
+}
+
+// A 4K canvas split into bands of rows, each replaying the whole buffer on
+// its own thread the way the Image render target does.
+void tst_context2d::test_replayBands()
+{
+    QFETCH(int, bands);
+
+    QQuickContext2DCommandBuffer *buffer = QQuickContext2DCommandBuffer::create();
+    QPainterPath path;
+    for (int i = 0; i < 2000; ++i) {
+        path = QPainterPath();
+        path.moveTo((i * 37) % 3840, (i * 53) % 2160);
+        path.lineTo((i * 37) % 3840 + 200, (i * 53) % 2160 + 120);
+        buffer->setFillStyle(QColor::fromRgb(i & 0xff, 0x80, 0x40));
+        buffer->fillRect(QRectF((i * 37) % 3840, (i * 53) % 2160, 120, 80));
+        buffer->stroke(path);
+    }
+
+    QImage image(3840, 2160, QImage::Format_ARGB32_Premultiplied);
+    QThreadPool pool;
+    pool.setMaxThreadCount(bands);
+    QBENCHMARK {
+        for (int i = 0; i < bands; ++i)
+            pool.start(new BandRunnable(buffer, &image, image.height() * i / bands, image.height() * (i + 1) / bands));
+        pool.waitForDone();
+    }
+
+    QQuickContext2DCommandBuffer::release(buffer);
+}
+
+QTEST_MAIN(tst_context2d);
+
+#include "tst_context2d.moc"